@@ -5,6 +5,7 @@
 #define _SILENCE_CXX17_OLD_ALLOCATOR_MEMBERS_DEPRECATION_WARNING
 
 #include <boost/unordered_map.hpp>
+#include <boost/unordered/string_hash.hpp>
 #include <boost/multi_index_container.hpp>
 #include <boost/multi_index/hashed_index.hpp>
 #include <boost/multi_index/member.hpp>
@@ -260,6 +261,9 @@ template<class K, class V> using std_unordered_map_fnv1a =
 template<class K, class V> using boost_unordered_map_fnv1a =
     boost::unordered_map<K, V, fnv1a_hash>;
 
+template<class K, class V> using boost_unordered_map_string_hash =
+    boost::unordered_map<K, V, boost::unordered::string_hash>;
+
 template<class K, class V> using multi_index_map_fnv1a = multi_index_container<
   pair<K, V>,
   indexed_by<
@@ -286,6 +290,7 @@ int main()
     test<std_unordered_map_fnv1a>( "std::unordered_map, FNV-1a" );
     test<boost::unordered_map>( "boost::unordered_map" );
     test<boost_unordered_map_fnv1a>( "boost::unordered_map, FNV-1a" );
+    test<boost_unordered_map_string_hash>( "boost::unordered_map, string_hash" );
     test<multi_index_map>( "multi_index_map" );
     test<multi_index_map_fnv1a>( "multi_index_map, FNV-1a" );
 
@@ -5,6 +5,7 @@
 #define _SILENCE_CXX17_OLD_ALLOCATOR_MEMBERS_DEPRECATION_WARNING
 
 #include <boost/unordered_map.hpp>
+#include <boost/unordered/integer_flat_map.hpp>
 #include <boost/multi_index_container.hpp>
 #include <boost/multi_index/hashed_index.hpp>
 #include <boost/multi_index/member.hpp>
@@ -233,6 +234,7 @@ int main()
     test<std::unordered_map>( "std::unordered_map" );
     test<boost::unordered_map>( "boost::unordered_map" );
     test<multi_index_map>( "multi_index_map" );
+    test<boost::integer_flat_map>( "boost::integer_flat_map" );
 
     // test<std::map>( "std::map" );
 
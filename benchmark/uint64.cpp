@@ -5,6 +5,7 @@
 #define _SILENCE_CXX17_OLD_ALLOCATOR_MEMBERS_DEPRECATION_WARNING
 
 #include <boost/unordered_map.hpp>
+#include <boost/unordered/integer_flat_map.hpp>
 #include <boost/multi_index_container.hpp>
 #include <boost/multi_index/hashed_index.hpp>
 #include <boost/multi_index/member.hpp>
@@ -137,6 +138,17 @@ template<class Map> void test_lookup( Map& map, std::chrono::steady_clock::time_
 
 template<class Map> void test_iteration( Map& map, std::chrono::steady_clock::time_point & t1 )
 {
+    {
+        std::uint64_t s = 0;
+
+        for( auto const& x: map )
+        {
+            s += x.second;
+        }
+
+        print_time( t1, "Iterate", s, map.size() );
+    }
+
     auto it = map.begin();
 
     while( it != map.end() )
@@ -226,6 +238,22 @@ template<class K, class V> using multi_index_map = multi_index_container<
   >
 >;
 
+// an identity hash that claims to be avalanching, so that the sequential and
+// shifted keys collide, defended by reseeding
+
+struct identity_hash
+{
+    using is_avalanching = void;
+    using collision_policy = boost::unordered::adaptive_collision_defence;
+
+    std::size_t operator()( std::uint64_t x ) const noexcept
+    {
+        return static_cast<std::size_t>( x );
+    }
+};
+
+template<class K, class V> using adaptive_unordered_map = boost::unordered_map<K, V, identity_hash>;
+
 int main()
 {
     init_indices();
@@ -233,6 +261,8 @@ int main()
     test<std::unordered_map>( "std::unordered_map" );
     test<boost::unordered_map>( "boost::unordered_map" );
     test<multi_index_map>( "multi_index_map" );
+    test<boost::integer_flat_map>( "boost::integer_flat_map" );
+    test<adaptive_unordered_map>( "adaptive_unordered_map" );
 
     // test<std::map>( "std::map" );
 
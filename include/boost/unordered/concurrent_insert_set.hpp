@@ -0,0 +1,151 @@
+
+// Copyright 2022 Christian Mazakas.
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_UNORDERED_CONCURRENT_INSERT_SET_HPP_INCLUDED
+#define BOOST_UNORDERED_CONCURRENT_INSERT_SET_HPP_INCLUDED
+
+#include <boost/config.hpp>
+#if defined(BOOST_HAS_PRAGMA_ONCE)
+#pragma once
+#endif
+
+#include <boost/functional/hash.hpp>
+#include <boost/unordered/detail/concurrent_insert_table.hpp>
+
+#if BOOST_UNORDERED_CONCURRENT
+
+#include <functional>
+#include <memory>
+#include <utility>
+
+namespace boost {
+  namespace unordered {
+
+    // A set that elements can be inserted into from any number of threads
+    // at once, without locking, for example to remove duplicates from the
+    // output of several threads. Elements can't be erased, other than by
+    // clearing the whole set, which like iterating over the elements must
+    // only be done when no other thread is using it.
+
+    template <class T, class H = boost::hash<T>, class P = std::equal_to<T>,
+      class A = std::allocator<T> >
+    class concurrent_insert_set
+    {
+      typedef boost::unordered::detail::concurrent_insert_set_types<A, T, H, P>
+        types;
+      typedef boost::unordered::detail::concurrent_insert_table<types> table;
+
+      table table_;
+
+    public:
+      typedef T key_type;
+      typedef T value_type;
+      typedef H hasher;
+      typedef P key_equal;
+      typedef A allocator_type;
+      typedef std::size_t size_type;
+
+      // construct/destroy
+
+      concurrent_insert_set()
+          : table_(boost::unordered::detail::default_bucket_count, hasher(),
+              key_equal(), allocator_type())
+      {
+      }
+
+      explicit concurrent_insert_set(size_type n, hasher const& hf = hasher(),
+        key_equal const& eq = key_equal(),
+        allocator_type const& a = allocator_type())
+          : table_(n, hf, eq, a)
+      {
+      }
+
+      allocator_type get_allocator() const
+      {
+        return allocator_type(table_.get_allocator());
+      }
+
+      // size
+
+      bool empty() const BOOST_NOEXCEPT { return size() == 0; }
+
+      size_type size() const BOOST_NOEXCEPT { return table_.size(); }
+
+      // modifiers, thread safe
+
+      bool insert(value_type const& x)
+      {
+        return table_.try_emplace_unique(x, x);
+      }
+
+      bool insert(value_type&& x)
+      {
+        return table_.try_emplace_unique(x, std::move(x));
+      }
+
+      template <class... Args> bool emplace(Args&&... args)
+      {
+        return table_.emplace_unique(std::forward<Args>(args)...);
+      }
+
+      // lookup, thread safe
+
+      bool contains(key_type const& k) const { return table_.find(k) != 0; }
+
+      size_type count(key_type const& k) const { return contains(k) ? 1 : 0; }
+
+      // Calls 'f' with the element equivalent to 'k', which stays at the
+      // same address until the set is cleared or destroyed.
+      template <class F> bool visit(key_type const& k, F f) const
+      {
+        typename table::node const* n = table_.find(k);
+        if (n) {
+          f(n->value());
+        }
+        return n != 0;
+      }
+
+      // not thread safe
+
+      template <class F> void visit_all(F f) const { table_.visit_all(f); }
+
+      void clear() { table_.clear(); }
+
+      // observers
+
+      hasher hash_function() const { return table_.hash_function(); }
+
+      key_equal key_eq() const { return table_.key_eq(); }
+
+      // bucket interface
+
+      size_type bucket_count() const { return table_.bucket_count(); }
+
+      // hash policy
+
+      float load_factor() const
+      {
+        return static_cast<float>(size()) /
+               static_cast<float>(bucket_count());
+      }
+
+      float max_load_factor() const { return table_.max_load_factor(); }
+
+      // Not thread safe.
+      void max_load_factor(float z) { table_.max_load_factor(z); }
+
+      // Only ever increases the number of buckets. Thread safe.
+      void rehash(size_type n) { table_.rehash(n); }
+
+      void reserve(size_type n) { table_.reserve(n); }
+    };
+  }
+
+  using boost::unordered::concurrent_insert_set;
+}
+
+#endif
+
+#endif
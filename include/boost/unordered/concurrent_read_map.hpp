@@ -0,0 +1,732 @@
+
+// Copyright 2022 Christian Mazakas.
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_UNORDERED_CONCURRENT_READ_MAP_HPP_INCLUDED
+#define BOOST_UNORDERED_CONCURRENT_READ_MAP_HPP_INCLUDED
+
+#include <boost/config.hpp>
+#if defined(BOOST_HAS_PRAGMA_ONCE)
+#pragma once
+#endif
+
+#include <boost/functional/hash.hpp>
+#include <boost/unordered/detail/epoch.hpp>
+#include <boost/unordered/detail/implementation.hpp>
+
+#if BOOST_UNORDERED_CONCURRENT
+
+#include <boost/static_assert.hpp>
+#include <boost/type_traits/is_pointer.hpp>
+#include <atomic>
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace boost {
+  namespace unordered {
+    namespace detail {
+
+      // The links are atomic, as they can change while readers are
+      // following them.
+
+      template <typename ValueType> struct read_map_node
+      {
+        std::atomic<read_map_node*> next_;
+        std::size_t hash_;
+        boost::unordered::detail::value_base<ValueType> value_base_;
+
+        read_map_node() : next_(0), hash_(0), value_base_() {}
+
+        ValueType* value_ptr() { return value_base_.value_ptr(); }
+        ValueType& value() { return value_base_.value(); }
+        ValueType const& value() const { return value_base_.value(); }
+
+      private:
+        read_map_node(read_map_node const&);
+        read_map_node& operator=(read_map_node const&);
+      };
+
+      // Each bucket points to its own chain of nodes, ending in null. The
+      // number of buckets is a power of 2, and the bucket is picked from the
+      // high bits of the hash value.
+
+      template <typename Node> struct read_map_buckets
+      {
+        std::atomic<Node*>* buckets_;
+        std::size_t bucket_count_;
+        int shift_;
+
+        std::size_t position(std::size_t hash) const { return hash >> shift_; }
+      };
+    }
+
+    // An unordered map for workloads dominated by lookups. Readers don't
+    // take any locks, and only write to memory private to their thread, so
+    // they never wait for writers or each other. Writers are serialised by
+    // a mutex. Nodes are never modified once they're visible to readers:
+    // erased nodes and replaced values are reclaimed after every reader
+    // that could have seen them is done, and the bucket array grows by
+    // splitting the existing chains in place, so that a lookup is always a
+    // plain walk along a chain.
+
+    template <class K, class T, class H = boost::hash<K>,
+      class P = std::equal_to<K>,
+      class A = std::allocator<std::pair<const K, T> > >
+    class concurrent_read_map
+    {
+      concurrent_read_map(concurrent_read_map const&);
+      concurrent_read_map& operator=(concurrent_read_map const&);
+
+    public:
+      typedef K key_type;
+      typedef T mapped_type;
+      typedef std::pair<const K, T> value_type;
+      typedef H hasher;
+      typedef P key_equal;
+      typedef A allocator_type;
+      typedef std::size_t size_type;
+
+    private:
+      typedef boost::unordered::detail::read_map_node<value_type> node;
+      typedef boost::unordered::detail::read_map_buckets<node> bucket_array;
+      typedef std::atomic<node*> bucket;
+
+      struct retired_node
+      {
+        node* node_;
+        std::size_t epoch_;
+      };
+
+      typedef typename boost::unordered::detail::rebind_wrap<A, node>::type
+        node_allocator;
+      typedef typename boost::unordered::detail::rebind_wrap<A, bucket>::type
+        bucket_allocator;
+      typedef typename boost::unordered::detail::rebind_wrap<A,
+        bucket_array>::type array_allocator;
+      typedef typename boost::unordered::detail::rebind_wrap<A,
+        retired_node>::type retired_allocator;
+      typedef boost::unordered::detail::allocator_traits<node_allocator>
+        node_allocator_traits;
+      typedef boost::unordered::detail::allocator_traits<bucket_allocator>
+        bucket_allocator_traits;
+      typedef boost::unordered::detail::allocator_traits<array_allocator>
+        array_allocator_traits;
+      typedef typename boost::unordered::detail::pick_policy<K, H>::type
+        policy;
+      typedef boost::unordered::detail::epoch::read_guard read_guard;
+
+      BOOST_STATIC_ASSERT_MSG(
+        boost::is_pointer<typename node_allocator_traits::pointer>::value,
+        "concurrent_read_map requires an allocator that uses raw pointers");
+
+      hasher hf_;
+      key_equal eq_;
+      node_allocator node_alloc_;
+      std::atomic<bucket_array*> buckets_;
+      std::atomic<std::size_t> size_;
+      float mlf_;
+      std::size_t max_load_;
+      mutable std::mutex mutex_;
+      std::vector<retired_node, retired_allocator> retired_;
+
+    public:
+      // construct/destroy
+
+      concurrent_read_map()
+          : hf_(), eq_(), node_alloc_(), buckets_(0), size_(0), mlf_(1.0f),
+            max_load_(0), mutex_(), retired_(retired_allocator(node_alloc_))
+      {
+        init(boost::unordered::detail::default_bucket_count);
+      }
+
+      explicit concurrent_read_map(size_type n, hasher const& hf = hasher(),
+        key_equal const& eq = key_equal(),
+        allocator_type const& a = allocator_type())
+          : hf_(hf), eq_(eq), node_alloc_(a), buckets_(0), size_(0),
+            mlf_(1.0f), max_load_(0), mutex_(),
+            retired_(retired_allocator(node_alloc_))
+      {
+        init(n);
+      }
+
+      // There mustn't be any other threads using the container when it's
+      // destroyed.
+      ~concurrent_read_map()
+      {
+        bucket_array* b = buckets_.load(std::memory_order_relaxed);
+        for (std::size_t i = 0; i < b->bucket_count_; ++i) {
+          node* n = b->buckets_[i].load(std::memory_order_relaxed);
+          while (n) {
+            node* next = n->next_.load(std::memory_order_relaxed);
+            destroy_node(n);
+            n = next;
+          }
+        }
+        destroy_buckets(b);
+
+        for (std::size_t i = 0; i < retired_.size(); ++i) {
+          destroy_node(retired_[i].node_);
+        }
+      }
+
+      allocator_type get_allocator() const
+      {
+        return allocator_type(node_alloc_);
+      }
+
+      // size and capacity
+
+      bool empty() const BOOST_NOEXCEPT { return size() == 0; }
+
+      size_type size() const BOOST_NOEXCEPT
+      {
+        return size_.load(std::memory_order_relaxed);
+      }
+
+      // lookup, never blocks
+
+      template <class F> bool visit(key_type const& k, F f) const
+      {
+        std::size_t key_hash = hash(k);
+        read_guard guard;
+        node const* n = find_node(k, key_hash);
+        if (n) {
+          f(n->value());
+        }
+        return n != 0;
+      }
+
+      bool contains(key_type const& k) const
+      {
+        std::size_t key_hash = hash(k);
+        read_guard guard;
+        return find_node(k, key_hash) != 0;
+      }
+
+      size_type count(key_type const& k) const { return contains(k) ? 1 : 0; }
+
+      template <class F> void visit_all(F f) const
+      {
+        read_guard guard;
+        bucket_array const* b = buckets_.load(std::memory_order_acquire);
+        for (std::size_t i = 0; i < b->bucket_count_; ++i) {
+          for (node const* n = b->buckets_[i].load(std::memory_order_acquire);
+               n; n = n->next_.load(std::memory_order_acquire)) {
+            // While the buckets are being split, a chain can also contain
+            // nodes from its neighbour.
+            if (b->position(n->hash_) == i) {
+              f(n->value());
+            }
+          }
+        }
+      }
+
+      // modifiers, serialised with each other
+
+      template <class... Args> bool emplace(Args&&... args)
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        node* n = create_node(std::forward<Args>(args)...);
+        BOOST_TRY
+        {
+          n->hash_ = hash(n->value().first);
+          bucket* prev;
+          if (find_for_write(n->value().first, n->hash_, prev)) {
+            destroy_node(n);
+            return false;
+          }
+          reserve_for_insert(size() + 1);
+        }
+        BOOST_CATCH(...)
+        {
+          destroy_node(n);
+          BOOST_RETHROW
+        }
+        BOOST_CATCH_END
+        link_node(n);
+        return true;
+      }
+
+      bool insert(value_type const& x) { return emplace(x); }
+
+      bool insert(value_type&& x) { return emplace(std::move(x)); }
+
+      template <class... Args>
+      bool try_emplace(key_type const& k, Args&&... args)
+      {
+        return try_emplace_impl(k, std::forward<Args>(args)...);
+      }
+
+      template <class... Args> bool try_emplace(key_type&& k, Args&&... args)
+      {
+        return try_emplace_impl(std::move(k), std::forward<Args>(args)...);
+      }
+
+      // An existing element is replaced by a new node, rather than
+      // assigning to it, as readers might be looking at it.
+      template <class M> bool insert_or_assign(key_type const& k, M&& obj)
+      {
+        return insert_or_assign_impl(k, std::forward<M>(obj));
+      }
+
+      template <class M> bool insert_or_assign(key_type&& k, M&& obj)
+      {
+        return insert_or_assign_impl(std::move(k), std::forward<M>(obj));
+      }
+
+      size_type erase(key_type const& k)
+      {
+        std::size_t key_hash = hash(k);
+        std::lock_guard<std::mutex> lock(mutex_);
+        bucket* prev;
+        node* n = find_for_write(k, key_hash, prev);
+        if (!n) {
+          return 0;
+        }
+
+        reserve_retired();
+        prev->store(
+          n->next_.load(std::memory_order_relaxed), std::memory_order_release);
+        size_.store(size() - 1, std::memory_order_relaxed);
+        retire(n);
+        return 1;
+      }
+
+      // Waits for the current readers to finish before destroying the
+      // elements.
+      void clear()
+      {
+        BOOST_ASSERT(!boost::unordered::detail::epoch::reading());
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        // Unlink every chain, joining them together so that they can be
+        // destroyed later.
+        bucket_array* b = buckets_.load(std::memory_order_relaxed);
+        node* nodes = 0;
+        for (std::size_t i = 0; i < b->bucket_count_; ++i) {
+          node* n = b->buckets_[i].load(std::memory_order_relaxed);
+          if (!n) {
+            continue;
+          }
+
+          b->buckets_[i].store(0, std::memory_order_release);
+          node* last = n;
+          for (node* next = n->next_.load(std::memory_order_relaxed); next;
+               next = next->next_.load(std::memory_order_relaxed)) {
+            last = next;
+          }
+          last->next_.store(nodes, std::memory_order_release);
+          nodes = n;
+        }
+        size_.store(0, std::memory_order_relaxed);
+
+        boost::unordered::detail::epoch::global_domain().synchronize();
+        while (nodes) {
+          node* next = nodes->next_.load(std::memory_order_relaxed);
+          destroy_node(nodes);
+          nodes = next;
+        }
+        reclaim();
+      }
+
+      // observers
+
+      hasher hash_function() const { return hf_; }
+
+      key_equal key_eq() const { return eq_; }
+
+      // bucket interface
+
+      size_type bucket_count() const
+      {
+        read_guard guard;
+        return buckets_.load(std::memory_order_acquire)->bucket_count_;
+      }
+
+      // hash policy
+
+      float load_factor() const
+      {
+        return static_cast<float>(size()) /
+               static_cast<float>(bucket_count());
+      }
+
+      float max_load_factor() const
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return mlf_;
+      }
+
+      void max_load_factor(float z)
+      {
+        BOOST_ASSERT(z > 0);
+        std::lock_guard<std::mutex> lock(mutex_);
+        mlf_ = (std::max)(z, boost::unordered::detail::minimum_max_load_factor);
+        recalculate_max_load();
+      }
+
+      // Only ever increases the number of buckets.
+      void rehash(size_type n)
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        rehash_impl((std::max)(n, min_buckets_for_size(size())));
+      }
+
+      void reserve(size_type n)
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        rehash_impl(min_buckets_for_size(n));
+      }
+
+    private:
+      void init(std::size_t n)
+      {
+        buckets_.store(
+          create_buckets(new_bucket_count(n)), std::memory_order_relaxed);
+        recalculate_max_load();
+      }
+
+      std::size_t hash(key_type const& k) const
+      {
+        return policy::apply_hash(hf_, k);
+      }
+
+      // Called by readers, inside a read_guard.
+      node const* find_node(key_type const& k, std::size_t key_hash) const
+      {
+        bucket_array const* b = buckets_.load(std::memory_order_acquire);
+        for (node const* n = b->buckets_[b->position(key_hash)].load(
+               std::memory_order_acquire);
+             n; n = n->next_.load(std::memory_order_acquire)) {
+          if (n->hash_ == key_hash && eq_(k, n->value().first)) {
+            return n;
+          }
+        }
+        return 0;
+      }
+
+      // Called by writers, with the mutex locked. Sets 'prev' to the link
+      // to the node that's found.
+      node* find_for_write(
+        key_type const& k, std::size_t key_hash, bucket*& prev)
+      {
+        bucket_array* b = buckets_.load(std::memory_order_relaxed);
+        prev = b->buckets_ + b->position(key_hash);
+        for (node* n = prev->load(std::memory_order_relaxed); n;
+             prev = &n->next_, n = prev->load(std::memory_order_relaxed)) {
+          if (n->hash_ == key_hash && eq_(k, n->value().first)) {
+            return n;
+          }
+        }
+        return 0;
+      }
+
+      template <class Key, class... Args>
+      bool try_emplace_impl(Key&& k, Args&&... args)
+      {
+        std::size_t key_hash = hash(k);
+        std::lock_guard<std::mutex> lock(mutex_);
+        bucket* prev;
+        if (find_for_write(k, key_hash, prev)) {
+          return false;
+        }
+
+        reserve_for_insert(size() + 1);
+        node* n = create_node(std::piecewise_construct,
+          std::forward_as_tuple(std::forward<Key>(k)),
+          std::forward_as_tuple(std::forward<Args>(args)...));
+        n->hash_ = key_hash;
+        link_node(n);
+        return true;
+      }
+
+      template <class Key, class M> bool insert_or_assign_impl(Key&& k, M&& obj)
+      {
+        std::size_t key_hash = hash(k);
+        std::lock_guard<std::mutex> lock(mutex_);
+        bucket* prev;
+        node* old = find_for_write(k, key_hash, prev);
+        if (old) {
+          reserve_retired();
+        } else {
+          reserve_for_insert(size() + 1);
+        }
+
+        node* n = create_node(std::piecewise_construct,
+          std::forward_as_tuple(std::forward<Key>(k)),
+          std::forward_as_tuple(std::forward<M>(obj)));
+        n->hash_ = key_hash;
+
+        if (!old) {
+          link_node(n);
+          return true;
+        }
+
+        n->next_.store(
+          old->next_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        prev->store(n, std::memory_order_release);
+        retire(old);
+        return false;
+      }
+
+      void link_node(node* n)
+      {
+        bucket_array* b = buckets_.load(std::memory_order_relaxed);
+        bucket& head = b->buckets_[b->position(n->hash_)];
+        n->next_.store(
+          head.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        head.store(n, std::memory_order_release);
+        size_.store(size() + 1, std::memory_order_relaxed);
+      }
+
+      ////////////////////////////////////////////////////////////////////////
+      // Nodes
+
+      template <class... Args> node* create_node(Args&&... args)
+      {
+        node* n = node_allocator_traits::allocate(node_alloc_, 1);
+        new ((void*)n) node();
+        BOOST_TRY
+        {
+          node_allocator_traits::construct(
+            node_alloc_, n->value_ptr(), std::forward<Args>(args)...);
+        }
+        BOOST_CATCH(...)
+        {
+          n->~node();
+          node_allocator_traits::deallocate(node_alloc_, n, 1);
+          BOOST_RETHROW
+        }
+        BOOST_CATCH_END
+        return n;
+      }
+
+      void destroy_node(node* n)
+      {
+        node_allocator_traits::destroy(node_alloc_, n->value_ptr());
+        n->~node();
+        node_allocator_traits::deallocate(node_alloc_, n, 1);
+      }
+
+      // Makes sure that there's room to retire a node, so that retire
+      // doesn't throw after the node has been unlinked.
+      void reserve_retired()
+      {
+        if (retired_.size() == retired_.capacity()) {
+          reclaim();
+          if (retired_.size() * 2 >= retired_.capacity()) {
+            retired_.reserve((std::max)(
+              retired_.capacity() * 2, static_cast<std::size_t>(64)));
+          }
+        }
+      }
+
+      void retire(node* n)
+      {
+        BOOST_ASSERT(retired_.size() < retired_.capacity());
+        retired_node r = {
+          n, boost::unordered::detail::epoch::global_domain().advance()};
+        retired_.push_back(r);
+      }
+
+      // Destroys the retired nodes that no reader can still see.
+      void reclaim()
+      {
+        std::size_t min_epoch =
+          boost::unordered::detail::epoch::global_domain().min_epoch();
+        typename std::vector<retired_node, retired_allocator>::iterator out =
+          retired_.begin();
+        for (typename std::vector<retired_node,
+               retired_allocator>::iterator it = retired_.begin();
+             it != retired_.end(); ++it) {
+          if (it->epoch_ < min_epoch) {
+            destroy_node(it->node_);
+          } else {
+            *out++ = *it;
+          }
+        }
+        retired_.erase(out, retired_.end());
+      }
+
+      ////////////////////////////////////////////////////////////////////////
+      // Buckets
+
+      static std::size_t new_bucket_count(std::size_t n)
+      {
+        std::size_t const max =
+          (std::numeric_limits<std::size_t>::max)() / 2 + 1;
+        std::size_t count = 2;
+        while (count < n && count < max) {
+          count *= 2;
+        }
+        return count;
+      }
+
+      std::size_t min_buckets_for_size(std::size_t size) const
+      {
+        using namespace std;
+
+        return new_bucket_count(boost::unordered::detail::double_to_size(
+          floor(static_cast<double>(size) / static_cast<double>(mlf_)) + 1));
+      }
+
+      void recalculate_max_load()
+      {
+        using namespace std;
+
+        max_load_ = boost::unordered::detail::double_to_size(
+          ceil(static_cast<double>(mlf_) *
+               static_cast<double>(
+                 buckets_.load(std::memory_order_relaxed)->bucket_count_)));
+      }
+
+      bucket_array* create_buckets(std::size_t count)
+      {
+        array_allocator array_alloc(node_alloc_);
+        bucket_allocator bucket_alloc(node_alloc_);
+
+        bucket_array* b = array_allocator_traits::allocate(array_alloc, 1);
+        BOOST_TRY
+        {
+          new ((void*)b) bucket_array();
+          b->buckets_ = bucket_allocator_traits::allocate(bucket_alloc, count);
+        }
+        BOOST_CATCH(...)
+        {
+          array_allocator_traits::deallocate(array_alloc, b, 1);
+          BOOST_RETHROW
+        }
+        BOOST_CATCH_END
+
+        for (std::size_t i = 0; i < count; ++i) {
+          new ((void*)(b->buckets_ + i)) bucket(0);
+        }
+        b->bucket_count_ = count;
+        b->shift_ = std::numeric_limits<std::size_t>::digits -
+                    (static_cast<int>(boost::core::bit_width(count)) - 1);
+        return b;
+      }
+
+      void destroy_buckets(bucket_array* b)
+      {
+        array_allocator array_alloc(node_alloc_);
+        bucket_allocator bucket_alloc(node_alloc_);
+
+        for (std::size_t i = 0; i < b->bucket_count_; ++i) {
+          b->buckets_[i].~bucket();
+        }
+        bucket_allocator_traits::deallocate(
+          bucket_alloc, b->buckets_, b->bucket_count_);
+        b->~bucket_array();
+        array_allocator_traits::deallocate(array_alloc, b, 1);
+      }
+
+      void reserve_for_insert(std::size_t size)
+      {
+        while (size > max_load_) {
+          double_buckets();
+        }
+      }
+
+      void rehash_impl(std::size_t n)
+      {
+        std::size_t count = new_bucket_count(n);
+        while (buckets_.load(std::memory_order_relaxed)->bucket_count_ <
+               count) {
+          double_buckets();
+        }
+      }
+
+      // Doubles the number of buckets without moving or copying any nodes.
+      // Each chain in the old array holds the nodes for two buckets in the
+      // new one, so the new buckets start off sharing it, pointing to the
+      // first node that belongs to them. That's enough for lookups to work,
+      // as they compare every node's key anyway. Once readers have moved to
+      // the new array, the shared chains are split apart a step at a time,
+      // waiting for the readers between steps so that none of them are
+      // left on a node when its link is changed to skip nodes they need.
+      void double_buckets()
+      {
+        BOOST_ASSERT(!boost::unordered::detail::epoch::reading());
+        boost::unordered::detail::epoch::domain& epochs =
+          boost::unordered::detail::epoch::global_domain();
+
+        bucket_array* old_b = buckets_.load(std::memory_order_relaxed);
+        std::size_t const old_count = old_b->bucket_count_;
+        if (old_count > (std::numeric_limits<std::size_t>::max)() / 2) {
+          boost::throw_exception(
+            std::length_error("concurrent_read_map: too many buckets"));
+        }
+        bucket_array* new_b = create_buckets(old_count * 2);
+
+        for (std::size_t i = 0; i < old_count; ++i) {
+          for (node* n = old_b->buckets_[i].load(std::memory_order_relaxed); n;
+               n = n->next_.load(std::memory_order_relaxed)) {
+            bucket& b = new_b->buckets_[new_b->position(n->hash_)];
+            if (!b.load(std::memory_order_relaxed)) {
+              b.store(n, std::memory_order_relaxed);
+            }
+          }
+        }
+
+        buckets_.store(new_b, std::memory_order_release);
+        recalculate_max_load();
+        epochs.synchronize();
+
+        // Nothing reads the old array any more, so it's reused to hold the
+        // position in each chain that's still to be split.
+        bucket* positions = old_b->buckets_;
+        for (bool changed = true; changed;) {
+          changed = false;
+          for (std::size_t i = 0; i < old_count; ++i) {
+            node* n = positions[i].load(std::memory_order_relaxed);
+            if (!n) {
+              continue;
+            }
+
+            // Find the end of the run of nodes from the same new bucket, and
+            // the next node from that bucket after the run that follows it.
+            std::size_t const position = new_b->position(n->hash_);
+            node* next = n->next_.load(std::memory_order_relaxed);
+            while (next && new_b->position(next->hash_) == position) {
+              n = next;
+              next = n->next_.load(std::memory_order_relaxed);
+            }
+
+            positions[i].store(next, std::memory_order_relaxed);
+            if (!next) {
+              continue;
+            }
+
+            node* skip_to = next->next_.load(std::memory_order_relaxed);
+            while (skip_to && new_b->position(skip_to->hash_) != position) {
+              skip_to = skip_to->next_.load(std::memory_order_relaxed);
+            }
+            n->next_.store(skip_to, std::memory_order_release);
+            changed = true;
+          }
+
+          if (changed) {
+            epochs.synchronize();
+          }
+        }
+
+        destroy_buckets(old_b);
+        reclaim();
+      }
+    };
+  }
+
+  using boost::unordered::concurrent_read_map;
+}
+
+#endif
+
+#endif
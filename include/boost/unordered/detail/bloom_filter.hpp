@@ -0,0 +1,233 @@
+
+// Copyright 2022 Christian Mazakas.
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_UNORDERED_DETAIL_BLOOM_FILTER_HPP
+#define BOOST_UNORDERED_DETAIL_BLOOM_FILTER_HPP
+
+#include <boost/config.hpp>
+#if defined(BOOST_HAS_PRAGMA_ONCE)
+#pragma once
+#endif
+
+#include <boost/unordered/detail/implementation.hpp>
+
+#include <boost/core/swap.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/type_traits/is_same.hpp>
+#include <cmath>
+#include <cstring>
+
+namespace boost {
+  namespace unordered {
+    namespace detail {
+
+      ////////////////////////////////////////////////////////////////////////
+      // Blocked Bloom filter
+      //
+      // The bits are kept in blocks of one cache line, 8 words of 64 bits,
+      // and all the bits for a hash value are set in the one block that the
+      // hash value picks, spread over its words. So a lookup reads a single
+      // cache line, at the cost of a slightly higher false positive rate
+      // than an unblocked filter of the same size.
+      //
+      // Only hash values are added, and a bit can't be removed, as other
+      // values may share it, so the container rebuilds the filter from its
+      // elements when too many of them have been erased.
+
+      static const std::size_t bloom_block_words = 8;
+      static const std::size_t bloom_block_bits = 512;
+
+      template <typename A> struct blocked_bloom_filter
+      {
+        typedef boost::uint64_t word;
+        typedef typename boost::unordered::detail::rebind_wrap<A, word>::type
+          word_allocator;
+        typedef boost::unordered::detail::allocator_traits<word_allocator>
+          word_allocator_traits;
+
+        BOOST_STATIC_ASSERT((boost::is_same<
+          typename word_allocator_traits::pointer, word*>::value));
+
+        word_allocator alloc_;
+        word* data_;   // as allocated
+        word* blocks_; // data_, aligned to the size of a block
+        std::size_t block_count_;
+        std::size_t capacity_; // the number of elements it was sized for
+        std::size_t bits_per_element_;
+        unsigned hash_count_;
+
+        blocked_bloom_filter(
+          word_allocator const& a, std::size_t bits_per_element)
+            : alloc_(a), data_(), blocks_(), block_count_(0), capacity_(0),
+              bits_per_element_(0), hash_count_(0)
+        {
+          this->set_bits_per_element(bits_per_element);
+        }
+
+        blocked_bloom_filter(
+          blocked_bloom_filter const& x, word_allocator const& a)
+            : alloc_(a), data_(), blocks_(), block_count_(0), capacity_(0),
+              bits_per_element_(x.bits_per_element_),
+              hash_count_(x.hash_count_)
+        {
+          if (x.blocks_) {
+            this->create(x.capacity_, x.block_count_);
+            std::memcpy(blocks_, x.blocks_, this->bytes());
+          }
+        }
+
+        ~blocked_bloom_filter() { this->destroy(); }
+
+        bool enabled() const { return bits_per_element_ != 0; }
+
+        // The number of bits set for each value, which gives the lowest
+        // false positive rate for the number of bits per element.
+        void set_bits_per_element(std::size_t n)
+        {
+          bits_per_element_ = n;
+          double const k = std::floor(static_cast<double>(n) * 0.693 + 0.5);
+          hash_count_ = k < 1 ? 1u : k > 16 ? 16u : static_cast<unsigned>(k);
+        }
+
+        std::size_t bytes() const
+        {
+          return block_count_ * sizeof(word) * bloom_block_words;
+        }
+
+        // An estimate of the chance that a value which wasn't added is
+        // reported as present, once 'n' values have been added.
+        double false_positive_rate(std::size_t n) const
+        {
+          if (!blocks_) {
+            return 1.0;
+          }
+          double const bits =
+            static_cast<double>(block_count_) * bloom_block_bits;
+          double const k = hash_count_;
+          return std::pow(
+            1.0 - std::exp(-k * static_cast<double>(n) / bits), k);
+        }
+
+        // Replaces the bits with an empty filter sized for 'capacity'
+        // elements. Allocates first, so if that throws, nothing changes.
+        void reset(std::size_t capacity)
+        {
+          blocked_bloom_filter tmp(alloc_, 0);
+          tmp.bits_per_element_ = bits_per_element_;
+          tmp.hash_count_ = hash_count_;
+          if (bits_per_element_ && capacity) {
+            std::size_t const bits = capacity * bits_per_element_;
+            tmp.create(capacity,
+              (bits + bloom_block_bits - 1) / bloom_block_bits);
+          }
+          this->swap(tmp);
+        }
+
+        void clear() BOOST_NOEXCEPT
+        {
+          if (blocks_) {
+            std::memset(blocks_, 0, this->bytes());
+          }
+        }
+
+        void add(std::size_t hash) BOOST_NOEXCEPT
+        {
+          BOOST_ASSERT(blocks_);
+          word h = mix(hash);
+          word* b = this->block(h);
+          for (unsigned i = 0; i < hash_count_; ++i) {
+            h = next(h);
+            b[i % bloom_block_words] |= bit(h);
+          }
+        }
+
+        // False when 'hash' was never added, true when it might have been,
+        // or when the filter is disabled.
+        bool may_contain(std::size_t hash) const BOOST_NOEXCEPT
+        {
+          if (!blocks_) {
+            return true;
+          }
+          word h = mix(hash);
+          word const* b = this->block(h);
+          for (unsigned i = 0; i < hash_count_; ++i) {
+            h = next(h);
+            if (!(b[i % bloom_block_words] & bit(h))) {
+              return false;
+            }
+          }
+          return true;
+        }
+
+        void swap(blocked_bloom_filter& x) BOOST_NOEXCEPT
+        {
+          boost::swap(alloc_, x.alloc_);
+          boost::swap(data_, x.data_);
+          boost::swap(blocks_, x.blocks_);
+          boost::swap(block_count_, x.block_count_);
+          boost::swap(capacity_, x.capacity_);
+          boost::swap(bits_per_element_, x.bits_per_element_);
+          boost::swap(hash_count_, x.hash_count_);
+        }
+
+      private:
+        blocked_bloom_filter(blocked_bloom_filter const&);
+        blocked_bloom_filter& operator=(blocked_bloom_filter const&);
+
+        // The container's hash values may be the keys themselves, so they
+        // are mixed before picking the bits.
+        static word mix(std::size_t hash)
+        {
+          return boost::unordered::detail::mix_hash_bits(hash);
+        }
+
+        static word next(word h)
+        {
+          return h * ((word(0x9e3779b9u) << 32) + 0x7f4a7c15u);
+        }
+
+        static word bit(word h) { return word(1) << (h >> 58); }
+
+        // Picks the block from the high half of 'h', scaled to the number of
+        // blocks, which avoids a division.
+        word* block(word h) const
+        {
+          std::size_t const i = static_cast<std::size_t>(
+            ((h >> 32) * static_cast<word>(block_count_)) >> 32);
+          return blocks_ + i * bloom_block_words;
+        }
+
+        void create(std::size_t capacity, std::size_t block_count)
+        {
+          // One extra block, so the blocks can start on a cache line.
+          std::size_t const n = (block_count + 1) * bloom_block_words;
+          data_ = word_allocator_traits::allocate(alloc_, n);
+          std::size_t const offset = static_cast<std::size_t>(
+            reinterpret_cast<boost::uintptr_t>(data_) %
+            (sizeof(word) * bloom_block_words));
+          blocks_ = data_ + (offset ? bloom_block_words -
+                                        offset / sizeof(word)
+                                    : 0);
+          block_count_ = block_count;
+          capacity_ = capacity;
+          this->clear();
+        }
+
+        void destroy()
+        {
+          if (data_) {
+            word_allocator_traits::deallocate(
+              alloc_, data_, (block_count_ + 1) * bloom_block_words);
+            data_ = 0;
+            blocks_ = 0;
+          }
+        }
+      };
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,716 @@
+
+// Copyright 2022 Christian Mazakas.
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_UNORDERED_DETAIL_CONCURRENT_INSERT_TABLE_HPP
+#define BOOST_UNORDERED_DETAIL_CONCURRENT_INSERT_TABLE_HPP
+
+#include <boost/config.hpp>
+#if defined(BOOST_HAS_PRAGMA_ONCE)
+#pragma once
+#endif
+
+#include <boost/unordered/detail/implementation.hpp>
+
+#if BOOST_UNORDERED_CONCURRENT
+
+#include <boost/static_assert.hpp>
+#include <boost/type_traits/is_pointer.hpp>
+#include <atomic>
+#include <cmath>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+namespace boost {
+  namespace unordered {
+    namespace detail {
+
+      template <typename A, typename T, typename H, typename P>
+      struct concurrent_insert_set_types
+      {
+        typedef T value_type;
+        typedef T key_type;
+        typedef H hasher;
+        typedef P key_equal;
+
+        typedef
+          typename ::boost::unordered::detail::rebind_wrap<A, value_type>::type
+            value_allocator;
+
+        typedef boost::unordered::detail::set_extractor<value_type> extractor;
+      };
+
+      template <typename A, typename K, typename M, typename H, typename P>
+      struct concurrent_insert_map_types
+      {
+        typedef std::pair<K const, M> value_type;
+        typedef K key_type;
+        typedef H hasher;
+        typedef P key_equal;
+
+        typedef
+          typename ::boost::unordered::detail::rebind_wrap<A, value_type>::type
+            value_allocator;
+
+        typedef boost::unordered::detail::map_extractor<value_type> extractor;
+      };
+
+      // A node is never destroyed or moved while the container is in use,
+      // but its link can change while other threads are following it, when
+      // its bucket is moved to a larger array.
+
+      template <typename ValueType> struct insert_table_node
+      {
+        std::atomic<insert_table_node*> next_;
+        std::size_t hash_;
+        boost::unordered::detail::value_base<ValueType> value_base_;
+
+        insert_table_node() : next_(0), hash_(0), value_base_() {}
+
+        ValueType* value_ptr() { return value_base_.value_ptr(); }
+        ValueType& value() { return value_base_.value(); }
+        ValueType const& value() const { return value_base_.value(); }
+
+      private:
+        insert_table_node(insert_table_node const&);
+        insert_table_node& operator=(insert_table_node const&);
+      };
+
+      // Each bucket points to its own chain of nodes, ending in null, or to
+      // one of the array's two marker nodes. The number of buckets is a
+      // power of 2, and the bucket is picked from the high bits of the hash
+      // value, so bucket 'i' is split into buckets '2 * i' and '2 * i + 1'
+      // of an array twice the size.
+      //
+      // While an array is being moved to a larger one, the larger one is
+      // linked from 'next_', and 'previous_' links back. Arrays that have
+      // been replaced are kept until the container is cleared, as other
+      // threads might still be reading them.
+
+      template <typename Node> struct insert_table_buckets
+      {
+        std::atomic<Node*>* buckets_;
+        std::size_t bucket_count_;
+        int shift_;
+        std::size_t max_load_;
+
+        std::atomic<insert_table_buckets*> next_;
+        insert_table_buckets* previous_;
+
+        // The first bucket that hasn't been claimed by a thread for moving
+        // to 'next_', and the number of buckets that have been moved.
+        std::atomic<std::size_t> transfer_index_;
+        std::atomic<std::size_t> transferred_;
+
+        // 'moved_' marks a bucket whose nodes are in 'next_', 'pending_' a
+        // bucket whose nodes are still in 'previous_'.
+        Node moved_;
+        Node pending_;
+
+        insert_table_buckets()
+            : buckets_(0), bucket_count_(0), shift_(0), max_load_(0), next_(0),
+              previous_(0), transfer_index_(0), transferred_(0), moved_(),
+              pending_()
+        {
+        }
+
+        std::size_t position(std::size_t hash) const { return hash >> shift_; }
+      };
+
+      // A count that's split over several cache lines, so that threads
+      // incrementing it rarely touch the same one. Reading it adds them up.
+
+      struct striped_counter
+      {
+        struct stripe
+        {
+          std::atomic<std::size_t> value_;
+          char padding_[64];
+
+          stripe() : value_(0) {}
+        };
+
+        static std::size_t const stripe_count = 16;
+
+        char padding_[64];
+        stripe stripes_[stripe_count];
+
+        // Threads are assigned a stripe the first time they use one.
+        static std::size_t stripe_index()
+        {
+          static std::atomic<std::size_t> next_index(0);
+          static thread_local std::size_t index =
+            next_index.fetch_add(1, std::memory_order_relaxed) % stripe_count;
+          return index;
+        }
+
+        void increment()
+        {
+          stripes_[stripe_index()].value_.fetch_add(
+            1, std::memory_order_relaxed);
+        }
+
+        std::size_t load() const
+        {
+          std::size_t total = 0;
+          for (std::size_t i = 0; i < stripe_count; ++i) {
+            total += stripes_[i].value_.load(std::memory_order_relaxed);
+          }
+          return total;
+        }
+
+        void reset()
+        {
+          for (std::size_t i = 0; i < stripe_count; ++i) {
+            stripes_[i].value_.store(0, std::memory_order_relaxed);
+          }
+        }
+      };
+
+      ////////////////////////////////////////////////////////////////////////
+      // concurrent_insert_table
+      //
+      // The implementation of the insert-only concurrent containers. New
+      // nodes are linked by a compare and swap on the head of their bucket,
+      // after checking the chain for an equivalent key, so inserting never
+      // takes a lock. Nodes are only unlinked by 'clear'.
+      //
+      // When the load factor gets too high, the thread that notices creates
+      // an array twice the size, and every thread that runs into it helps
+      // to move the buckets over, claiming a few at a time. Moving a bucket
+      // first swaps the marker 'moved_' into it, so that the chain can't
+      // change, and then relinks its nodes into the two new chains, keeping
+      // their order. As a node's link only ever changes to point further
+      // along the original chain, a thread still walking it always reaches
+      // the end, although it can skip nodes, so a lookup that fails checks
+      // whether the bucket was moved in the meantime and tries again in the
+      // new array.
+
+      template <typename Types> class concurrent_insert_table
+      {
+        concurrent_insert_table(concurrent_insert_table const&);
+        concurrent_insert_table& operator=(concurrent_insert_table const&);
+
+      public:
+        typedef typename Types::value_type value_type;
+        typedef typename Types::key_type key_type;
+        typedef typename Types::hasher hasher;
+        typedef typename Types::key_equal key_equal;
+        typedef typename Types::value_allocator value_allocator;
+        typedef typename Types::extractor extractor;
+
+        typedef boost::unordered::detail::insert_table_node<value_type> node;
+        typedef boost::unordered::detail::insert_table_buckets<node>
+          bucket_array;
+        typedef std::atomic<node*> bucket;
+
+      private:
+        typedef typename boost::unordered::detail::rebind_wrap<value_allocator,
+          node>::type node_allocator;
+        typedef typename boost::unordered::detail::rebind_wrap<value_allocator,
+          bucket>::type bucket_allocator;
+        typedef typename boost::unordered::detail::rebind_wrap<value_allocator,
+          bucket_array>::type array_allocator;
+        typedef boost::unordered::detail::allocator_traits<node_allocator>
+          node_allocator_traits;
+        typedef boost::unordered::detail::allocator_traits<bucket_allocator>
+          bucket_allocator_traits;
+        typedef boost::unordered::detail::allocator_traits<array_allocator>
+          array_allocator_traits;
+        typedef typename boost::unordered::detail::pick_policy<key_type,
+          hasher>::type policy;
+
+        BOOST_STATIC_ASSERT_MSG(
+          boost::is_pointer<typename node_allocator_traits::pointer>::value,
+          "the concurrent containers require an allocator that uses raw "
+          "pointers");
+
+        // The number of buckets a thread claims at a time when moving them
+        // to a larger array.
+        static std::size_t const transfer_chunk = 64;
+
+        hasher hf_;
+        key_equal eq_;
+        node_allocator node_alloc_;
+        float mlf_;
+        std::atomic<bucket_array*> buckets_;
+        striped_counter size_;
+
+      public:
+        concurrent_insert_table(std::size_t n, hasher const& hf,
+          key_equal const& eq, value_allocator const& a)
+            : hf_(hf), eq_(eq), node_alloc_(a), mlf_(1.0f), buckets_(0),
+              size_()
+        {
+          buckets_.store(
+            create_buckets(new_bucket_count(n), 0), std::memory_order_relaxed);
+        }
+
+        ~concurrent_insert_table()
+        {
+          destroy_nodes();
+          destroy_arrays(buckets_.load(std::memory_order_relaxed));
+        }
+
+        value_allocator get_allocator() const
+        {
+          return value_allocator(node_alloc_);
+        }
+
+        hasher const& hash_function() const { return hf_; }
+
+        key_equal const& key_eq() const { return eq_; }
+
+        std::size_t size() const { return size_.load(); }
+
+        std::size_t bucket_count() const
+        {
+          return buckets_.load(std::memory_order_acquire)->bucket_count_;
+        }
+
+        float max_load_factor() const { return mlf_; }
+
+        // Not thread safe.
+        void max_load_factor(float z)
+        {
+          BOOST_ASSERT(z > 0);
+          mlf_ = (std::max)(z, boost::unordered::detail::minimum_max_load_factor);
+          bucket_array* b = buckets_.load(std::memory_order_relaxed);
+          b->max_load_ = max_load_for(b->bucket_count_);
+        }
+
+        ////////////////////////////////////////////////////////////////////////
+        // Lookup
+
+        node const* find(key_type const& k) const
+        {
+          return find_node(k, hash(k));
+        }
+
+        node const* find_node(key_type const& k, std::size_t key_hash) const
+        {
+          bucket_array* b = buckets_.load(std::memory_order_acquire);
+          for (;;) {
+            bucket& head = b->buckets_[b->position(key_hash)];
+            node* h = head.load(std::memory_order_acquire);
+            if (h == &b->moved_) {
+              b = b->next_.load(std::memory_order_acquire);
+              continue;
+            }
+            if (h == &b->pending_) {
+              std::this_thread::yield();
+              continue;
+            }
+
+            for (node const* n = h; n;
+                 n = n->next_.load(std::memory_order_acquire)) {
+              if (n->hash_ == key_hash &&
+                  eq_(k, extractor::extract(n->value()))) {
+                return n;
+              }
+            }
+
+            // Nodes can be missed if the bucket was being moved.
+            if (head.load(std::memory_order_acquire) != &b->moved_) {
+              return 0;
+            }
+          }
+        }
+
+        // Not thread safe.
+        template <class F> void visit_all(F& f) const
+        {
+          bucket_array const* b = buckets_.load(std::memory_order_acquire);
+          BOOST_ASSERT(!b->next_.load(std::memory_order_relaxed));
+          for (std::size_t i = 0; i < b->bucket_count_; ++i) {
+            for (node const* n = b->buckets_[i].load(std::memory_order_acquire);
+                 n; n = n->next_.load(std::memory_order_acquire)) {
+              f(n->value());
+            }
+          }
+        }
+
+        ////////////////////////////////////////////////////////////////////////
+        // Insertion
+
+        // Constructs the node from 'args' if 'k' isn't already present.
+        template <class... Args>
+        bool try_emplace_unique(key_type const& k, Args&&... args)
+        {
+          std::size_t const key_hash = hash(k);
+          if (find_node(k, key_hash)) {
+            return false;
+          }
+          return insert_node(create_node(std::forward<Args>(args)...), key_hash);
+        }
+
+        template <class... Args> bool emplace_unique(Args&&... args)
+        {
+          return emplace_unique_impl(
+            extractor::extract(args...), std::forward<Args>(args)...);
+        }
+
+        ////////////////////////////////////////////////////////////////////////
+        // Capacity, thread safe
+
+        void rehash(std::size_t n)
+        {
+          using namespace std;
+
+          std::size_t const count = new_bucket_count((std::max)(n,
+            boost::unordered::detail::double_to_size(
+              floor(static_cast<double>(size()) / static_cast<double>(mlf_)) +
+              1)));
+
+          for (;;) {
+            bucket_array* b = buckets_.load(std::memory_order_acquire);
+            if (b->bucket_count_ >= count) {
+              break;
+            }
+            grow(b);
+            if (buckets_.load(std::memory_order_acquire) == b) {
+              std::this_thread::yield();
+            }
+          }
+        }
+
+        void reserve(std::size_t n)
+        {
+          using namespace std;
+
+          rehash(boost::unordered::detail::double_to_size(
+            ceil(static_cast<double>(n) / static_cast<double>(mlf_))));
+        }
+
+        ////////////////////////////////////////////////////////////////////////
+        // Not thread safe
+
+        void clear()
+        {
+          destroy_nodes();
+
+          bucket_array* b = buckets_.load(std::memory_order_relaxed);
+          destroy_arrays(b->previous_);
+          b->previous_ = 0;
+          for (std::size_t i = 0; i < b->bucket_count_; ++i) {
+            b->buckets_[i].store(0, std::memory_order_relaxed);
+          }
+          size_.reset();
+        }
+
+      private:
+        std::size_t hash(key_type const& k) const
+        {
+          return policy::apply_hash(hf_, k);
+        }
+
+        template <class... Args>
+        bool emplace_unique_impl(key_type const& k, Args&&... args)
+        {
+          return try_emplace_unique(k, std::forward<Args>(args)...);
+        }
+
+        template <class... Args>
+        bool emplace_unique_impl(
+          boost::unordered::detail::no_key, Args&&... args)
+        {
+          node* n = create_node(std::forward<Args>(args)...);
+          std::size_t key_hash;
+          BOOST_TRY { key_hash = hash(extractor::extract(n->value())); }
+          BOOST_CATCH(...)
+          {
+            destroy_node(n);
+            BOOST_RETHROW
+          }
+          BOOST_CATCH_END
+          return insert_node(n, key_hash);
+        }
+
+        // Takes ownership of 'n', destroying it if its key is already
+        // present.
+        bool insert_node(node* n, std::size_t key_hash)
+        {
+          n->hash_ = key_hash;
+          bool inserted = false;
+          BOOST_TRY { inserted = link_unique(n); }
+          BOOST_CATCH(...)
+          {
+            destroy_node(n);
+            BOOST_RETHROW
+          }
+          BOOST_CATCH_END
+
+          if (!inserted) {
+            destroy_node(n);
+          }
+          return inserted;
+        }
+
+        bool link_unique(node* n)
+        {
+          key_type const& k = extractor::extract(n->value());
+          bucket_array* b = buckets_.load(std::memory_order_acquire);
+          for (;;) {
+            bucket& head = b->buckets_[b->position(n->hash_)];
+            node* h = head.load(std::memory_order_acquire);
+            if (h == &b->moved_) {
+              help_transfer(b);
+              b = b->next_.load(std::memory_order_acquire);
+              continue;
+            }
+            if (h == &b->pending_) {
+              help_transfer(b->previous_);
+              std::this_thread::yield();
+              continue;
+            }
+
+            std::size_t length = 0;
+            for (node const* p = h; p;
+                 p = p->next_.load(std::memory_order_acquire), ++length) {
+              if (p->hash_ == n->hash_ &&
+                  eq_(k, extractor::extract(p->value()))) {
+                return false;
+              }
+            }
+
+            // Only check the load when the bucket isn't empty, as adding up
+            // the size touches several cache lines.
+            if (length != 0 && size() >= b->max_load_) {
+              grow(b);
+              b = buckets_.load(std::memory_order_acquire);
+              continue;
+            }
+
+            n->next_.store(h, std::memory_order_relaxed);
+            if (head.compare_exchange_weak(
+                  h, n, std::memory_order_release, std::memory_order_relaxed)) {
+              size_.increment();
+              return true;
+            }
+          }
+        }
+
+        ////////////////////////////////////////////////////////////////////////
+        // Growth
+
+        // Starts moving 'b' to an array twice the size, or helps if another
+        // thread already has.
+        void grow(bucket_array* b)
+        {
+          bucket_array* current = buckets_.load(std::memory_order_acquire);
+          if (current != b) {
+            // 'b' is still being filled from the current array.
+            help_transfer(current);
+            return;
+          }
+
+          if (!b->next_.load(std::memory_order_acquire)) {
+            if (b->bucket_count_ >
+                (std::numeric_limits<std::size_t>::max)() / 2) {
+              boost::throw_exception(std::length_error(
+                "concurrent_insert_table: too many buckets"));
+            }
+
+            bucket_array* new_b = create_buckets(b->bucket_count_ * 2, b);
+            bucket_array* expected = 0;
+            if (!b->next_.compare_exchange_strong(expected, new_b,
+                  std::memory_order_acq_rel, std::memory_order_acquire)) {
+              destroy_buckets(new_b);
+            }
+          }
+
+          help_transfer(b);
+        }
+
+        // Moves buckets from 'b' to 'b->next_' until none are left
+        // unclaimed. The thread that moves the last one makes the new array
+        // current.
+        void help_transfer(bucket_array* b)
+        {
+          bucket_array* new_b = b->next_.load(std::memory_order_acquire);
+          if (!new_b) {
+            return;
+          }
+
+          std::size_t const count = b->bucket_count_;
+          for (;;) {
+            std::size_t const start = b->transfer_index_.fetch_add(
+              transfer_chunk, std::memory_order_relaxed);
+            if (start >= count) {
+              return;
+            }
+
+            std::size_t const end = (std::min)(count, start + transfer_chunk);
+            for (std::size_t i = start; i < end; ++i) {
+              transfer_bucket(b, new_b, i);
+            }
+
+            if (b->transferred_.fetch_add(
+                  end - start, std::memory_order_acq_rel) +
+                  (end - start) ==
+                count) {
+              buckets_.store(new_b, std::memory_order_release);
+            }
+          }
+        }
+
+        void transfer_bucket(bucket_array* b, bucket_array* new_b, std::size_t i)
+        {
+          node* n = b->buckets_[i].exchange(&b->moved_, std::memory_order_acq_rel);
+
+          node* heads[2] = {0, 0};
+          node* tails[2] = {0, 0};
+          while (n) {
+            node* next = n->next_.load(std::memory_order_relaxed);
+            std::size_t const j = new_b->position(n->hash_) - 2 * i;
+            BOOST_ASSERT(j < 2);
+            if (tails[j]) {
+              tails[j]->next_.store(n, std::memory_order_release);
+            } else {
+              heads[j] = n;
+            }
+            tails[j] = n;
+            n = next;
+          }
+
+          for (std::size_t j = 0; j < 2; ++j) {
+            if (tails[j]) {
+              tails[j]->next_.store(0, std::memory_order_release);
+            }
+            new_b->buckets_[2 * i + j].store(
+              heads[j], std::memory_order_release);
+          }
+        }
+
+        ////////////////////////////////////////////////////////////////////////
+        // Nodes
+
+        template <class... Args> node* create_node(Args&&... args)
+        {
+          node* n = node_allocator_traits::allocate(node_alloc_, 1);
+          new ((void*)n) node();
+          BOOST_TRY
+          {
+            node_allocator_traits::construct(
+              node_alloc_, n->value_ptr(), std::forward<Args>(args)...);
+          }
+          BOOST_CATCH(...)
+          {
+            n->~node();
+            node_allocator_traits::deallocate(node_alloc_, n, 1);
+            BOOST_RETHROW
+          }
+          BOOST_CATCH_END
+          return n;
+        }
+
+        void destroy_node(node* n)
+        {
+          node_allocator_traits::destroy(node_alloc_, n->value_ptr());
+          n->~node();
+          node_allocator_traits::deallocate(node_alloc_, n, 1);
+        }
+
+        // Destroys the nodes in the current array, leaving the buckets
+        // dangling.
+        void destroy_nodes()
+        {
+          bucket_array* b = buckets_.load(std::memory_order_relaxed);
+          BOOST_ASSERT(!b->next_.load(std::memory_order_relaxed));
+          for (std::size_t i = 0; i < b->bucket_count_; ++i) {
+            node* n = b->buckets_[i].load(std::memory_order_relaxed);
+            while (n) {
+              node* next = n->next_.load(std::memory_order_relaxed);
+              destroy_node(n);
+              n = next;
+            }
+          }
+        }
+
+        ////////////////////////////////////////////////////////////////////////
+        // Buckets
+
+        static std::size_t new_bucket_count(std::size_t n)
+        {
+          std::size_t const max =
+            (std::numeric_limits<std::size_t>::max)() / 2 + 1;
+          std::size_t count = 2;
+          while (count < n && count < max) {
+            count *= 2;
+          }
+          return count;
+        }
+
+        std::size_t max_load_for(std::size_t count) const
+        {
+          using namespace std;
+
+          return boost::unordered::detail::double_to_size(
+            ceil(static_cast<double>(mlf_) * static_cast<double>(count)));
+        }
+
+        // When 'previous' is set, the buckets start off pending.
+        bucket_array* create_buckets(std::size_t count, bucket_array* previous)
+        {
+          array_allocator array_alloc(node_alloc_);
+          bucket_allocator bucket_alloc(node_alloc_);
+
+          bucket_array* b = array_allocator_traits::allocate(array_alloc, 1);
+          BOOST_TRY
+          {
+            new ((void*)b) bucket_array();
+            b->buckets_ = bucket_allocator_traits::allocate(bucket_alloc, count);
+          }
+          BOOST_CATCH(...)
+          {
+            b->~bucket_array();
+            array_allocator_traits::deallocate(array_alloc, b, 1);
+            BOOST_RETHROW
+          }
+          BOOST_CATCH_END
+
+          node* initial = previous ? &b->pending_ : 0;
+          for (std::size_t i = 0; i < count; ++i) {
+            new ((void*)(b->buckets_ + i)) bucket(initial);
+          }
+          b->bucket_count_ = count;
+          b->shift_ = std::numeric_limits<std::size_t>::digits -
+                      (static_cast<int>(boost::core::bit_width(count)) - 1);
+          b->max_load_ = max_load_for(count);
+          b->previous_ = previous;
+          return b;
+        }
+
+        void destroy_buckets(bucket_array* b)
+        {
+          array_allocator array_alloc(node_alloc_);
+          bucket_allocator bucket_alloc(node_alloc_);
+
+          for (std::size_t i = 0; i < b->bucket_count_; ++i) {
+            b->buckets_[i].~bucket();
+          }
+          bucket_allocator_traits::deallocate(
+            bucket_alloc, b->buckets_, b->bucket_count_);
+          b->~bucket_array();
+          array_allocator_traits::deallocate(array_alloc, b, 1);
+        }
+
+        // Destroys 'b' and all the arrays it replaced.
+        void destroy_arrays(bucket_array* b)
+        {
+          while (b) {
+            bucket_array* previous = b->previous_;
+            destroy_buckets(b);
+            b = previous;
+          }
+        }
+      };
+    }
+  }
+}
+
+#endif
+
+#endif
@@ -0,0 +1,183 @@
+
+// Copyright 2022 Christian Mazakas.
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_UNORDERED_DETAIL_EPOCH_HPP
+#define BOOST_UNORDERED_DETAIL_EPOCH_HPP
+
+#include <boost/config.hpp>
+#if defined(BOOST_HAS_PRAGMA_ONCE)
+#pragma once
+#endif
+
+#include <boost/unordered/detail/implementation.hpp>
+
+#if BOOST_UNORDERED_CONCURRENT
+
+#include <atomic>
+#include <cstddef>
+#include <thread>
+
+namespace boost {
+  namespace unordered {
+    namespace detail {
+      namespace epoch {
+
+        ////////////////////////////////////////////////////////////////////////
+        // Epoch based reclamation
+        //
+        // Readers announce the global epoch they saw when they started, and
+        // clear it when they're done. Memory that a writer has unlinked is
+        // tagged with the epoch at the time, and can be freed once every
+        // active reader has announced a later epoch, as they can't have seen
+        // it.
+        //
+        // Each thread announces its epoch in its own slot, padded so that
+        // reading never writes to a cache line shared with another thread.
+        // Slots are never freed, but they're reused after a thread exits.
+
+        struct slot
+        {
+          std::atomic<std::size_t> epoch_; // 0 when not reading
+          std::atomic<bool> in_use_;
+          slot* next_;
+          char padding_[64];
+
+          slot() : epoch_(0), in_use_(true), next_(0) {}
+        };
+
+        struct domain
+        {
+          std::atomic<std::size_t> epoch_;
+          std::atomic<slot*> slots_;
+
+          domain() : epoch_(1), slots_(0) {}
+
+          slot* acquire_slot()
+          {
+            for (slot* s = slots_.load(std::memory_order_acquire); s;
+                 s = s->next_) {
+              bool expected = false;
+              if (!s->in_use_.load(std::memory_order_relaxed) &&
+                  s->in_use_.compare_exchange_strong(
+                    expected, true, std::memory_order_acq_rel)) {
+                return s;
+              }
+            }
+
+            slot* s = new slot();
+            slot* head = slots_.load(std::memory_order_relaxed);
+            do {
+              s->next_ = head;
+            } while (!slots_.compare_exchange_weak(head, s,
+              std::memory_order_release, std::memory_order_relaxed));
+            return s;
+          }
+
+          // Increments the epoch, returning the previous value. Anything
+          // unlinked before the call can be tagged with the result.
+          std::size_t advance()
+          {
+            return epoch_.fetch_add(1, std::memory_order_seq_cst);
+          }
+
+          // The earliest epoch announced by an active reader, or the
+          // maximum value when nothing is being read.
+          std::size_t min_epoch() const
+          {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+            std::size_t m = (std::numeric_limits<std::size_t>::max)();
+            for (slot* s = slots_.load(std::memory_order_acquire); s;
+                 s = s->next_) {
+              std::size_t e = s->epoch_.load(std::memory_order_acquire);
+              if (e && e < m) {
+                m = e;
+              }
+            }
+            return m;
+          }
+
+          // Waits until every reader that might have seen memory unlinked
+          // before the call has finished.
+          void synchronize()
+          {
+            std::size_t e = advance();
+            while (min_epoch() <= e) {
+              std::this_thread::yield();
+            }
+          }
+        };
+
+        inline domain& global_domain()
+        {
+          static domain d;
+          return d;
+        }
+
+        struct thread_record
+        {
+          slot* slot_;
+          std::size_t depth_;
+
+          thread_record() : slot_(0), depth_(0) {}
+
+          ~thread_record()
+          {
+            if (slot_) {
+              slot_->epoch_.store(0, std::memory_order_release);
+              slot_->in_use_.store(false, std::memory_order_release);
+            }
+          }
+        };
+
+        inline thread_record& local_record()
+        {
+          static thread_local thread_record r;
+          return r;
+        }
+
+        // True when the current thread is inside a read_guard, in which case
+        // it mustn't wait for a grace period.
+        inline bool reading() { return local_record().depth_ != 0; }
+
+        // Marks the current thread as reading for the guard's lifetime.
+        // Guards can be nested.
+        class read_guard
+        {
+          read_guard(read_guard const&);
+          read_guard& operator=(read_guard const&);
+
+          thread_record& record_;
+
+        public:
+          read_guard() : record_(local_record())
+          {
+            if (record_.depth_++ == 0) {
+              domain& d = global_domain();
+              if (!record_.slot_) {
+                record_.slot_ = d.acquire_slot();
+              }
+              record_.slot_->epoch_.store(
+                d.epoch_.load(std::memory_order_acquire),
+                std::memory_order_relaxed);
+              std::atomic_thread_fence(std::memory_order_seq_cst);
+            }
+          }
+
+          ~read_guard()
+          {
+            if (--record_.depth_ == 0) {
+              record_.slot_->epoch_.store(0, std::memory_order_release);
+            }
+          }
+        };
+      }
+    }
+  }
+}
+
+#endif
+
+#endif
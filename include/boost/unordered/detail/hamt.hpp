@@ -0,0 +1,680 @@
+
+// Copyright 2022 Christian Mazakas.
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_UNORDERED_DETAIL_HAMT_HPP
+#define BOOST_UNORDERED_DETAIL_HAMT_HPP
+
+#include <boost/config.hpp>
+#if defined(BOOST_HAS_PRAGMA_ONCE)
+#pragma once
+#endif
+
+#include <boost/unordered/detail/implementation.hpp>
+
+#if !defined(BOOST_NO_CXX11_HDR_ATOMIC) &&                                     \
+  !defined(BOOST_NO_CXX11_RVALUE_REFERENCES) &&                                \
+  !defined(BOOST_NO_CXX11_VARIADIC_TEMPLATES)
+
+#include <boost/assert.hpp>
+#include <boost/core/bit.hpp>
+#include <boost/core/swap.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/type_traits/is_same.hpp>
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+#include <utility>
+
+namespace boost {
+  namespace unordered {
+    namespace detail {
+
+      ////////////////////////////////////////////////////////////////////////
+      // Hash array mapped trie
+      //
+      // Each level of branches uses 5 bits of the element's hash value to
+      // pick one of 32 children, and only stores the children present, with
+      // a bitmap of which they are. Elements whose hash values have all of
+      // the 60 bits used by the branches in common share a collision node.
+      //
+      // Copies share their nodes, which are reference counted, so copying
+      // is constant time. Before a modification, the nodes on the path to
+      // the element are copied if another version also holds them, so that
+      // the other versions never see the change. The counts are atomic, and
+      // a node is only changed in place when it's only held by this version
+      // through a path that also is, so different versions can be used on
+      // different threads.
+
+      static const unsigned hamt_bits = 5;
+      static const unsigned hamt_max_depth = 12;
+
+      struct hamt_node
+      {
+        enum kind_type
+        {
+          leaf_kind,
+          branch_kind,
+          collision_kind
+        };
+
+        std::atomic<std::size_t> count_;
+        kind_type kind_;
+
+        explicit hamt_node(kind_type kind) : count_(1), kind_(kind) {}
+
+      private:
+        hamt_node(hamt_node const&);
+        hamt_node& operator=(hamt_node const&);
+      };
+
+      template <typename ValueType> struct hamt_leaf : hamt_node
+      {
+        boost::uint64_t hash_;
+        boost::unordered::detail::value_base<ValueType> value_base_;
+
+        hamt_leaf() : hamt_node(leaf_kind), hash_(0), value_base_() {}
+
+        ValueType* value_ptr() { return value_base_.value_ptr(); }
+        ValueType& value() { return value_base_.value(); }
+        ValueType const& value() const { return value_base_.value(); }
+      };
+
+      // A branch or a collision node. The children are stored after it, in
+      // the same allocation, and 'capacity_' is how many there is room for.
+      struct hamt_inner : hamt_node
+      {
+        boost::uint32_t bits_; // the indexes of a branch's children
+        boost::uint32_t size_;
+        boost::uint32_t capacity_;
+
+        hamt_inner(kind_type kind, boost::uint32_t capacity)
+            : hamt_node(kind), bits_(0), size_(0), capacity_(capacity)
+        {
+        }
+
+        hamt_node** children()
+        {
+          return reinterpret_cast<hamt_node**>(this + 1);
+        }
+
+        hamt_node* const* children() const
+        {
+          return reinterpret_cast<hamt_node* const*>(this + 1);
+        }
+
+        // The position among a branch's children of the one for 'index'.
+        unsigned position(unsigned index) const
+        {
+          return static_cast<unsigned>(
+            boost::core::popcount(bits_ & ((1u << index) - 1)));
+        }
+      };
+
+      template <typename A, typename K, typename M, typename H, typename P>
+      struct hamt_table;
+    }
+
+    namespace iterator_detail {
+
+      // Keeps the path from the root to the current leaf, so that it can
+      // move on to the next one.
+      template <typename ValueType> struct hamt_iterator
+      {
+        typedef ValueType value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef value_type const* pointer;
+        typedef value_type const& reference;
+        typedef std::forward_iterator_tag iterator_category;
+
+      private:
+        typedef boost::unordered::detail::hamt_node node;
+        typedef boost::unordered::detail::hamt_inner inner;
+        typedef boost::unordered::detail::hamt_leaf<ValueType> leaf;
+
+        template <typename A, typename K, typename M, typename H, typename P>
+        friend struct boost::unordered::detail::hamt_table;
+
+        inner const* nodes_[boost::unordered::detail::hamt_max_depth + 1];
+        unsigned positions_[boost::unordered::detail::hamt_max_depth + 1];
+        unsigned depth_;
+        leaf const* leaf_;
+
+      public:
+        hamt_iterator() BOOST_NOEXCEPT : nodes_(),
+                                         positions_(),
+                                         depth_(0),
+                                         leaf_()
+        {
+        }
+
+        reference operator*() const BOOST_NOEXCEPT { return leaf_->value(); }
+
+        pointer operator->() const BOOST_NOEXCEPT { return &leaf_->value(); }
+
+        hamt_iterator& operator++() BOOST_NOEXCEPT
+        {
+          this->increment();
+          return *this;
+        }
+
+        hamt_iterator operator++(int) BOOST_NOEXCEPT
+        {
+          hamt_iterator tmp(*this);
+          this->increment();
+          return tmp;
+        }
+
+        bool operator==(hamt_iterator const& x) const BOOST_NOEXCEPT
+        {
+          return leaf_ == x.leaf_;
+        }
+
+        bool operator!=(hamt_iterator const& x) const BOOST_NOEXCEPT
+        {
+          return leaf_ != x.leaf_;
+        }
+
+      private:
+        void push(inner const* n, unsigned position)
+        {
+          nodes_[depth_] = n;
+          positions_[depth_] = position;
+          ++depth_;
+        }
+
+        // Goes down the first children from 'n' to a leaf.
+        void descend(node const* n)
+        {
+          while (n->kind_ != node::leaf_kind) {
+            inner const* b = static_cast<inner const*>(n);
+            this->push(b, 0);
+            n = b->children()[0];
+          }
+          leaf_ = static_cast<leaf const*>(n);
+        }
+
+        void increment()
+        {
+          while (depth_) {
+            unsigned const d = depth_ - 1;
+            if (++positions_[d] < nodes_[d]->size_) {
+              this->descend(nodes_[d]->children()[positions_[d]]);
+              return;
+            }
+            depth_ = d;
+          }
+          leaf_ = 0;
+        }
+      };
+    }
+
+    namespace detail {
+
+      template <typename A, typename K, typename M, typename H, typename P>
+      struct hamt_table
+      {
+        typedef std::pair<K const, M> value_type;
+        typedef hamt_leaf<value_type> leaf;
+        typedef boost::unordered::iterator_detail::hamt_iterator<value_type>
+          iterator;
+
+        typedef typename boost::unordered::detail::rebind_wrap<A, leaf>::type
+          leaf_allocator;
+        typedef boost::unordered::detail::allocator_traits<leaf_allocator>
+          leaf_allocator_traits;
+        typedef
+          typename boost::unordered::detail::rebind_wrap<A, hamt_node*>::type
+            slot_allocator;
+        typedef boost::unordered::detail::allocator_traits<slot_allocator>
+          slot_allocator_traits;
+
+        BOOST_STATIC_ASSERT((boost::is_same<
+          typename leaf_allocator_traits::pointer, leaf*>::value));
+        BOOST_STATIC_ASSERT((boost::is_same<
+          typename slot_allocator_traits::pointer, hamt_node**>::value));
+        BOOST_STATIC_ASSERT(sizeof(hamt_inner) % sizeof(hamt_node*) == 0);
+
+        // An inner node is allocated as an array of child pointers, with
+        // the node itself in the first ones.
+        static const std::size_t header_slots =
+          sizeof(hamt_inner) / sizeof(hamt_node*);
+
+        leaf_allocator leaf_alloc_;
+        slot_allocator slot_alloc_;
+        H hf_;
+        P eq_;
+        hamt_node* root_;
+        std::size_t size_;
+
+        hamt_table(H const& hf, P const& eq, A const& a)
+            : leaf_alloc_(a), slot_alloc_(a), hf_(hf), eq_(eq), root_(),
+              size_(0)
+        {
+        }
+
+        // Shares the root, so any version can free the nodes, with its copy
+        // of the allocator.
+        hamt_table(hamt_table const& x)
+            : leaf_alloc_(x.leaf_alloc_), slot_alloc_(x.slot_alloc_),
+              hf_(x.hf_), eq_(x.eq_), root_(x.root_), size_(x.size_)
+        {
+          acquire(root_);
+        }
+
+        ~hamt_table() { this->release(root_); }
+
+        void swap(hamt_table& x)
+        {
+          boost::swap(leaf_alloc_, x.leaf_alloc_);
+          boost::swap(slot_alloc_, x.slot_alloc_);
+          boost::swap(hf_, x.hf_);
+          boost::swap(eq_, x.eq_);
+          boost::swap(root_, x.root_);
+          boost::swap(size_, x.size_);
+        }
+
+        void clear()
+        {
+          this->release(root_);
+          root_ = 0;
+          size_ = 0;
+        }
+
+        boost::uint64_t hash(K const& k) const
+        {
+          return boost::unordered::detail::mix_hash_bits(hf_(k));
+        }
+
+        static K const& key(leaf const* l) { return l->value().first; }
+
+        static leaf const* get_leaf(iterator const& it) { return it.leaf_; }
+
+        static unsigned index(boost::uint64_t h, unsigned shift)
+        {
+          return static_cast<unsigned>(h >> shift) & 31u;
+        }
+
+        bool matches(hamt_node const* n, boost::uint64_t h, K const& k) const
+        {
+          leaf const* l = static_cast<leaf const*>(n);
+          return l->hash_ == h && eq_(k, key(l));
+        }
+
+        ////////////////////////////////////////////////////////////////////
+        // Lookup
+
+        leaf* find(boost::uint64_t h, K const& k) const
+        {
+          hamt_node* n = root_;
+          for (unsigned shift = 0; n; shift += hamt_bits) {
+            if (n->kind_ == hamt_node::leaf_kind) {
+              return this->matches(n, h, k) ? static_cast<leaf*>(n) : 0;
+            }
+            hamt_inner* b = static_cast<hamt_inner*>(n);
+            if (b->kind_ == hamt_node::collision_kind) {
+              for (unsigned i = 0; i < b->size_; ++i) {
+                if (this->matches(b->children()[i], h, k)) {
+                  return static_cast<leaf*>(b->children()[i]);
+                }
+              }
+              return 0;
+            }
+            unsigned const i = index(h, shift);
+            if (!(b->bits_ & (1u << i))) {
+              return 0;
+            }
+            n = b->children()[b->position(i)];
+          }
+          return 0;
+        }
+
+        // As 'find', but also records the path, for the iterator.
+        iterator find_iterator(boost::uint64_t h, K const& k) const
+        {
+          iterator it;
+          hamt_node const* n = root_;
+          for (unsigned shift = 0; n; shift += hamt_bits) {
+            if (n->kind_ == hamt_node::leaf_kind) {
+              if (this->matches(n, h, k)) {
+                it.leaf_ = static_cast<leaf const*>(n);
+              }
+              return it;
+            }
+            hamt_inner const* b = static_cast<hamt_inner const*>(n);
+            if (b->kind_ == hamt_node::collision_kind) {
+              for (unsigned i = 0; i < b->size_; ++i) {
+                if (this->matches(b->children()[i], h, k)) {
+                  it.push(b, i);
+                  it.leaf_ = static_cast<leaf const*>(b->children()[i]);
+                }
+              }
+              return it;
+            }
+            unsigned const i = index(h, shift);
+            if (!(b->bits_ & (1u << i))) {
+              return it;
+            }
+            unsigned const pos = b->position(i);
+            it.push(b, pos);
+            n = b->children()[pos];
+          }
+          return it;
+        }
+
+        iterator begin() const
+        {
+          iterator it;
+          if (root_) {
+            it.descend(root_);
+          }
+          return it;
+        }
+
+        ////////////////////////////////////////////////////////////////////
+        // Modifiers
+        //
+        // The path is made unshared from the top down, before anything is
+        // changed, so if an allocation throws, the elements are the same,
+        // even if some of the nodes have been copied.
+
+        // Adds 'l', whose key isn't in the table.
+        void insert(leaf* l)
+        {
+          boost::uint64_t const h = l->hash_;
+          if (!root_) {
+            hamt_inner* b = this->allocate_inner(hamt_node::branch_kind, 1);
+            this->add_child(b, 0, l);
+            b->bits_ = 1u << index(h, 0);
+            root_ = b;
+            ++size_;
+            return;
+          }
+
+          hamt_node** slot = &root_;
+          for (unsigned shift = 0;; shift += hamt_bits) {
+            this->unshare(*slot);
+            hamt_inner* b = static_cast<hamt_inner*>(*slot);
+            if (b->kind_ == hamt_node::collision_kind) {
+              *slot = this->add_child(b, b->size_, l);
+              break;
+            }
+            unsigned const i = index(h, shift);
+            unsigned const pos = b->position(i);
+            if (!(b->bits_ & (1u << i))) {
+              b = this->add_child(b, pos, l);
+              b->bits_ |= 1u << i;
+              *slot = b;
+              break;
+            }
+            hamt_node*& child = b->children()[pos];
+            if (child->kind_ == hamt_node::leaf_kind) {
+              child = this->merge(
+                static_cast<leaf*>(child), l, shift + hamt_bits);
+              break;
+            }
+            slot = &child;
+          }
+          ++size_;
+        }
+
+        // Returns the leaf for 'k', which must be present, after making sure
+        // that it, and the path to it, are only held by this version, so
+        // that its value can be changed.
+        leaf* unshare_leaf(boost::uint64_t h, K const& k)
+        {
+          hamt_node** slot = &root_;
+          for (unsigned shift = 0;; shift += hamt_bits) {
+            this->unshare(*slot);
+            hamt_inner* b = static_cast<hamt_inner*>(*slot);
+            slot = &b->children()[this->child_position(b, h, k, shift)];
+            if ((*slot)->kind_ == hamt_node::leaf_kind) {
+              break;
+            }
+          }
+
+          leaf* l = static_cast<leaf*>(*slot);
+          if (l->count_.load(std::memory_order_acquire) != 1) {
+            leaf* c = this->create_leaf(l->value());
+            c->hash_ = l->hash_;
+            *slot = c;
+            this->release(l);
+            l = c;
+          }
+          return l;
+        }
+
+        // Removes the element with key 'k', which must be present. Nodes
+        // left with a single leaf are replaced by it, so that lookups don't
+        // go through longer paths than they need.
+        void erase(boost::uint64_t h, K const& k)
+        {
+          hamt_node** path[hamt_max_depth + 1];
+          unsigned indexes[hamt_max_depth + 1];
+          unsigned depth = 0;
+
+          hamt_node** slot = &root_;
+          hamt_node* removed = 0;
+          for (unsigned shift = 0;; shift += hamt_bits) {
+            this->unshare(*slot);
+            hamt_inner* b = static_cast<hamt_inner*>(*slot);
+            unsigned const pos = this->child_position(b, h, k, shift);
+            path[depth] = slot;
+            indexes[depth] = index(h, shift);
+            ++depth;
+            hamt_node*& child = b->children()[pos];
+            if (child->kind_ == hamt_node::leaf_kind) {
+              removed = child;
+              this->remove_child(b, pos, indexes[depth - 1]);
+              break;
+            }
+            slot = &child;
+          }
+
+          while (depth--) {
+            hamt_inner* b = static_cast<hamt_inner*>(*path[depth]);
+            if (b->size_ == 0) {
+              this->deallocate_inner(b);
+              if (!depth) {
+                root_ = 0;
+                break;
+              }
+              hamt_inner* parent = static_cast<hamt_inner*>(*path[depth - 1]);
+              this->remove_child(parent,
+                static_cast<unsigned>(path[depth] - parent->children()),
+                indexes[depth - 1]);
+            } else if (depth && b->size_ == 1 &&
+                       b->children()[0]->kind_ == hamt_node::leaf_kind) {
+              *path[depth] = b->children()[0];
+              this->deallocate_inner(b);
+            } else {
+              break;
+            }
+          }
+
+          this->release(removed);
+          --size_;
+        }
+
+        ////////////////////////////////////////////////////////////////////
+        // Nodes
+
+        template <class... Args> leaf* create_leaf(Args&&... args)
+        {
+          leaf* l = leaf_allocator_traits::allocate(leaf_alloc_, 1);
+          new ((void*)l) leaf();
+          BOOST_TRY
+          {
+            leaf_allocator_traits::construct(
+              leaf_alloc_, l->value_ptr(), std::forward<Args>(args)...);
+          }
+          BOOST_CATCH(...)
+          {
+            l->~leaf();
+            leaf_allocator_traits::deallocate(leaf_alloc_, l, 1);
+            BOOST_RETHROW
+          }
+          BOOST_CATCH_END
+          return l;
+        }
+
+        void destroy_leaf(leaf* l)
+        {
+          leaf_allocator_traits::destroy(leaf_alloc_, l->value_ptr());
+          l->~leaf();
+          leaf_allocator_traits::deallocate(leaf_alloc_, l, 1);
+        }
+
+        static void acquire(hamt_node* n)
+        {
+          if (n) {
+            n->count_.fetch_add(1, std::memory_order_relaxed);
+          }
+        }
+
+        void release(hamt_node* n)
+        {
+          if (n && n->count_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            if (n->kind_ == hamt_node::leaf_kind) {
+              this->destroy_leaf(static_cast<leaf*>(n));
+            } else {
+              hamt_inner* b = static_cast<hamt_inner*>(n);
+              for (unsigned i = 0; i < b->size_; ++i) {
+                this->release(b->children()[i]);
+              }
+              this->deallocate_inner(b);
+            }
+          }
+        }
+
+      private:
+        hamt_table& operator=(hamt_table const&);
+
+        hamt_inner* allocate_inner(
+          hamt_node::kind_type kind, boost::uint32_t capacity)
+        {
+          hamt_node** p = slot_allocator_traits::allocate(
+            slot_alloc_, header_slots + capacity);
+          return new ((void*)p) hamt_inner(kind, capacity);
+        }
+
+        // Frees the node without releasing its children.
+        void deallocate_inner(hamt_inner* b)
+        {
+          std::size_t const n = header_slots + b->capacity_;
+          b->~hamt_inner();
+          slot_allocator_traits::deallocate(
+            slot_alloc_, reinterpret_cast<hamt_node**>(b), n);
+        }
+
+        // Replaces the inner node in 'slot', which is only held by this
+        // version, with a copy, when the node is also held by another.
+        void unshare(hamt_node*& slot)
+        {
+          if (slot->count_.load(std::memory_order_acquire) == 1) {
+            return;
+          }
+          hamt_inner* b = static_cast<hamt_inner*>(slot);
+          hamt_inner* c = this->allocate_inner(b->kind_, b->size_);
+          c->bits_ = b->bits_;
+          c->size_ = b->size_;
+          for (unsigned i = 0; i < b->size_; ++i) {
+            c->children()[i] = b->children()[i];
+            acquire(b->children()[i]);
+          }
+          slot = c;
+          this->release(b);
+        }
+
+        unsigned child_position(hamt_inner const* b, boost::uint64_t h,
+          K const& k, unsigned shift) const
+        {
+          if (b->kind_ == hamt_node::collision_kind) {
+            unsigned pos = 0;
+            while (!this->matches(b->children()[pos], h, k)) {
+              ++pos;
+              BOOST_ASSERT(pos < b->size_);
+            }
+            return pos;
+          }
+          BOOST_ASSERT(b->bits_ & (1u << index(h, shift)));
+          return b->position(index(h, shift));
+        }
+
+        // Inserts 'n' at 'pos' in the children of 'b', which is only held by
+        // this version. Returns the node that replaces 'b', if it had to be
+        // moved to a larger allocation.
+        hamt_inner* add_child(hamt_inner* b, unsigned pos, hamt_node* n)
+        {
+          if (b->size_ == b->capacity_) {
+            hamt_inner* c = this->allocate_inner(b->kind_, b->size_ + 1);
+            c->bits_ = b->bits_;
+            c->size_ = b->size_;
+            std::copy(b->children(), b->children() + b->size_, c->children());
+            this->deallocate_inner(b);
+            b = c;
+          }
+          std::copy_backward(b->children() + pos, b->children() + b->size_,
+            b->children() + b->size_ + 1);
+          b->children()[pos] = n;
+          ++b->size_;
+          return b;
+        }
+
+        void remove_child(hamt_inner* b, unsigned pos, unsigned index)
+        {
+          std::copy(b->children() + pos + 1, b->children() + b->size_,
+            b->children() + pos);
+          --b->size_;
+          if (b->kind_ == hamt_node::branch_kind) {
+            b->bits_ &= ~(1u << index);
+          }
+        }
+
+        // Builds the nodes that tell 'a' and 'b' apart, from 'shift' down.
+        hamt_node* merge(leaf* a, leaf* b, unsigned shift)
+        {
+          if (shift >= hamt_bits * hamt_max_depth) {
+            hamt_inner* c = this->allocate_inner(hamt_node::collision_kind, 2);
+            c->children()[0] = a;
+            c->children()[1] = b;
+            c->size_ = 2;
+            return c;
+          }
+
+          unsigned const ia = index(a->hash_, shift);
+          unsigned const ib = index(b->hash_, shift);
+          if (ia == ib) {
+            hamt_inner* c = this->allocate_inner(hamt_node::branch_kind, 1);
+            BOOST_TRY
+            {
+              c->children()[0] = this->merge(a, b, shift + hamt_bits);
+            }
+            BOOST_CATCH(...)
+            {
+              this->deallocate_inner(c);
+              BOOST_RETHROW
+            }
+            BOOST_CATCH_END
+            c->bits_ = 1u << ia;
+            c->size_ = 1;
+            return c;
+          }
+
+          hamt_inner* c = this->allocate_inner(hamt_node::branch_kind, 2);
+          c->children()[ia < ib ? 0 : 1] = a;
+          c->children()[ia < ib ? 1 : 0] = b;
+          c->bits_ = (1u << ia) | (1u << ib);
+          c->size_ = 2;
+          return c;
+        }
+      };
+    }
+  }
+}
+
+#endif
+
+#endif
@@ -17,6 +17,7 @@
 #include <boost/core/no_exceptions_support.hpp>
 #include <boost/core/pointer_traits.hpp>
 #include <boost/core/bit.hpp>
+#include <boost/cstdint.hpp>
 #include <boost/detail/select_type.hpp>
 #include <boost/limits.hpp>
 #include <boost/move/move.hpp>
@@ -28,6 +29,7 @@
 #include <boost/preprocessor/repetition/repeat_from_to.hpp>
 #include <boost/preprocessor/seq/enum.hpp>
 #include <boost/preprocessor/seq/size.hpp>
+#include <boost/preprocessor/seq/transform.hpp>
 #include <boost/swap.hpp>
 #include <boost/throw_exception.hpp>
 #include <boost/tuple/tuple.hpp>
@@ -35,6 +37,7 @@
 #include <boost/type_traits/aligned_storage.hpp>
 #include <boost/type_traits/alignment_of.hpp>
 #include <boost/type_traits/integral_constant.hpp>
+#include <boost/type_traits/is_arithmetic.hpp>
 #include <boost/type_traits/is_base_of.hpp>
 #include <boost/type_traits/is_class.hpp>
 #include <boost/type_traits/is_convertible.hpp>
@@ -45,10 +48,14 @@
 #include <boost/type_traits/is_same.hpp>
 #include <boost/type_traits/make_void.hpp>
 #include <boost/type_traits/remove_const.hpp>
+#include <boost/type_traits/remove_cv.hpp>
+#include <boost/type_traits/remove_reference.hpp>
 #include <boost/unordered/detail/fwd.hpp>
+#include <boost/unordered/hash_traits.hpp>
 #include <boost/utility/addressof.hpp>
 #include <boost/utility/enable_if.hpp>
 #include <cmath>
+#include <ctime>
 #include <iterator>
 #include <stdexcept>
 #include <utility>
@@ -186,6 +193,120 @@
 #define BOOST_UNORDERED_TEMPLATE_DEDUCTION_GUIDES 0
 #endif
 
+// BOOST_UNORDERED_LARGE_BUCKET_THRESHOLD
+//
+// Size in bytes from which bucket arrays allocated with std::allocator are
+// mapped directly from the operating system, using transparent huge pages.
+// Define to 0 to always use the allocator.
+
+#if !defined(BOOST_UNORDERED_LARGE_BUCKET_THRESHOLD)
+#define BOOST_UNORDERED_LARGE_BUCKET_THRESHOLD (std::size_t(1) << 24)
+#endif
+
+// BOOST_UNORDERED_MMAP_BUCKETS
+//
+// Set to 1 when large bucket arrays can be mapped directly.
+
+#if !defined(BOOST_UNORDERED_MMAP_BUCKETS)
+#if BOOST_OS_LINUX
+#define BOOST_UNORDERED_MMAP_BUCKETS 1
+#else
+#define BOOST_UNORDERED_MMAP_BUCKETS 0
+#endif
+#endif
+
+#if BOOST_UNORDERED_MMAP_BUCKETS
+#include <memory>
+#include <new>
+#include <sys/mman.h>
+#endif
+
+// BOOST_UNORDERED_PREFETCH
+//
+// Prefetch the next node when walking the node list, so that the cache miss
+// overlaps with work on the current node. On by default for x86 and x64,
+// where it has been measured. Define to 1 to enable on other targets, or to
+// 0 to disable.
+
+#if !defined(BOOST_UNORDERED_PREFETCH)
+#if defined(BOOST_MSVC) && (defined(_M_IX86) || defined(_M_X64))
+#define BOOST_UNORDERED_PREFETCH 1
+#elif defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+#define BOOST_UNORDERED_PREFETCH 1
+#else
+#define BOOST_UNORDERED_PREFETCH 0
+#endif
+#endif
+
+#if BOOST_UNORDERED_PREFETCH && defined(BOOST_MSVC)
+#include <xmmintrin.h>
+#endif
+
+#if defined(BOOST_MSVC) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+// BOOST_UNORDERED_PARALLEL
+//
+// Set to 1 when the standard library has threads, which are used by the
+// parallel algorithms.
+
+#if !defined(BOOST_UNORDERED_PARALLEL)
+#if !defined(BOOST_NO_CXX11_HDR_THREAD) &&                                     \
+  !defined(BOOST_NO_CXX11_HDR_EXCEPTION) && !defined(BOOST_NO_CXX11_LAMBDAS)
+#define BOOST_UNORDERED_PARALLEL 1
+#else
+#define BOOST_UNORDERED_PARALLEL 0
+#endif
+#endif
+
+#if BOOST_UNORDERED_PARALLEL
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <thread>
+#include <vector>
+#endif
+
+// BOOST_UNORDERED_GROUP_HASH
+//
+// Set to 1 when it can be detected whether std::hash is enabled for a type,
+// which relies on C++17 requiring disabled specializations to be unusable.
+// The equality operators of the equivalent key containers then compare large
+// groups of elements by hashing their values, rather than by counting the
+// matches for each one.
+
+#if !defined(BOOST_UNORDERED_GROUP_HASH)
+#if !defined(BOOST_NO_CXX17_HDR_OPTIONAL) && !defined(BOOST_NO_SFINAE_EXPR) && \
+  !defined(BOOST_NO_CXX11_DECLTYPE)
+#define BOOST_UNORDERED_GROUP_HASH 1
+#else
+#define BOOST_UNORDERED_GROUP_HASH 0
+#endif
+#endif
+
+#if BOOST_UNORDERED_GROUP_HASH
+#include <functional>
+#endif
+
+// BOOST_UNORDERED_CONCURRENT
+//
+// Set to 1 when the compiler and standard library have what's needed for
+// the concurrent containers: atomics, mutexes, thread local storage and
+// variadic templates.
+
+#if !defined(BOOST_UNORDERED_CONCURRENT)
+#if !defined(BOOST_NO_CXX11_HDR_ATOMIC) &&                                     \
+  !defined(BOOST_NO_CXX11_HDR_MUTEX) && !defined(BOOST_NO_CXX11_HDR_THREAD) && \
+  !defined(BOOST_NO_CXX11_THREAD_LOCAL) &&                                     \
+  !defined(BOOST_NO_CXX11_VARIADIC_TEMPLATES) &&                               \
+  !defined(BOOST_NO_CXX11_RVALUE_REFERENCES)
+#define BOOST_UNORDERED_CONCURRENT 1
+#else
+#define BOOST_UNORDERED_CONCURRENT 0
+#endif
+#endif
+
 namespace boost {
   namespace unordered {
     namespace iterator_detail {
@@ -205,8 +326,8 @@ namespace boost {
       template <typename NodePointer> struct bucket;
       struct ptr_bucket;
 
-      template <typename A, typename T> struct node;
-      template <typename T> struct ptr_node;
+      template <typename A, typename T, bool BackLinks = false> struct node;
+      template <typename T, bool BackLinks = false> struct ptr_node;
 
       static const float minimum_max_load_factor = 1e-3f;
       static const std::size_t default_bucket_count = 11;
@@ -229,6 +350,23 @@ namespace boost {
         template <class T> inline void ignore_unused_variable_warning(T const&)
         {
         }
+
+        // Hint that the object that 'p' points to will be accessed soon.
+        // Does nothing for null pointers.
+        template <class Pointer> inline void prefetch(Pointer const& p)
+        {
+#if BOOST_UNORDERED_PREFETCH
+          if (p) {
+#if defined(BOOST_MSVC)
+            _mm_prefetch((char const*)boost::to_address(p), _MM_HINT_T0);
+#else
+            __builtin_prefetch(boost::to_address(p));
+#endif
+          }
+#else
+          ignore_unused_variable_warning(p);
+#endif
+        }
       }
 
       //////////////////////////////////////////////////////////////////////////
@@ -253,6 +391,75 @@ namespace boost {
             ReturnType>
       {
       };
+
+#if BOOST_UNORDERED_PARALLEL
+      //////////////////////////////////////////////////////////////////////////
+      // Parallel execution
+
+      // The smallest number of elements that's worth giving to a thread.
+      static const std::size_t parallel_min_elements = 4096;
+
+      template <class F>
+      inline void run_and_catch(
+        F const& f, std::size_t i, std::exception_ptr& error)
+      {
+        BOOST_TRY { f(i); }
+        BOOST_CATCH(...) { error = std::current_exception(); }
+        BOOST_CATCH_END
+      }
+
+      // Calls f(0), ..., f(n - 1), each on its own thread apart from f(0),
+      // which is called on the current thread. Waits for all of them to
+      // finish and returns the first exception thrown, if any. If a thread
+      // can't be started, the remaining calls are made on the current thread.
+
+      template <class F>
+      std::exception_ptr run_in_parallel(std::size_t n, F const& f)
+      {
+        std::vector<std::exception_ptr> errors(n);
+        std::vector<std::thread> threads;
+        std::size_t started = 1;
+
+        BOOST_TRY
+        {
+          threads.reserve(n - 1);
+          for (; started < n; ++started) {
+            std::exception_ptr* error = &errors[started];
+            std::size_t const i = started;
+            threads.push_back(
+              std::thread([&f, error, i] { run_and_catch(f, i, *error); }));
+          }
+        }
+        BOOST_CATCH(...) {}
+        BOOST_CATCH_END
+
+        run_and_catch(f, 0, errors[0]);
+        for (std::size_t i = started; i < n; ++i) {
+          run_and_catch(f, i, errors[i]);
+        }
+        for (std::size_t i = 0; i < threads.size(); ++i) {
+          threads[i].join();
+        }
+
+        for (std::size_t i = 0; i < n; ++i) {
+          if (errors[i]) {
+            return errors[i];
+          }
+        }
+        return std::exception_ptr();
+      }
+
+      // Number of threads to use for 'n' elements, when 'num_threads' were
+      // requested. 0 requests one for each hardware thread.
+      inline std::size_t parallel_thread_count(
+        std::size_t num_threads, std::size_t n)
+      {
+        if (!num_threads) {
+          num_threads = std::thread::hardware_concurrency();
+        }
+        return (std::min)(num_threads, n / parallel_min_elements);
+      }
+#endif
     }
   }
 }
@@ -274,10 +481,41 @@ namespace boost {
 namespace boost {
   namespace unordered {
     namespace detail {
+      // An unsigned type twice as wide as std::size_t, if there is one, for
+      // computing remainders with multiplications instead of a division.
+
+      template <int digits> struct prime_fmod_traits
+      {
+        static bool const enabled = false;
+        typedef std::size_t wide_type;
+      };
+
+      template <> struct prime_fmod_traits<32>
+      {
+        static bool const enabled = true;
+        typedef boost::uint64_t wide_type;
+      };
+
+#if defined(BOOST_HAS_INT128)
+      template <> struct prime_fmod_traits<64>
+      {
+        static bool const enabled = true;
+        typedef boost::uint128_type wide_type;
+      };
+#endif
+
+      typedef prime_fmod_traits<std::numeric_limits<std::size_t>::digits>
+        prime_fmod;
+
       template <class T> struct prime_list_template
       {
+        typedef prime_fmod::wide_type wide_type;
+
         static std::size_t const value[];
 
+        // ceil(2^(2 * digits) / value[i]), for prime_modulo.
+        static wide_type const inverse[];
+
 #if !BOOST_UNORDERED_SUN_WORKAROUNDS1
         static std::ptrdiff_t const length;
 #else
@@ -290,6 +528,17 @@ namespace boost {
       std::size_t const prime_list_template<T>::value[] = {
         BOOST_PP_SEQ_ENUM(BOOST_UNORDERED_PRIMES)};
 
+#define BOOST_UNORDERED_PRIME_INVERSE(s, data, prime)                          \
+  ~wide_type(0) / prime + 1
+
+      template <class T>
+      typename prime_list_template<T>::wide_type const
+        prime_list_template<T>::inverse[] = {
+          BOOST_PP_SEQ_ENUM(BOOST_PP_SEQ_TRANSFORM(
+            BOOST_UNORDERED_PRIME_INVERSE, _, BOOST_UNORDERED_PRIMES))};
+
+#undef BOOST_UNORDERED_PRIME_INVERSE
+
 #if !BOOST_UNORDERED_SUN_WORKAROUNDS1
       template <class T>
       std::ptrdiff_t const prime_list_template<T>::length = BOOST_PP_SEQ_SIZE(
@@ -313,6 +562,58 @@ namespace boost {
         return *bound;
       }
 
+      // 'hash % prime_list::value[index]'. A hardware division takes tens of
+      // cycles on many processors, so when there's a wide enough type this
+      // computes the remainder directly from the precomputed inverse, as
+      // described in Lemire, Kaser and Kurz, "Faster Remainder by Direct
+      // Computation". That's exact for any hash value.
+
+      template <class Traits, bool Enabled = Traits::enabled>
+      struct prime_modulo_impl
+      {
+        static std::size_t apply(std::size_t hash, int index)
+        {
+          return hash % prime_list::value[index];
+        }
+      };
+
+      template <class Traits> struct prime_modulo_impl<Traits, true>
+      {
+        static std::size_t apply(std::size_t hash, int index)
+        {
+          typedef typename Traits::wide_type wide_type;
+          int const half = std::numeric_limits<std::size_t>::digits;
+
+          wide_type const low_bits = prime_list::inverse[index] * hash;
+          wide_type const prime = prime_list::value[index];
+          wide_type const mask = (std::numeric_limits<std::size_t>::max)();
+
+          return static_cast<std::size_t>(
+            ((((low_bits & mask) * prime) >> half) +
+              (low_bits >> half) * prime) >>
+            half);
+        }
+      };
+
+      inline std::size_t prime_modulo(std::size_t hash, int index)
+      {
+        return prime_modulo_impl<prime_fmod>::apply(hash, index);
+      }
+
+      // The position of 'num' in the prime list, or -1 if it isn't there.
+      // no throw
+      inline int prime_index(std::size_t num)
+      {
+        std::size_t const* const prime_list_begin = prime_list::value;
+        std::size_t const* const prime_list_end =
+          prime_list_begin + prime_list::length;
+        std::size_t const* bound =
+          std::lower_bound(prime_list_begin, prime_list_end, num);
+        if (bound == prime_list_end || *bound != num)
+          return -1;
+        return static_cast<int>(bound - prime_list_begin);
+      }
+
       // no throw
       inline std::size_t prev_prime(std::size_t num)
       {
@@ -733,6 +1034,43 @@ namespace boost {
           !boost::is_convertible<Key, const_iterator>::value;
       };
 
+#if BOOST_UNORDERED_GROUP_HASH
+////////////////////////////////////////////////////////////////////////////
+// Hashing the values of a group of equivalent elements
+//
+// The elements of a group have equivalent keys, so only the mapped values of
+// a map's elements are hashed.
+
+      template <class, class = void> struct is_std_hashable : public false_type
+      {
+      };
+
+      template <class T>
+      struct is_std_hashable<T,
+        typename boost::make_void<decltype(
+          std::hash<T>()(std::declval<T const&>()))>::type> : public true_type
+      {
+      };
+
+      template <class T> struct group_value_hash
+      {
+        typedef T hashed_type;
+
+        std::size_t operator()(T const& x) const { return std::hash<T>()(x); }
+      };
+
+      template <class K, class M>
+      struct group_value_hash<std::pair<K const, M> >
+      {
+        typedef M hashed_type;
+
+        std::size_t operator()(std::pair<K const, M> const& x) const
+        {
+          return std::hash<M>()(x.second);
+        }
+      };
+#endif
+
 ////////////////////////////////////////////////////////////////////////////
 // Explicitly call a destructor
 
@@ -1311,6 +1649,25 @@ namespace boost {
       //
       // Node construction
 
+      // A node allocator paired with a list of spare nodes that were
+      // allocated ahead of time (see table::reserve_nodes). Spare nodes are
+      // default constructed and linked through their next_ pointers.
+
+      template <typename NodeAlloc> struct node_source
+      {
+        typedef NodeAlloc node_allocator;
+        typedef typename boost::unordered::detail::allocator_traits<
+          NodeAlloc>::pointer node_pointer;
+
+        node_allocator& alloc_;
+        node_pointer& spare_;
+
+        node_source(node_allocator& a, node_pointer& spare)
+            : alloc_(a), spare_(spare)
+        {
+        }
+      };
+
       template <typename NodeAlloc> struct node_constructor
       {
         typedef NodeAlloc node_allocator;
@@ -1322,8 +1679,14 @@ namespace boost {
 
         node_allocator& alloc_;
         node_pointer node_;
+        node_pointer* spare_;
+
+        node_constructor(node_allocator& n) : alloc_(n), node_(), spare_() {}
 
-        node_constructor(node_allocator& n) : alloc_(n), node_() {}
+        explicit node_constructor(node_source<NodeAlloc> const& s)
+            : alloc_(s.alloc_), node_(), spare_(boost::addressof(s.spare_))
+        {
+        }
 
         ~node_constructor();
 
@@ -1362,6 +1725,12 @@ namespace boost {
       template <typename Alloc> void node_constructor<Alloc>::create_node()
       {
         BOOST_ASSERT(!node_);
+        if (spare_ && *spare_) {
+          node_ = *spare_;
+          *spare_ = static_cast<node_pointer>(node_->next_);
+          node_->next_ = typename node::link_pointer();
+          return;
+        }
         node_ = node_allocator_traits::allocate(alloc_, 1);
         new ((void*)boost::to_address(node_)) node();
       }
@@ -1413,9 +1782,11 @@ namespace boost {
         template <typename Alloc, BOOST_UNORDERED_EMPLACE_TEMPLATE>
         inline
           typename boost::unordered::detail::allocator_traits<Alloc>::pointer
-          construct_node_from_args(Alloc& alloc, BOOST_UNORDERED_EMPLACE_ARGS)
+          construct_node_from_args(
+            node_source<Alloc> const& src, BOOST_UNORDERED_EMPLACE_ARGS)
         {
-          node_constructor<Alloc> a(alloc);
+          Alloc& alloc = src.alloc_;
+          node_constructor<Alloc> a(src);
           a.create_node();
           construct_from_args(
             alloc, a.node_->value_ptr(), BOOST_UNORDERED_EMPLACE_FORWARD);
@@ -1425,12 +1796,12 @@ namespace boost {
         template <typename Alloc, typename U>
         inline
           typename boost::unordered::detail::allocator_traits<Alloc>::pointer
-          construct_node(Alloc& alloc, BOOST_FWD_REF(U) x)
+          construct_node(node_source<Alloc> const& src, BOOST_FWD_REF(U) x)
         {
-          node_constructor<Alloc> a(alloc);
+          node_constructor<Alloc> a(src);
           a.create_node();
           BOOST_UNORDERED_CALL_CONSTRUCT1(
-            boost::unordered::detail::allocator_traits<Alloc>, alloc,
+            boost::unordered::detail::allocator_traits<Alloc>, src.alloc_,
             a.node_->value_ptr(), boost::forward<U>(x));
           return a.release();
         }
@@ -1440,9 +1811,10 @@ namespace boost {
         template <typename Alloc, typename Key>
         inline
           typename boost::unordered::detail::allocator_traits<Alloc>::pointer
-          construct_node_pair(Alloc& alloc, BOOST_FWD_REF(Key) k)
+          construct_node_pair(node_source<Alloc> const& src, BOOST_FWD_REF(Key) k)
         {
-          node_constructor<Alloc> a(alloc);
+          Alloc& alloc = src.alloc_;
+          node_constructor<Alloc> a(src);
           a.create_node();
           boost::unordered::detail::allocator_traits<Alloc>::construct(alloc,
             a.node_->value_ptr(), std::piecewise_construct,
@@ -1455,9 +1827,10 @@ namespace boost {
         inline
           typename boost::unordered::detail::allocator_traits<Alloc>::pointer
           construct_node_pair(
-            Alloc& alloc, BOOST_FWD_REF(Key) k, BOOST_FWD_REF(Mapped) m)
+            node_source<Alloc> const& src, BOOST_FWD_REF(Key) k, BOOST_FWD_REF(Mapped) m)
         {
-          node_constructor<Alloc> a(alloc);
+          Alloc& alloc = src.alloc_;
+          node_constructor<Alloc> a(src);
           a.create_node();
           boost::unordered::detail::allocator_traits<Alloc>::construct(alloc,
             a.node_->value_ptr(), std::piecewise_construct,
@@ -1470,9 +1843,10 @@ namespace boost {
         inline
           typename boost::unordered::detail::allocator_traits<Alloc>::pointer
           construct_node_pair_from_args(
-            Alloc& alloc, BOOST_FWD_REF(Key) k, BOOST_FWD_REF(Args)... args)
+            node_source<Alloc> const& src, BOOST_FWD_REF(Key) k, BOOST_FWD_REF(Args)... args)
         {
-          node_constructor<Alloc> a(alloc);
+          Alloc& alloc = src.alloc_;
+          node_constructor<Alloc> a(src);
           a.create_node();
 #if !(BOOST_COMP_CLANG && BOOST_COMP_CLANG < BOOST_VERSION_NUMBER(3, 8, 0) &&  \
       defined(BOOST_LIBSTDCXX11))
@@ -1498,9 +1872,9 @@ namespace boost {
         template <typename Alloc, typename Key>
         inline
           typename boost::unordered::detail::allocator_traits<Alloc>::pointer
-          construct_node_pair(Alloc& alloc, BOOST_FWD_REF(Key) k)
+          construct_node_pair(node_source<Alloc> const& src, BOOST_FWD_REF(Key) k)
         {
-          node_constructor<Alloc> a(alloc);
+          node_constructor<Alloc> a(src);
           a.create_node();
           boost::unordered::detail::func::construct_value(
             boost::addressof(a.node_->value_ptr()->first),
@@ -1524,9 +1898,9 @@ namespace boost {
         inline
           typename boost::unordered::detail::allocator_traits<Alloc>::pointer
           construct_node_pair(
-            Alloc& alloc, BOOST_FWD_REF(Key) k, BOOST_FWD_REF(Mapped) m)
+            node_source<Alloc> const& src, BOOST_FWD_REF(Key) k, BOOST_FWD_REF(Mapped) m)
         {
-          node_constructor<Alloc> a(alloc);
+          node_constructor<Alloc> a(src);
           a.create_node();
           boost::unordered::detail::func::construct_value(
             boost::addressof(a.node_->value_ptr()->first),
@@ -1552,9 +1926,10 @@ namespace boost {
         inline
           typename boost::unordered::detail::allocator_traits<Alloc>::pointer
           construct_node_pair_from_args(
-            Alloc& alloc, BOOST_FWD_REF(Key) k, BOOST_UNORDERED_EMPLACE_ARGS)
+            node_source<Alloc> const& src, BOOST_FWD_REF(Key) k, BOOST_UNORDERED_EMPLACE_ARGS)
         {
-          node_constructor<Alloc> a(alloc);
+          Alloc& alloc = src.alloc_;
+          node_constructor<Alloc> a(src);
           a.create_node();
           boost::unordered::detail::func::construct_value(
             boost::addressof(a.node_->value_ptr()->first),
@@ -1759,13 +2134,16 @@ namespace boost {
         iterator& operator++()
         {
           node_ = static_cast<node_pointer>(node_->next_);
+          if (node_) {
+            boost::unordered::detail::func::prefetch(node_->next_);
+          }
           return *this;
         }
 
         iterator operator++(int)
         {
           iterator tmp(node_);
-          node_ = static_cast<node_pointer>(node_->next_);
+          ++(*this);
           return tmp;
         }
 
@@ -1817,13 +2195,16 @@ namespace boost {
         c_iterator& operator++()
         {
           node_ = static_cast<node_pointer>(node_->next_);
+          if (node_) {
+            boost::unordered::detail::func::prefetch(node_->next_);
+          }
           return *this;
         }
 
         c_iterator operator++(int)
         {
           c_iterator tmp(node_);
-          node_ = static_cast<node_pointer>(node_->next_);
+          ++(*this);
           return tmp;
         }
 
@@ -1969,130 +2350,643 @@ namespace boost {
 
       ///////////////////////////////////////////////////////////////////
       //
-      // Hash Policy
+      // Bucket allocation
+      //
+      // Allocates the memory for a bucket array, and reports whether the
+      // buckets in it are already initialised as empty. By default the
+      // bucket allocator is used and the buckets have to be constructed.
 
-      template <typename SizeT> struct prime_policy
+      template <typename BucketAlloc> struct bucket_allocation
       {
-        template <typename Hash, typename T>
-        static inline SizeT apply_hash(Hash const& hf, T const& x)
-        {
-          return hf(x);
-        }
+        typedef boost::unordered::detail::allocator_traits<BucketAlloc>
+          bucket_allocator_traits;
+        typedef typename bucket_allocator_traits::pointer bucket_pointer;
 
-        static inline SizeT to_bucket(SizeT bucket_count, SizeT hash, int /*bcount_log2*/)
-        {
-          return hash % bucket_count;
-        }
+        static bool zero_initialized(std::size_t) { return false; }
 
-        static inline SizeT new_bucket_count(SizeT min)
+        static bucket_pointer allocate(BucketAlloc& a, std::size_t n)
         {
-          return boost::unordered::detail::next_prime(min);
+          return bucket_allocator_traits::allocate(a, n);
         }
 
-        static inline SizeT prev_bucket_count(SizeT max)
+        static void deallocate(BucketAlloc& a, bucket_pointer p, std::size_t n)
         {
-          return boost::unordered::detail::prev_prime(max);
+          bucket_allocator_traits::deallocate(a, p, n);
         }
       };
 
-      template <typename SizeT> struct mix64_policy
-      {
-        template <typename Hash, typename T>
-        static inline SizeT apply_hash(Hash const& hf, T const& x)
-        {
-          // https://en.wikipedia.org/wiki/Hash_function#Fibonacci_hashing
-          // SizeT const m = 11400714819323198485ull; // 2^64 / phi
-          SizeT const m = ( SizeT(0x9e3779b9u) << 32 ) + 0x7f4a7c15u;
-          return hf(x) * m;
-        }
-
-        static inline SizeT to_bucket(SizeT bucket_count, SizeT hash, int bcount_log2)
-        {
-          BOOST_ASSERT( bucket_count == ( SizeT(1) << bcount_log2 ) );
-          (void)bucket_count;
-
-          SizeT r = hash >> (64 - bcount_log2);
+#if BOOST_UNORDERED_MMAP_BUCKETS
 
-          BOOST_ASSERT( r < bucket_count );
+      // Large arrays of ptr_bucket from std::allocator are mapped directly,
+      // aligned to, and advised to use, transparent huge pages. This cuts
+      // down on TLB misses for random lookups in big tables. Fresh anonymous
+      // pages are zero filled, which is an empty ptr_bucket, so they don't
+      // need to be written before use.
+      //
+      // Whether an array is mapped only depends on its size, so deallocate
+      // can tell how it was allocated.
 
-          return r;
-        }
+      template <> struct bucket_allocation<std::allocator<ptr_bucket> >
+      {
+        typedef std::allocator<ptr_bucket> bucket_allocator;
+        typedef ptr_bucket* bucket_pointer;
 
-        static inline SizeT new_bucket_count(SizeT min)
-        {
-          if (min <= 4)
-            return 4;
-          return boost::core::bit_ceil(min);
-        }
+        static const std::size_t huge_page_size = std::size_t(1) << 21;
 
-        static inline SizeT prev_bucket_count(SizeT max)
+        static bool zero_initialized(std::size_t n)
         {
-          return boost::core::bit_floor(max);
+          return BOOST_UNORDERED_LARGE_BUCKET_THRESHOLD != 0 &&
+                 n >= BOOST_UNORDERED_LARGE_BUCKET_THRESHOLD /
+                        sizeof(ptr_bucket) &&
+                 n <= (std::numeric_limits<std::size_t>::max)() /
+                          sizeof(ptr_bucket) -
+                        huge_page_size;
         }
-      };
 
-      template <typename SizeT> struct mix32_policy
-      {
-        template <typename Hash, typename T>
-        static inline SizeT apply_hash(Hash const& hf, T const& x)
+        static std::size_t mapped_size(std::size_t n)
         {
-          // https://en.wikipedia.org/wiki/Hash_function#Fibonacci_hashing
-          SizeT const m = 2654435769u; // 2^32 / phi
-          return hf(x) * m;
+          return (n * sizeof(ptr_bucket) + huge_page_size - 1) &
+                 ~(huge_page_size - 1);
         }
 
-        static inline SizeT to_bucket(SizeT bucket_count, SizeT hash, int bcount_log2)
+        static bucket_pointer allocate(bucket_allocator& a, std::size_t n)
         {
-          BOOST_ASSERT( bucket_count == ( SizeT(1) << bcount_log2 ) );
-          (void)bucket_count;
+          if (!zero_initialized(n)) {
+            return a.allocate(n);
+          }
 
-          SizeT r = hash >> (32 - bcount_log2);
+          // Map an extra huge page, so that the array can be aligned to one.
+          std::size_t size = mapped_size(n);
+          void* p = ::mmap(0, size + huge_page_size, PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+          if (p == MAP_FAILED) {
+            boost::throw_exception(std::bad_alloc());
+          }
 
-          BOOST_ASSERT( r < bucket_count );
+          char* begin = static_cast<char*>(p);
+          char* aligned = reinterpret_cast<char*>(
+            (reinterpret_cast<boost::uintptr_t>(begin) + huge_page_size - 1) &
+            ~static_cast<boost::uintptr_t>(huge_page_size - 1));
+          if (aligned != begin) {
+            ::munmap(begin, static_cast<std::size_t>(aligned - begin));
+          }
+          std::size_t tail = huge_page_size -
+                             static_cast<std::size_t>(aligned - begin);
+          if (tail) {
+            ::munmap(aligned + size, tail);
+          }
 
-          return r;
-        }
+#if defined(MADV_HUGEPAGE)
+          ::madvise(aligned, size, MADV_HUGEPAGE);
+#endif
 
-        static inline SizeT new_bucket_count(SizeT min)
-        {
-          if (min <= 4)
-            return 4;
-          return boost::core::bit_ceil(min);
+          return static_cast<bucket_pointer>(static_cast<void*>(aligned));
         }
 
-        static inline SizeT prev_bucket_count(SizeT max)
+        static void deallocate(
+          bucket_allocator& a, bucket_pointer p, std::size_t n)
         {
-          return boost::core::bit_floor(max);
+          if (!zero_initialized(n)) {
+            a.deallocate(p, n);
+          } else {
+            ::munmap(static_cast<void*>(p), mapped_size(n));
+          }
         }
       };
 
-      template <int digits, int radix> struct pick_policy_impl
-      {
-        typedef prime_policy<std::size_t> type;
-      };
+#endif
 
-      template <> struct pick_policy_impl<64, 2>
-      {
-        typedef mix64_policy<std::size_t> type;
-      };
+      ///////////////////////////////////////////////////////////////////
+      //
+      // Released storage
+      //
+      // Owns the nodes and bucket array taken from a container by
+      // release_storage, so that they can be destroyed later. That can be
+      // done on another thread, or a few elements at a time.
 
-      template <> struct pick_policy_impl<32, 2>
+      template <typename Types> class released_storage
       {
-        typedef mix32_policy<std::size_t> type;
-      };
+        BOOST_MOVABLE_BUT_NOT_COPYABLE(released_storage)
 
-      template <typename T>
-      struct pick_policy2
+        template <typename> friend struct table;
+
+        typedef typename Types::node node;
+        typedef typename Types::bucket bucket;
+        typedef typename Types::value_allocator value_allocator;
+        typedef typename boost::unordered::detail::rebind_wrap<value_allocator,
+          node>::type node_allocator;
+        typedef typename boost::unordered::detail::rebind_wrap<value_allocator,
+          bucket>::type bucket_allocator;
+        typedef boost::unordered::detail::allocator_traits<node_allocator>
+          node_allocator_traits;
+        typedef boost::unordered::detail::allocator_traits<bucket_allocator>
+          bucket_allocator_traits;
+        typedef typename node_allocator_traits::pointer node_pointer;
+        typedef typename bucket_allocator_traits::pointer bucket_pointer;
+        typedef boost::unordered::detail::bucket_allocation<bucket_allocator>
+          bucket_allocation;
+
+        boost::unordered::detail::optional<node_allocator> alloc_;
+        bucket_pointer buckets_;
+        std::size_t bucket_count_;
+        node_pointer dummy_;
+        node_pointer nodes_;
+        std::size_t size_;
+
+        // 'buckets' has 'bucket_count' + 1 elements, the last one starts the
+        // list of nodes.
+        released_storage(node_allocator const& a, bucket_pointer buckets,
+          std::size_t bucket_count, std::size_t size)
+            : alloc_(a), buckets_(buckets), bucket_count_(bucket_count),
+              dummy_(), nodes_(), size_(size)
+        {
+          if (buckets_) {
+            nodes_ = static_cast<node_pointer>(
+              (buckets_ + static_cast<std::ptrdiff_t>(bucket_count_))->next_);
+            if (bucket::extra_node) {
+              dummy_ = nodes_;
+              nodes_ = static_cast<node_pointer>(dummy_->next_);
+            }
+          }
+        }
+
+        void take(released_storage& x) BOOST_NOEXCEPT
+        {
+          buckets_ = x.buckets_;
+          bucket_count_ = x.bucket_count_;
+          dummy_ = x.dummy_;
+          nodes_ = x.nodes_;
+          size_ = x.size_;
+
+          x.buckets_ = bucket_pointer();
+          x.bucket_count_ = 0;
+          x.dummy_ = node_pointer();
+          x.nodes_ = node_pointer();
+          x.size_ = 0;
+        }
+
+      public:
+        released_storage() BOOST_NOEXCEPT : alloc_(),
+                                            buckets_(),
+                                            bucket_count_(0),
+                                            dummy_(),
+                                            nodes_(),
+                                            size_(0)
+        {
+        }
+
+        released_storage(BOOST_RV_REF(released_storage) x) BOOST_NOEXCEPT
+          : alloc_(boost::move(x.alloc_))
+        {
+          take(x);
+        }
+
+        released_storage& operator=(BOOST_RV_REF(released_storage) x)
+        {
+          if (this != &x) {
+            destroy();
+            alloc_ = boost::move(x.alloc_);
+            take(x);
+          }
+          return *this;
+        }
+
+        ~released_storage() { destroy(); }
+
+        // True when there's nothing left to destroy.
+        bool empty() const BOOST_NOEXCEPT { return !buckets_; }
+
+        // The number of elements that haven't been destroyed yet.
+        std::size_t size() const BOOST_NOEXCEPT { return size_; }
+
+        void destroy()
+        {
+          while (!destroy_some(size_)) {
+          }
+        }
+
+        // Destroys up to 'max_elements' elements, and then the bucket array
+        // once they're all gone. Returns true when everything has been
+        // destroyed.
+        bool destroy_some(std::size_t max_elements)
+        {
+          if (!buckets_) {
+            return true;
+          }
+
+          node_allocator& a = *alloc_;
+          for (; nodes_ && max_elements; --max_elements) {
+            node_pointer n = nodes_;
+            nodes_ = static_cast<node_pointer>(n->next_);
+            BOOST_UNORDERED_CALL_DESTROY(
+              node_allocator_traits, a, n->value_ptr());
+            boost::unordered::detail::func::destroy(boost::to_address(n));
+            node_allocator_traits::deallocate(a, n, 1);
+            --size_;
+          }
+
+          if (nodes_) {
+            return false;
+          }
+
+          if (dummy_) {
+            boost::unordered::detail::func::destroy(boost::to_address(dummy_));
+            node_allocator_traits::deallocate(a, dummy_, 1);
+            dummy_ = node_pointer();
+          }
+
+          bucket_pointer end =
+            buckets_ + static_cast<std::ptrdiff_t>(bucket_count_ + 1);
+          for (bucket_pointer it = buckets_; it != end; ++it) {
+            boost::unordered::detail::func::destroy(boost::to_address(it));
+          }
+
+          bucket_allocator bucket_alloc(a);
+          bucket_allocation::deallocate(
+            bucket_alloc, buckets_, bucket_count_ + 1);
+          buckets_ = bucket_pointer();
+          bucket_count_ = 0;
+          return true;
+        }
+      };
+
+      ///////////////////////////////////////////////////////////////////
+      //
+      // Hash Policy
+
+      template <typename SizeT> struct prime_policy
+      {
+        template <typename Hash, typename T>
+        static inline SizeT apply_hash(Hash const& hf, T const& x)
+        {
+          return hf(x);
+        }
+
+        // The bucket count's position in the prime list, which selects the
+        // precomputed inverse used by prime_modulo.
+        static inline int size_index(SizeT bucket_count)
+        {
+          return boost::unordered::detail::prime_index(bucket_count);
+        }
+
+        static inline SizeT to_bucket(SizeT bucket_count, SizeT hash, int size_index)
+        {
+          BOOST_ASSERT( size_index >= 0 );
+          BOOST_ASSERT( bucket_count == prime_list::value[size_index] );
+          (void)bucket_count;
+
+          return boost::unordered::detail::prime_modulo(hash, size_index);
+        }
+
+        static inline SizeT new_bucket_count(SizeT min)
+        {
+          return boost::unordered::detail::next_prime(min);
+        }
+
+        static inline SizeT prev_bucket_count(SizeT max)
+        {
+          return boost::unordered::detail::prev_prime(max);
+        }
+      };
+
+      template <typename SizeT> struct mix64_policy
+      {
+        template <typename Hash, typename T>
+        static inline SizeT apply_hash(Hash const& hf, T const& x)
+        {
+          // https://en.wikipedia.org/wiki/Hash_function#Fibonacci_hashing
+          // SizeT const m = 11400714819323198485ull; // 2^64 / phi
+          SizeT const m = ( SizeT(0x9e3779b9u) << 32 ) + 0x7f4a7c15u;
+          return hf(x) * m;
+        }
+
+        static inline SizeT to_bucket(SizeT bucket_count, SizeT hash, int bcount_log2)
+        {
+          BOOST_ASSERT( bucket_count == ( SizeT(1) << bcount_log2 ) );
+          (void)bucket_count;
+
+          SizeT r = hash >> (64 - bcount_log2);
+
+          BOOST_ASSERT( r < bucket_count );
+
+          return r;
+        }
+
+        static inline int size_index(SizeT bucket_count)
+        {
+          return static_cast<int>( boost::core::bit_width( bucket_count ) ) - 1;
+        }
+
+        static inline SizeT new_bucket_count(SizeT min)
+        {
+          if (min <= 4)
+            return 4;
+          return boost::core::bit_ceil(min);
+        }
+
+        static inline SizeT prev_bucket_count(SizeT max)
+        {
+          return boost::core::bit_floor(max);
+        }
+      };
+
+      template <typename SizeT> struct mix32_policy
+      {
+        template <typename Hash, typename T>
+        static inline SizeT apply_hash(Hash const& hf, T const& x)
+        {
+          // https://en.wikipedia.org/wiki/Hash_function#Fibonacci_hashing
+          SizeT const m = 2654435769u; // 2^32 / phi
+          return hf(x) * m;
+        }
+
+        static inline SizeT to_bucket(SizeT bucket_count, SizeT hash, int bcount_log2)
+        {
+          BOOST_ASSERT( bucket_count == ( SizeT(1) << bcount_log2 ) );
+          (void)bucket_count;
+
+          SizeT r = hash >> (32 - bcount_log2);
+
+          BOOST_ASSERT( r < bucket_count );
+
+          return r;
+        }
+
+        static inline int size_index(SizeT bucket_count)
+        {
+          return static_cast<int>( boost::core::bit_width( bucket_count ) ) - 1;
+        }
+
+        static inline SizeT new_bucket_count(SizeT min)
+        {
+          if (min <= 4)
+            return 4;
+          return boost::core::bit_ceil(min);
+        }
+
+        static inline SizeT prev_bucket_count(SizeT max)
+        {
+          return boost::core::bit_floor(max);
+        }
+      };
+
+      // The high half of the 128 bit product of 'x' and 'y'.
+
+      inline boost::uint64_t mul_high64(boost::uint64_t x, boost::uint64_t y)
+      {
+#if defined(BOOST_HAS_INT128)
+        return static_cast<boost::uint64_t>(
+          (static_cast<boost::uint128_type>(x) * y) >> 64);
+#elif defined(BOOST_MSVC) && defined(_M_X64)
+        return __umulh(x, y);
+#else
+        boost::uint64_t const mask = 0xffffffffu;
+        boost::uint64_t x_lo = x & mask, x_hi = x >> 32;
+        boost::uint64_t y_lo = y & mask, y_hi = y >> 32;
+
+        boost::uint64_t lo_lo = x_lo * y_lo;
+        boost::uint64_t hi_lo = x_hi * y_lo;
+        boost::uint64_t lo_hi = x_lo * y_hi;
+        boost::uint64_t cross = (lo_lo >> 32) + (hi_lo & mask) + lo_hi;
+
+        return x_hi * y_hi + (hi_lo >> 32) + (cross >> 32);
+#endif
+      }
+
+      // The fastrange policies map the mixed hash value into any number of
+      // buckets, with the high half of its product with the bucket count.
+      // That's as cheap as a shift, but as the bucket count needn't be a
+      // power of two, the container can grow by 1.5x instead of doubling.
+
+      template <typename SizeT> struct fastrange64_policy : mix64_policy<SizeT>
+      {
+        static inline SizeT to_bucket(SizeT bucket_count, SizeT hash, int /*size_index*/)
+        {
+          SizeT r = static_cast<SizeT>(
+            boost::unordered::detail::mul_high64(hash, bucket_count));
+
+          BOOST_ASSERT( r < bucket_count );
+
+          return r;
+        }
+
+        static inline SizeT new_bucket_count(SizeT min)
+        {
+          return min <= 4 ? 4 : min;
+        }
+
+        static inline SizeT prev_bucket_count(SizeT max)
+        {
+          return max;
+        }
+      };
+
+      template <typename SizeT> struct fastrange32_policy : mix32_policy<SizeT>
+      {
+        static inline SizeT to_bucket(SizeT bucket_count, SizeT hash, int /*size_index*/)
+        {
+          SizeT r = static_cast<SizeT>(
+            (static_cast<boost::uint64_t>(hash) * bucket_count) >> 32);
+
+          BOOST_ASSERT( r < bucket_count );
+
+          return r;
+        }
+
+        static inline SizeT new_bucket_count(SizeT min)
+        {
+          return min <= 4 ? 4 : min;
+        }
+
+        static inline SizeT prev_bucket_count(SizeT max)
+        {
+          return max;
+        }
+      };
+
+      // Spreads the bits of a hash value over all 64 bits, for the
+      // structures that take bits from fixed positions of it, rather than
+      // reducing the whole value to a bucket.
+      inline boost::uint64_t mix_hash_bits(std::size_t hash)
+      {
+        boost::uint64_t h = static_cast<boost::uint64_t>(hash);
+        h ^= h >> 33;
+        h *= (boost::uint64_t(0xff51afd7u) << 32) + 0xed558ccdu;
+        h ^= h >> 33;
+        h *= (boost::uint64_t(0xc4ceb9feu) << 32) + 0x1a85ec53u;
+        h ^= h >> 33;
+        return h;
+      }
+
+      template <int digits, int radix> struct pick_policy_impl
+      {
+        typedef prime_policy<std::size_t> type;
+      };
+
+      template <> struct pick_policy_impl<64, 2>
+      {
+        typedef mix64_policy<std::size_t> type;
+      };
+
+      template <> struct pick_policy_impl<32, 2>
+      {
+        typedef mix32_policy<std::size_t> type;
+      };
+
+      template <typename T>
+      struct pick_policy2
         : pick_policy_impl<std::numeric_limits<std::size_t>::digits,
             std::numeric_limits<std::size_t>::radix>
       {
       };
 
+      template <int digits, int radix> struct pick_fastrange_policy_impl
+      {
+        typedef prime_policy<std::size_t> type;
+      };
+
+      template <> struct pick_fastrange_policy_impl<64, 2>
+      {
+        typedef fastrange64_policy<std::size_t> type;
+      };
+
+      template <> struct pick_fastrange_policy_impl<32, 2>
+      {
+        typedef fastrange32_policy<std::size_t> type;
+      };
+
+      // Maps the hash function's 'bucket_policy' to a policy. On platforms
+      // where size_t doesn't have 32 or 64 bits, every choice other than
+      // prime_buckets falls back to the default.
+
+      template <typename T, typename BucketPolicy>
+      struct pick_bucket_policy_impl : pick_policy2<T>
+      {
+      };
+
       template <typename T>
-      struct pick_policy : pick_policy2<typename boost::remove_cv<T>::type>
+      struct pick_bucket_policy_impl<T, boost::unordered::prime_buckets>
+      {
+        typedef prime_policy<std::size_t> type;
+      };
+
+      template <typename T>
+      struct pick_bucket_policy_impl<T, boost::unordered::fastrange_buckets>
+        : pick_fastrange_policy_impl<std::numeric_limits<std::size_t>::digits,
+            std::numeric_limits<std::size_t>::radix>
+      {
+      };
+
+      // When the hash function is avalanching, its result is used as is,
+      // only the mapping to buckets is kept from the underlying policy.
+
+      template <typename Policy> struct avalanching_policy : Policy
+      {
+        template <typename Hash, typename T>
+        static inline std::size_t apply_hash(Hash const& hf, T const& x)
+        {
+          return hf(x);
+        }
+      };
+
+      template <typename Policy, bool Avalanching>
+      struct pick_avalanching_policy
+      {
+        typedef Policy type;
+      };
+
+      template <typename Policy>
+      struct pick_avalanching_policy<Policy, true>
+      {
+        typedef avalanching_policy<Policy> type;
+      };
+
+      template <typename T, typename H>
+      struct pick_policy
+          : pick_avalanching_policy<
+              typename pick_policy2<typename boost::remove_cv<T>::type>::type,
+              boost::unordered::hash_is_avalanching<H>::value>
+      {
+      };
+
+      // With adaptive_collision_defence, the table passes its seed to
+      // apply_hash. It's 0 until the table finds a long chain, and the hash
+      // value is then mixed as by the underlying policy. Afterwards the hash
+      // value is mixed with the seed instead, by mix_hash_bits, which
+      // depends on all of its bits. That's slower, but a set of keys that
+      // collide for one seed needn't collide for another.
+
+      template <typename Policy> struct adaptive_policy : Policy
+      {
+        // Chains are allowed this many elements per unit of max load
+        // factor before the table is seeded.
+        BOOST_STATIC_CONSTANT(std::size_t, chain_limit = 16);
+
+        using Policy::apply_hash;
+
+        template <typename Hash, typename T>
+        static inline std::size_t apply_hash(
+          Hash const& hf, T const& x, std::size_t seed)
+        {
+          return seed ? static_cast<std::size_t>(
+                          boost::unordered::detail::mix_hash_bits(hf(x) ^ seed))
+                      : Policy::apply_hash(hf, x);
+        }
+      };
+
+      template <typename Policy>
+      struct is_adaptive_policy : boost::unordered::detail::false_type
       {
       };
 
+      template <typename Policy>
+      struct is_adaptive_policy<adaptive_policy<Policy> >
+          : boost::unordered::detail::true_type
+      {
+      };
+
+      template <typename Policy, typename CollisionPolicy>
+      struct pick_collision_policy
+      {
+        typedef Policy type;
+      };
+
+      template <typename Policy>
+      struct pick_collision_policy<Policy,
+        boost::unordered::adaptive_collision_defence>
+      {
+        typedef adaptive_policy<Policy> type;
+      };
+
+      // The policy for the node based containers, which also honours the hash
+      // function's bucket and collision policies. The concurrent containers
+      // use pick_policy, as they always select buckets with the high bits of
+      // the mixed hash.
+
+      template <typename T, typename H>
+      struct pick_bucket_policy
+          : pick_collision_policy<
+              typename pick_avalanching_policy<
+                typename pick_bucket_policy_impl<
+                  typename boost::remove_cv<T>::type,
+                  typename boost::unordered::hash_bucket_policy<H>::type>::type,
+                boost::unordered::hash_is_avalanching<H>::value>::type,
+              typename boost::unordered::hash_collision_policy<H>::type>
+      {
+      };
+
+      // Whether the hash function's link policy asks for back links. Used
+      // to pick the node type, so the layout is part of the container's
+      // type.
+
+      template <typename H> struct pick_back_links
+      {
+        BOOST_STATIC_CONSTANT(bool,
+          value = (boost::is_same<
+                   typename boost::unordered::hash_link_policy<H>::type,
+                   boost::unordered::back_links>::value));
+      };
+
       //////////////////////////////////////////////////////////////////////////
       // Functions
       //
@@ -2267,15 +3161,49 @@ namespace boost {
                  : static_cast<std::size_t>(f);
       }
 
+      // The seed that an adaptive policy mixes into the hash values, 0 until
+      // the table finds a long chain. The nodes' buckets depend on it, so it
+      // goes with them when they're moved to another table. Empty for the
+      // other policies, so that only adaptive tables pay for it.
+
+      template <bool Adaptive> struct table_hash_seed
+      {
+        std::size_t hash_seed() const { return 0; }
+        void set_hash_seed(std::size_t) {}
+        void swap_hash_seed(table_hash_seed&) {}
+      };
+
+      template <> struct table_hash_seed<true>
+      {
+        std::size_t hash_seed_;
+
+        table_hash_seed() : hash_seed_(0) {}
+
+        std::size_t hash_seed() const { return hash_seed_; }
+        void set_hash_seed(std::size_t seed) { hash_seed_ = seed; }
+
+        void swap_hash_seed(table_hash_seed& x)
+        {
+          boost::swap(hash_seed_, x.hash_seed_);
+        }
+      };
+
       template <typename Types>
       struct table : boost::unordered::detail::functions<typename Types::hasher,
-                       typename Types::key_equal>
+                       typename Types::key_equal>,
+                     boost::unordered::detail::table_hash_seed<
+                       boost::unordered::detail::is_adaptive_policy<
+                         typename Types::policy>::value>
       {
       private:
         table(table const&);
         table& operator=(table const&);
 
       public:
+        typedef boost::unordered::detail::table_hash_seed<
+          boost::unordered::detail::is_adaptive_policy<
+            typename Types::policy>::value>
+          hash_seed_base;
         typedef typename Types::node node;
         typedef typename Types::bucket bucket;
         typedef typename Types::hasher hasher;
@@ -2308,9 +3236,15 @@ namespace boost {
         typedef
           typename node_allocator_traits::const_pointer const_node_pointer;
         typedef typename bucket_allocator_traits::pointer bucket_pointer;
+        typedef boost::unordered::detail::bucket_allocation<bucket_allocator>
+          bucket_allocation;
+        typedef boost::unordered::detail::node_source<node_allocator>
+          node_source_type;
         typedef boost::unordered::detail::node_constructor<node_allocator>
           node_constructor;
         typedef boost::unordered::detail::node_tmp<node_allocator> node_tmp;
+        typedef boost::unordered::detail::released_storage<Types>
+          released_storage_type;
 
         typedef std::pair<iterator, bool> emplace_return;
 
@@ -2320,17 +3254,18 @@ namespace boost {
         boost::unordered::detail::compressed<bucket_allocator, node_allocator>
           allocators_;
         std::size_t bucket_count_;
-        int bcount_log2_;
+        int size_index_;
         std::size_t size_;
         float mlf_;
         std::size_t max_load_;
         bucket_pointer buckets_;
+        node_pointer spare_nodes_;
 
       private:
-        void init_bcount_log2()
+        void init_size_index()
         {
           BOOST_ASSERT( bucket_count_ > 0 );
-          bcount_log2_ = static_cast<int>( boost::core::bit_width( bucket_count_ ) ) - 1;
+          size_index_ = policy::size_index( bucket_count_ );
         }
 
       public:
@@ -2393,6 +3328,11 @@ namespace boost {
 
         node_allocator& node_alloc() { return allocators_.second(); }
 
+        node_source_type node_source()
+        {
+          return node_source_type(node_alloc(), spare_nodes_);
+        }
+
         std::size_t max_bucket_count() const
         {
           // -1 to account for the start bucket.
@@ -2431,7 +3371,7 @@ namespace boost {
 
         std::size_t hash_to_bucket(std::size_t hash_value) const
         {
-          return policy::to_bucket(bucket_count_, hash_value, bcount_log2_);
+          return policy::to_bucket(bucket_count_, hash_value, size_index_);
         }
 
         std::size_t bucket_size(std::size_t index) const
@@ -2499,26 +3439,27 @@ namespace boost {
           node_allocator const& a)
             : functions(hf, eq), allocators_(a, a),
               bucket_count_(policy::new_bucket_count(num_buckets)), size_(0),
-              mlf_(1.0f), max_load_(0), buckets_()
+              mlf_(1.0f), max_load_(0), buckets_(), spare_nodes_()
         {
-          init_bcount_log2();
+          init_size_index();
           this->create_buckets(bucket_count_);
         }
 
         table(table const& x, node_allocator const& a)
-            : functions(x), allocators_(a, a),
+            : functions(x), hash_seed_base(x), allocators_(a, a),
               bucket_count_(x.min_buckets_for_size(x.size_)), size_(0),
-              mlf_(x.mlf_), max_load_(0), buckets_()
+              mlf_(x.mlf_), max_load_(0), buckets_(), spare_nodes_()
         {
-          init_bcount_log2();
+          init_size_index();
         }
 
         table(table& x, boost::unordered::detail::move_tag m)
-            : functions(x, m), allocators_(x.allocators_, m),
-              bucket_count_(x.bucket_count_), size_(x.size_), mlf_(x.mlf_),
-              max_load_(x.max_load_), buckets_(x.buckets_)
+            : functions(x, m), hash_seed_base(x),
+              allocators_(x.allocators_, m), bucket_count_(x.bucket_count_),
+              size_(x.size_), mlf_(x.mlf_), max_load_(x.max_load_),
+              buckets_(x.buckets_), spare_nodes_()
         {
-          init_bcount_log2();
+          init_size_index();
           x.buckets_ = bucket_pointer();
           x.size_ = 0;
           x.max_load_ = 0;
@@ -2526,11 +3467,11 @@ namespace boost {
 
         table(table& x, node_allocator const& a,
           boost::unordered::detail::move_tag m)
-            : functions(x, m), allocators_(a, a),
+            : functions(x, m), hash_seed_base(x), allocators_(a, a),
               bucket_count_(x.bucket_count_), size_(0), mlf_(x.mlf_),
-              max_load_(0), buckets_()
+              max_load_(0), buckets_(), spare_nodes_()
         {
-          init_bcount_log2();
+          init_size_index();
         }
 
         ////////////////////////////////////////////////////////////////////////
@@ -2569,32 +3510,37 @@ namespace boost {
             dummy_node =
               (buckets_ + static_cast<std::ptrdiff_t>(bucket_count_))->next_;
             bucket_pointer new_buckets =
-              bucket_allocator_traits::allocate(bucket_alloc(), new_count + 1);
+              bucket_allocation::allocate(bucket_alloc(), new_count + 1);
             destroy_buckets();
             buckets_ = new_buckets;
           } else if (bucket::extra_node) {
             node_constructor a(node_alloc());
             a.create_node();
             buckets_ =
-              bucket_allocator_traits::allocate(bucket_alloc(), new_count + 1);
+              bucket_allocation::allocate(bucket_alloc(), new_count + 1);
             dummy_node = a.release();
           } else {
             dummy_node = link_pointer();
             buckets_ =
-              bucket_allocator_traits::allocate(bucket_alloc(), new_count + 1);
+              bucket_allocation::allocate(bucket_alloc(), new_count + 1);
           }
 
           // nothrow from here...
           bucket_count_ = new_count;
-          init_bcount_log2();
+          init_size_index();
           recalculate_max_load();
 
           bucket_pointer end =
             buckets_ + static_cast<std::ptrdiff_t>(new_count);
-          for (bucket_pointer i = buckets_; i != end; ++i) {
-            new ((void*)boost::to_address(i)) bucket();
+          if (!bucket_allocation::zero_initialized(new_count + 1)) {
+            for (bucket_pointer i = buckets_; i != end; ++i) {
+              new ((void*)boost::to_address(i)) bucket();
+            }
           }
           new ((void*)boost::to_address(end)) bucket(dummy_node);
+
+          link_pointer start = end->first_from_start();
+          set_prev(next_node(start), start);
         }
 
         ////////////////////////////////////////////////////////////////////////
@@ -2639,11 +3585,13 @@ namespace boost {
                    node_allocator>::propagate_on_container_swap::value>());
 
           boost::swap(buckets_, x.buckets_);
+          boost::swap(spare_nodes_, x.spare_nodes_);
           boost::swap(bucket_count_, x.bucket_count_);
-          boost::swap(bcount_log2_, x.bcount_log2_);
+          boost::swap(size_index_, x.size_index_);
           boost::swap(size_, x.size_);
           std::swap(mlf_, x.mlf_);
           std::swap(max_load_, x.max_load_);
+          this->swap_hash_seed(x);
         }
 
         // Nothrow swappable
@@ -2655,11 +3603,13 @@ namespace boost {
                    node_allocator>::propagate_on_container_swap::value>());
 
           boost::swap(buckets_, x.buckets_);
+          boost::swap(spare_nodes_, x.spare_nodes_);
           boost::swap(bucket_count_, x.bucket_count_);
-          boost::swap(bcount_log2_, x.bcount_log2_);
+          boost::swap(size_index_, x.size_index_);
           boost::swap(size_, x.size_);
           std::swap(mlf_, x.mlf_);
           std::swap(max_load_, x.max_load_);
+          this->swap_hash_seed(x);
           this->current_functions().swap(x.current_functions());
         }
 
@@ -2683,9 +3633,10 @@ namespace boost {
           BOOST_ASSERT(!buckets_);
           buckets_ = other.buckets_;
           bucket_count_ = other.bucket_count_;
-          init_bcount_log2();
+          init_size_index();
           size_ = other.size_;
           max_load_ = other.max_load_;
+          this->set_hash_seed(other.hash_seed());
           other.buckets_ = bucket_pointer();
           other.size_ = 0;
           other.max_load_ = 0;
@@ -2706,9 +3657,10 @@ namespace boost {
                 this->get_bucket_pointer(n_bucket)->next_ = prev;
               }
               node_pointer n2 = boost::unordered::detail::func::construct_node(
-                this->node_alloc(), boost::move(n->value()));
+                this->node_source(), boost::move(n->value()));
               n2->bucket_info_ = n->bucket_info_;
               prev->next_ = n2;
+              set_prev(n2, prev);
               ++size_;
               prev = n2;
               last_bucket = n_bucket;
@@ -2731,6 +3683,8 @@ namespace boost {
 
         void delete_buckets()
         {
+          delete_spare_nodes();
+
           if (buckets_) {
             node_pointer n = static_cast<node_pointer>(
               get_bucket_pointer(bucket_count_)->next_);
@@ -2755,6 +3709,46 @@ namespace boost {
           }
         }
 
+        // Hands the nodes and buckets over to a released_storage object,
+        // leaving the table empty without destroying anything. The next
+        // insert allocates a new bucket array of the default size.
+        released_storage_type release_storage() BOOST_NOEXCEPT
+        {
+          bucket_pointer buckets = buckets_;
+          std::size_t count = bucket_count_;
+          std::size_t size = size_;
+
+          buckets_ = bucket_pointer();
+          max_load_ = 0;
+          size_ = 0;
+          bucket_count_ = policy::new_bucket_count(
+            boost::unordered::detail::default_bucket_count);
+          init_size_index();
+
+          return released_storage_type(node_alloc(), buckets, count, size);
+        }
+
+        void delete_spare_nodes()
+        {
+          while (spare_nodes_) {
+            node_pointer n = spare_nodes_;
+            spare_nodes_ = static_cast<node_pointer>(n->next_);
+            boost::unordered::detail::func::destroy(boost::to_address(n));
+            node_allocator_traits::deallocate(node_alloc(), n, 1);
+          }
+        }
+
+        // Destroys the value of a node that has been unlinked from the table,
+        // and keeps the node as a spare, so that the next node to be
+        // constructed reuses it.
+        void recycle_node(node_pointer n)
+        {
+          BOOST_UNORDERED_CALL_DESTROY(
+            node_allocator_traits, node_alloc(), n->value_ptr());
+          n->next_ = spare_nodes_;
+          spare_nodes_ = n;
+        }
+
         void destroy_buckets()
         {
           bucket_pointer end = get_bucket_pointer(bucket_count_ + 1);
@@ -2762,10 +3756,58 @@ namespace boost {
             boost::unordered::detail::func::destroy(boost::to_address(it));
           }
 
-          bucket_allocator_traits::deallocate(
+          bucket_allocation::deallocate(
             bucket_alloc(), buckets_, bucket_count_ + 1);
         }
 
+        ////////////////////////////////////////////////////////////////////////
+        // Back links
+        //
+        // When the hash function's link policy is back_links, every node
+        // links back to the node before it, or to the start of the list.
+        // set_prev does nothing otherwise, and find_previous falls back to
+        // walking the bucket. Not taken from the node type, as the value type
+        // can be incomplete when the table is instantiated.
+
+        typedef boost::unordered::detail::integral_constant<bool,
+          boost::unordered::detail::pick_back_links<hasher>::value>
+          has_back_links;
+
+        static void set_prev(node_pointer n, link_pointer prev)
+        {
+          set_prev(n, prev, has_back_links());
+        }
+
+        static void set_prev(node_pointer, link_pointer, false_type) {}
+
+        static void set_prev(node_pointer n, link_pointer prev, true_type)
+        {
+          if (n) {
+            n->prev_ = prev;
+          }
+        }
+
+        link_pointer find_previous(
+          node_pointer n, std::size_t bucket_index) const
+        {
+          return this->find_previous(n, bucket_index, has_back_links());
+        }
+
+        link_pointer find_previous(
+          node_pointer n, std::size_t bucket_index, false_type) const
+        {
+          link_pointer prev = this->get_previous_start(bucket_index);
+          while (prev->next_ != n) {
+            prev = prev->next_;
+          }
+          return prev;
+        }
+
+        link_pointer find_previous(node_pointer n, std::size_t, true_type) const
+        {
+          return n->prev_;
+        }
+
         ////////////////////////////////////////////////////////////////////////
         // Fix buckets after delete/extract
         //
@@ -2841,6 +3883,7 @@ namespace boost {
           }
           BOOST_CATCH_END
           this->switch_functions();
+          this->set_hash_seed(x.hash_seed());
           assign_buckets(x, is_unique);
         }
 
@@ -2862,7 +3905,8 @@ namespace boost {
             // Copy over other data, all no throw.
             mlf_ = x.mlf_;
             bucket_count_ = min_buckets_for_size(x.size_);
-            init_bcount_log2();
+            init_size_index();
+            this->set_hash_seed(x.hash_seed());
 
             // Finally copy the elements.
             if (x.size_) {
@@ -2944,6 +3988,7 @@ namespace boost {
           }
           BOOST_CATCH_END
           this->switch_functions();
+          this->set_hash_seed(x.hash_seed());
           move_assign_buckets(x, is_unique);
         }
 
@@ -2956,7 +4001,32 @@ namespace boost {
 
         std::size_t hash(const_key_type& k) const
         {
-          return policy::apply_hash(this->hash_function(), k);
+          return this->apply_hash(this->hash_function(), k);
+        }
+
+        // Hashes with the policy, passing the seed to an adaptive policy.
+        // Also used for heterogeneous keys and compatible hash functions.
+
+        typedef boost::unordered::detail::integral_constant<bool,
+          boost::unordered::detail::is_adaptive_policy<policy>::value>
+          adaptive_hash;
+
+        template <class Hash, class Key>
+        std::size_t apply_hash(Hash const& hf, Key const& k) const
+        {
+          return this->apply_hash(hf, k, adaptive_hash());
+        }
+
+        template <class Hash, class Key>
+        std::size_t apply_hash(Hash const& hf, Key const& k, false_type) const
+        {
+          return policy::apply_hash(hf, k);
+        }
+
+        template <class Hash, class Key>
+        std::size_t apply_hash(Hash const& hf, Key const& k, true_type) const
+        {
+          return policy::apply_hash(hf, k, this->hash_seed());
         }
 
         // Find Node
@@ -2975,13 +4045,23 @@ namespace boost {
         node_pointer find_node_impl(
           std::size_t key_hash, Key const& k, Pred const& eq) const
         {
-          std::size_t bucket_index = this->hash_to_bucket(key_hash);
+          return this->find_node_in_bucket(
+            this->hash_to_bucket(key_hash), k, eq);
+        }
+
+        template <class Key, class Pred>
+        node_pointer find_node_in_bucket(
+          std::size_t bucket_index, Key const& k, Pred const& eq) const
+        {
           node_pointer n = this->begin(bucket_index);
 
           for (;;) {
             if (!n)
               return n;
 
+            // Fetch the next node while the key is compared.
+            boost::unordered::detail::func::prefetch(n->next_);
+
             if (eq(k, this->get_key(n))) {
               return n;
             } else if (this->node_bucket(n) != bucket_index) {
@@ -3034,7 +4114,7 @@ namespace boost {
           if (!this->size_) {
             return node_pointer();
           }
-          std::size_t key_hash = policy::apply_hash(this->hash_function(), k);
+          std::size_t key_hash = this->apply_hash(this->hash_function(), k);
           std::size_t bucket_index = this->hash_to_bucket(key_hash);
           link_pointer prev =
             this->find_previous_node_impl(this->key_eq(), k, bucket_index);
@@ -3047,6 +4127,7 @@ namespace boost {
             n2->set_first_in_group();
           }
           prev->next_ = n2;
+          set_prev(n2, prev);
           --this->size_;
           this->fix_bucket(bucket_index, prev, n2);
           n->next_ = link_pointer();
@@ -3064,7 +4145,212 @@ namespace boost {
         void reserve_for_insert(std::size_t);
         void rehash(std::size_t);
         void reserve(std::size_t);
+        void reserve_nodes(std::size_t);
         void rehash_impl(std::size_t);
+        void rehash_nodes();
+        void compact();
+
+        // Collision defence
+        //
+        // Called with a node that was just added as the first of its
+        // bucket. Before an adaptive table is seeded, counts the groups in
+        // the bucket, and if there are more than the policy allows, seeds
+        // the hash and rehashes. The extra walk only touches nodes the
+        // lookup before the insert has just visited.
+        //
+        // Basic exception safety if the hash function throws.
+
+        void check_chain(node_pointer n)
+        {
+          this->check_chain(n, adaptive_hash());
+        }
+
+        void check_chain(node_pointer, false_type) {}
+
+        void check_chain(node_pointer n, true_type)
+        {
+          if (this->hash_seed()) {
+            return;
+          }
+
+          std::size_t limit = policy::chain_limit;
+          if (mlf_ > 1.0f) {
+            limit = boost::unordered::detail::double_to_size(
+              std::ceil(mlf_) * static_cast<double>(policy::chain_limit));
+          }
+
+          std::size_t const bucket_index = this->node_bucket(n);
+          std::size_t count = 0;
+          for (; n && this->node_bucket(n) == bucket_index;
+               n = next_for_find(n)) {
+            if (++count > limit) {
+              this->seed_hash();
+              return;
+            }
+          }
+        }
+
+        // The seed is mixed from the table's address and the time, which is
+        // enough to keep it from being guessed from outside the process, but
+        // isn't cryptographically secure. The bucket count doesn't change,
+        // so the nodes are relinked into the same buckets.
+        void seed_hash()
+        {
+          using namespace std;
+
+          boost::uint64_t seed = boost::unordered::detail::mix_hash_bits(
+            static_cast<std::size_t>(reinterpret_cast<boost::uintptr_t>(this)));
+          seed = boost::unordered::detail::mix_hash_bits(
+            static_cast<std::size_t>(seed) ^ static_cast<std::size_t>(time(0)));
+          seed = boost::unordered::detail::mix_hash_bits(
+            static_cast<std::size_t>(seed) ^ static_cast<std::size_t>(clock()));
+
+          this->set_hash_seed(static_cast<std::size_t>(seed) | 1u);
+          this->clear_buckets();
+          this->rehash_nodes();
+        }
+
+#if BOOST_UNORDERED_PARALLEL
+        ////////////////////////////////////////////////////////////////////////
+        // Parallel algorithms
+        //
+        // The buckets are split into one contiguous range per thread, and
+        // each thread only visits the nodes in its own buckets.
+
+        std::size_t parallel_threads(std::size_t num_threads) const
+        {
+          return (std::max)(std::size_t(1),
+            boost::unordered::detail::parallel_thread_count(
+              num_threads, size_));
+        }
+
+        // Calls f(t, first_bucket, last_bucket) for each thread t.
+        template <class F>
+        std::exception_ptr run_on_buckets(
+          std::size_t num_threads, F const& f) const
+        {
+          std::size_t const per_thread =
+            (bucket_count_ + num_threads - 1) / num_threads;
+          return boost::unordered::detail::run_in_parallel(
+            num_threads, [&](std::size_t t) {
+              std::size_t const first =
+                (std::min)(bucket_count_, t * per_thread);
+              f(t, first, (std::min)(bucket_count_, first + per_thread));
+            });
+        }
+
+        template <class F>
+        void parallel_for_each(F& f, std::size_t num_threads) const
+        {
+          if (!size_) {
+            return;
+          }
+
+          std::exception_ptr error = run_on_buckets(
+            parallel_threads(num_threads),
+            [&](std::size_t, std::size_t first, std::size_t last) {
+              for (std::size_t b = first; b != last; ++b) {
+                for (node_pointer n = this->begin(b);
+                     n && this->node_bucket(n) == b; n = next_node(n)) {
+                  f(n->value());
+                }
+              }
+            });
+          if (error) {
+            std::rethrow_exception(error);
+          }
+        }
+
+        template <class Predicate>
+        std::size_t parallel_count_if(
+          Predicate& pred, std::size_t num_threads) const
+        {
+          if (!size_) {
+            return 0;
+          }
+
+          num_threads = parallel_threads(num_threads);
+          std::vector<std::size_t> counts(num_threads);
+          std::exception_ptr error = run_on_buckets(
+            num_threads, [&](std::size_t t, std::size_t first,
+                           std::size_t last) {
+              std::size_t count = 0;
+              for (std::size_t b = first; b != last; ++b) {
+                for (node_pointer n = this->begin(b);
+                     n && this->node_bucket(n) == b; n = next_node(n)) {
+                  value_type const& v = n->value();
+                  if (pred(v)) {
+                    ++count;
+                  }
+                }
+              }
+              counts[t] = count;
+            });
+          if (error) {
+            std::rethrow_exception(error);
+          }
+
+          std::size_t total = 0;
+          for (std::size_t t = 0; t < num_threads; ++t) {
+            total += counts[t];
+          }
+          return total;
+        }
+
+        // Works for both unique and equivalent keys, as each element with
+        // a unique key is a group of its own.
+        bool parallel_equals(
+          table const& other, std::size_t num_threads) const
+        {
+          if (this->size_ != other.size_) {
+            return false;
+          }
+          if (!size_) {
+            return true;
+          }
+
+          std::atomic<bool> different(false);
+          std::exception_ptr error = run_on_buckets(
+            parallel_threads(num_threads),
+            [&](std::size_t, std::size_t first, std::size_t last) {
+              for (std::size_t b = first; b != last; ++b) {
+                if (different.load(std::memory_order_relaxed)) {
+                  return;
+                }
+
+                for (node_pointer n1 = this->begin(b);
+                     n1 && this->node_bucket(n1) == b;) {
+                  node_pointer n2 = other.find_node(other.get_key(n1));
+                  node_pointer end1 = next_group(n1);
+                  if (!n2 ||
+                      !group_equals_equiv(n1, end1, n2, next_group(n2))) {
+                    different.store(true, std::memory_order_relaxed);
+                    return;
+                  }
+                  n1 = end1;
+                }
+              }
+            });
+          if (error) {
+            std::rethrow_exception(error);
+          }
+          return !different.load();
+        }
+
+        template <class Predicate>
+        std::size_t parallel_erase_if(Predicate& pred, std::size_t num_threads)
+        {
+          auto node_pred = [&pred](node_pointer n) {
+            value_type const& v = n->value();
+            return pred(v) ? true : false;
+          };
+          return this->parallel_erase_nodes_if(node_pred, num_threads);
+        }
+
+        template <class NodePredicate>
+        std::size_t parallel_erase_nodes_if(
+          NodePredicate& pred, std::size_t num_threads);
+#endif
 
         ////////////////////////////////////////////////////////////////////////
         // Unique keys
@@ -3091,7 +4377,15 @@ namespace boost {
         inline node_pointer add_node_unique(
           node_pointer n, std::size_t key_hash)
         {
-          std::size_t bucket_index = this->hash_to_bucket(key_hash);
+          n = this->add_node_unique_to_bucket(
+            n, this->hash_to_bucket(key_hash));
+          this->check_chain(n);
+          return n;
+        }
+
+        inline node_pointer add_node_unique_to_bucket(
+          node_pointer n, std::size_t bucket_index)
+        {
           bucket_pointer b = this->get_bucket_pointer(bucket_index);
 
           n->bucket_info_ = bucket_index;
@@ -3108,10 +4402,13 @@ namespace boost {
             b->next_ = start_node;
             n->next_ = start_node->next_;
             start_node->next_ = n;
+            set_prev(n, start_node);
           } else {
             n->next_ = b->next_->next_;
             b->next_->next_ = n;
+            set_prev(n, b->next_);
           }
+          set_prev(next_node(n), n);
 
           ++this->size_;
           return n;
@@ -3148,7 +4445,7 @@ namespace boost {
             return emplace_return(
               iterator(this->resize_and_add_node_unique(
                 boost::unordered::detail::func::construct_node_from_args(
-                  this->node_alloc(), BOOST_UNORDERED_EMPLACE_FORWARD),
+                  this->node_source(), BOOST_UNORDERED_EMPLACE_FORWARD),
                 key_hash)),
               true);
           }
@@ -3159,7 +4456,7 @@ namespace boost {
           c_iterator hint, no_key, BOOST_UNORDERED_EMPLACE_ARGS)
         {
           node_tmp b(boost::unordered::detail::func::construct_node_from_args(
-                       this->node_alloc(), BOOST_UNORDERED_EMPLACE_FORWARD),
+                       this->node_source(), BOOST_UNORDERED_EMPLACE_FORWARD),
             this->node_alloc());
           const_key_type& k = this->get_key(b.node_);
           if (hint.node_ && this->key_eq()(k, this->get_key(hint.node_))) {
@@ -3179,7 +4476,7 @@ namespace boost {
         emplace_return emplace_unique(no_key, BOOST_UNORDERED_EMPLACE_ARGS)
         {
           node_tmp b(boost::unordered::detail::func::construct_node_from_args(
-                       this->node_alloc(), BOOST_UNORDERED_EMPLACE_FORWARD),
+                       this->node_source(), BOOST_UNORDERED_EMPLACE_FORWARD),
             this->node_alloc());
           const_key_type& k = this->get_key(b.node_);
           std::size_t key_hash = this->hash(k);
@@ -3204,7 +4501,7 @@ namespace boost {
             return emplace_return(
               iterator(this->resize_and_add_node_unique(
                 boost::unordered::detail::func::construct_node_pair(
-                  this->node_alloc(), boost::forward<Key>(k)),
+                  this->node_source(), boost::forward<Key>(k)),
                 key_hash)),
               true);
           }
@@ -3220,54 +4517,256 @@ namespace boost {
           }
         }
 
-        template <typename Key, BOOST_UNORDERED_EMPLACE_TEMPLATE>
-        emplace_return try_emplace_unique(
-          BOOST_FWD_REF(Key) k, BOOST_UNORDERED_EMPLACE_ARGS)
+        template <typename Key, BOOST_UNORDERED_EMPLACE_TEMPLATE>
+        emplace_return try_emplace_unique(
+          BOOST_FWD_REF(Key) k, BOOST_UNORDERED_EMPLACE_ARGS)
+        {
+          std::size_t key_hash = this->hash(k);
+          node_pointer pos = this->find_node(key_hash, k);
+          if (pos) {
+            return emplace_return(iterator(pos), false);
+          } else {
+            return emplace_return(
+              iterator(this->resize_and_add_node_unique(
+                boost::unordered::detail::func::construct_node_pair_from_args(
+                  this->node_source(), boost::forward<Key>(k),
+                  BOOST_UNORDERED_EMPLACE_FORWARD),
+                key_hash)),
+              true);
+          }
+        }
+
+        template <typename Key, BOOST_UNORDERED_EMPLACE_TEMPLATE>
+        iterator try_emplace_hint_unique(
+          c_iterator hint, BOOST_FWD_REF(Key) k, BOOST_UNORDERED_EMPLACE_ARGS)
+        {
+          if (hint.node_ && this->key_eq()(hint->first, k)) {
+            return iterator(hint.node_);
+          } else {
+            return try_emplace_unique(k, BOOST_UNORDERED_EMPLACE_FORWARD).first;
+          }
+        }
+
+        template <typename Key, typename M>
+        emplace_return insert_or_assign_unique(
+          BOOST_FWD_REF(Key) k, BOOST_FWD_REF(M) obj)
+        {
+          std::size_t key_hash = this->hash(k);
+          node_pointer pos = this->find_node(key_hash, k);
+
+          if (pos) {
+            pos->value().second = boost::forward<M>(obj);
+            return emplace_return(iterator(pos), false);
+          } else {
+            return emplace_return(
+              iterator(this->resize_and_add_node_unique(
+                boost::unordered::detail::func::construct_node_pair(
+                  this->node_source(), boost::forward<Key>(k),
+                  boost::forward<M>(obj)),
+                key_hash)),
+              true);
+          }
+        }
+
+        // Heterogeneous insertion, for transparent hash and equality
+        // functions. The lookup uses the supplied key, which is only
+        // converted to key_type when a new node is created.
+
+        template <typename Key>
+        emplace_return insert_unique_impl(BOOST_FWD_REF(Key) k)
+        {
+          std::size_t key_hash = this->apply_hash(this->hash_function(), k);
+          node_pointer pos = this->find_node_impl(key_hash, k, this->key_eq());
+          if (pos) {
+            return emplace_return(iterator(pos), false);
+          } else {
+            return emplace_return(
+              iterator(this->resize_and_add_node_unique(
+                boost::unordered::detail::func::construct_node(
+                  this->node_source(), boost::forward<Key>(k)),
+                key_hash)),
+              true);
+          }
+        }
+
+        template <typename Key>
+        iterator insert_hint_unique_impl(c_iterator hint, BOOST_FWD_REF(Key) k)
+        {
+          if (hint.node_ && this->key_eq()(*hint, k)) {
+            return iterator(hint.node_);
+          } else {
+            return insert_unique_impl(boost::forward<Key>(k)).first;
+          }
+        }
+
+        template <typename Key, BOOST_UNORDERED_EMPLACE_TEMPLATE>
+        emplace_return try_emplace_unique_impl(
+          BOOST_FWD_REF(Key) k, BOOST_UNORDERED_EMPLACE_ARGS)
+        {
+          std::size_t key_hash = this->apply_hash(this->hash_function(), k);
+          node_pointer pos = this->find_node_impl(key_hash, k, this->key_eq());
+          if (pos) {
+            return emplace_return(iterator(pos), false);
+          } else {
+            return emplace_return(
+              iterator(this->resize_and_add_node_unique(
+                boost::unordered::detail::func::construct_node_pair_from_args(
+                  this->node_source(), boost::forward<Key>(k),
+                  BOOST_UNORDERED_EMPLACE_FORWARD),
+                key_hash)),
+              true);
+          }
+        }
+
+        template <typename Key, BOOST_UNORDERED_EMPLACE_TEMPLATE>
+        iterator try_emplace_hint_unique_impl(
+          c_iterator hint, BOOST_FWD_REF(Key) k, BOOST_UNORDERED_EMPLACE_ARGS)
+        {
+          if (hint.node_ && this->key_eq()(hint->first, k)) {
+            return iterator(hint.node_);
+          } else {
+            return try_emplace_unique_impl(
+              boost::forward<Key>(k), BOOST_UNORDERED_EMPLACE_FORWARD)
+              .first;
+          }
+        }
+
+        template <typename Key, typename M>
+        emplace_return insert_or_assign_unique_impl(
+          BOOST_FWD_REF(Key) k, BOOST_FWD_REF(M) obj)
+        {
+          std::size_t key_hash = this->apply_hash(this->hash_function(), k);
+          node_pointer pos = this->find_node_impl(key_hash, k, this->key_eq());
+
+          if (pos) {
+            pos->value().second = boost::forward<M>(obj);
+            return emplace_return(iterator(pos), false);
+          } else {
+            return emplace_return(
+              iterator(this->resize_and_add_node_unique(
+                boost::unordered::detail::func::construct_node_pair(
+                  this->node_source(), boost::forward<Key>(k),
+                  boost::forward<M>(obj)),
+                key_hash)),
+              true);
+          }
+        }
+
+        ////////////////////////////////////////////////////////////////////////
+        // Batched insert or update
+        //
+        // Inserting one element at a time stalls on up to three dependent
+        // cache misses: the bucket, the node before the bucket's first node
+        // and the first node itself. For forward iterators the elements are
+        // handled in blocks instead. Every key in a block is hashed and the
+        // table grown once, then each level is prefetched for the whole
+        // block so that the misses overlap, before the elements are applied.
+        //
+        // Returns the number of elements inserted. Basic exception safety.
+
+        static const std::size_t batch_block_size = 16;
+
+        template <class InputIt, class Update>
+        typename boost::unordered::detail::enable_if_forward<InputIt,
+          std::size_t>::type
+        insert_or_update_range_unique(InputIt i, InputIt j, Update update)
+        {
+          std::size_t hashes[batch_block_size];
+          std::size_t inserted = 0;
+
+          while (i != j) {
+            InputIt block = i;
+            std::size_t n = 0;
+            for (; n < batch_block_size && i != j; ++n, ++i) {
+              hashes[n] = this->hash((*i).first);
+            }
+
+            this->reserve_for_insert(this->size_ + n);
+
+            for (std::size_t k = 0; k < n; ++k) {
+              boost::unordered::detail::func::prefetch(
+                this->get_bucket_pointer(this->hash_to_bucket(hashes[k])));
+            }
+            if (this->size_) {
+              for (std::size_t k = 0; k < n; ++k) {
+                boost::unordered::detail::func::prefetch(
+                  this->get_previous_start(this->hash_to_bucket(hashes[k])));
+              }
+              for (std::size_t k = 0; k < n; ++k) {
+                link_pointer prev =
+                  this->get_previous_start(this->hash_to_bucket(hashes[k]));
+                if (prev) {
+                  boost::unordered::detail::func::prefetch(prev->next_);
+                }
+              }
+            }
+
+            // An insert can seed an adaptive table's hash, which changes the
+            // hash values of the rest of the block.
+            std::size_t const seed = this->hash_seed();
+            for (std::size_t k = 0; k < n; ++k, ++block) {
+              std::size_t const key_hash = this->hash_seed() == seed
+                                             ? hashes[k]
+                                             : this->hash((*block).first);
+              inserted +=
+                this->insert_or_update_reserved_unique(key_hash, *block, update);
+            }
+          }
+
+          return inserted;
+        }
+
+        template <class InputIt, class Update>
+        typename boost::unordered::detail::disable_if_forward<InputIt,
+          std::size_t>::type
+        insert_or_update_range_unique(InputIt i, InputIt j, Update update)
         {
-          std::size_t key_hash = this->hash(k);
-          node_pointer pos = this->find_node(key_hash, k);
-          if (pos) {
-            return emplace_return(iterator(pos), false);
-          } else {
-            return emplace_return(
-              iterator(this->resize_and_add_node_unique(
-                boost::unordered::detail::func::construct_node_pair_from_args(
-                  this->node_alloc(), boost::forward<Key>(k),
-                  BOOST_UNORDERED_EMPLACE_FORWARD),
-                key_hash)),
-              true);
+          typedef typename std::iterator_traits<InputIt>::value_type
+            input_value;
+
+          // '*i' might be a proxy, so view it as the iterator's value type.
+          std::size_t inserted = 0;
+          for (; i != j; ++i) {
+            inserted += this->insert_or_update_unique(
+              static_cast<input_value const&>(*i), update);
           }
+          return inserted;
         }
 
-        template <typename Key, BOOST_UNORDERED_EMPLACE_TEMPLATE>
-        iterator try_emplace_hint_unique(
-          c_iterator hint, BOOST_FWD_REF(Key) k, BOOST_UNORDERED_EMPLACE_ARGS)
+        template <class Value, class Update>
+        std::size_t insert_or_update_reserved_unique(
+          std::size_t key_hash, BOOST_FWD_REF(Value) v, Update& update)
         {
-          if (hint.node_ && this->key_eq()(hint->first, k)) {
-            return iterator(hint.node_);
+          node_pointer pos = this->find_node(key_hash, v.first);
+
+          if (pos) {
+            update(pos->value().second, boost::forward<Value>(v).second);
+            return 0;
           } else {
-            return try_emplace_unique(k, BOOST_UNORDERED_EMPLACE_FORWARD).first;
+            this->add_node_unique(
+              boost::unordered::detail::func::construct_node(
+                this->node_source(), boost::forward<Value>(v)),
+              key_hash);
+            return 1;
           }
         }
 
-        template <typename Key, typename M>
-        emplace_return insert_or_assign_unique(
-          BOOST_FWD_REF(Key) k, BOOST_FWD_REF(M) obj)
+        template <class Value, class Update>
+        std::size_t insert_or_update_unique(
+          BOOST_FWD_REF(Value) v, Update& update)
         {
-          std::size_t key_hash = this->hash(k);
-          node_pointer pos = this->find_node(key_hash, k);
+          std::size_t key_hash = this->hash(v.first);
+          node_pointer pos = this->find_node(key_hash, v.first);
 
           if (pos) {
-            pos->value().second = boost::forward<M>(obj);
-            return emplace_return(iterator(pos), false);
+            update(pos->value().second, boost::forward<Value>(v).second);
+            return 0;
           } else {
-            return emplace_return(
-              iterator(this->resize_and_add_node_unique(
-                boost::unordered::detail::func::construct_node_pair(
-                  this->node_alloc(), boost::forward<Key>(k),
-                  boost::forward<M>(obj)),
-                key_hash)),
-              true);
+            this->resize_and_add_node_unique(
+              boost::unordered::detail::func::construct_node(
+                this->node_source(), boost::forward<Value>(v)),
+              key_hash);
+            return 1;
           }
         }
 
@@ -3285,10 +4784,10 @@ namespace boost {
               result.position = iterator(pos);
             } else {
               this->reserve_for_insert(this->size_ + 1);
-              result.position =
-                iterator(this->add_node_unique(np.ptr_, key_hash));
-              result.inserted = true;
+              node_pointer n = np.ptr_;
               np.ptr_ = node_pointer();
+              result.position = iterator(this->add_node_unique(n, key_hash));
+              result.inserted = true;
             }
           }
         }
@@ -3308,8 +4807,9 @@ namespace boost {
           node_pointer pos = this->find_node(key_hash, k);
           if (!pos) {
             this->reserve_for_insert(this->size_ + 1);
-            pos = this->add_node_unique(np.ptr_, key_hash);
+            node_pointer n = np.ptr_;
             np.ptr_ = node_pointer();
+            pos = this->add_node_unique(n, key_hash);
           }
           return iterator(pos);
         }
@@ -3337,6 +4837,7 @@ namespace boost {
                 this->reserve_for_insert(this->size_ + 1);
                 node_pointer n2 = next_node(n);
                 prev->next_ = n2;
+                set_prev(n2, prev);
                 if (n2 && n->is_first_in_group()) {
                   n2->set_first_in_group();
                 }
@@ -3376,7 +4877,7 @@ namespace boost {
 
           if (!pos) {
             node_tmp b(boost::unordered::detail::func::construct_node(
-                         this->node_alloc(), *i),
+                         this->node_source(), *i),
               this->node_alloc());
             if (this->size_ + 1 > this->max_load_)
               this->reserve_for_insert(
@@ -3388,7 +4889,7 @@ namespace boost {
         template <class InputIt>
         void insert_range_unique(no_key, InputIt i, InputIt j)
         {
-          node_constructor a(this->node_alloc());
+          node_constructor a(this->node_source());
 
           do {
             if (!a.node_) {
@@ -3413,6 +4914,22 @@ namespace boost {
           } while (++i != j);
         }
 
+#if BOOST_UNORDERED_PARALLEL
+        // Elements that don't have a key can't be hashed before their nodes
+        // are constructed, so they're always inserted serially.
+
+        template <class InputIt>
+        void insert_range_unique_parallel(
+          no_key, InputIt i, InputIt j, std::size_t)
+        {
+          insert_range_unique(no_key(), i, j);
+        }
+
+        template <class InputIt>
+        void insert_range_unique_parallel(
+          const_key_type&, InputIt, InputIt, std::size_t);
+#endif
+
         ////////////////////////////////////////////////////////////////////////
         // Extract
 
@@ -3421,12 +4938,10 @@ namespace boost {
           node_pointer n = i.node_;
           BOOST_ASSERT(n);
           std::size_t bucket_index = this->node_bucket(n);
-          link_pointer prev = this->get_previous_start(bucket_index);
-          while (prev->next_ != n) {
-            prev = prev->next_;
-          }
+          link_pointer prev = this->find_previous(n, bucket_index);
           node_pointer n2 = next_node(n);
           prev->next_ = n2;
+          set_prev(n2, prev);
           --this->size_;
           this->fix_bucket(bucket_index, prev, n2);
           n->next_ = link_pointer();
@@ -3444,7 +4959,7 @@ namespace boost {
           if (!this->size_)
             return 0;
 
-          std::size_t key_hash = policy::apply_hash(this->hash_function(), k);
+          std::size_t key_hash = this->apply_hash(this->hash_function(), k);
           std::size_t bucket_index = this->hash_to_bucket(key_hash);
 
           link_pointer prev =
@@ -3453,14 +4968,20 @@ namespace boost {
           if (!prev)
             return 0;
 
+          this->erase_next_unique(prev, bucket_index);
+          return 1;
+        }
+
+        // Erases the node after prev, which is in the bucket.
+        void erase_next_unique(link_pointer prev, std::size_t bucket_index)
+        {
           node_pointer n = next_node(prev);
           node_pointer n2 = next_node(n);
           prev->next_ = n2;
+          set_prev(n2, prev);
           --size_;
           this->fix_bucket(bucket_index, prev, n2);
           this->destroy_node(n);
-          
-          return 1;
         }
 
         void erase_nodes_unique(node_pointer i, node_pointer j)
@@ -3468,12 +4989,11 @@ namespace boost {
           std::size_t bucket_index = this->node_bucket(i);
 
           // Find the node before i.
-          link_pointer prev = this->get_previous_start(bucket_index);
-          while (prev->next_ != i)
-            prev = prev->next_;
+          link_pointer prev = this->find_previous(i, bucket_index);
 
           // Delete the nodes.
           prev->next_ = j;
+          set_prev(j, prev);
           do {
             node_pointer next = next_node(i);
             destroy_node(i);
@@ -3483,6 +5003,293 @@ namespace boost {
           } while (i != j);
         }
 
+        ////////////////////////////////////////////////////////////////////////
+        // Set operations
+        //
+        // The keys of one table's nodes are looked up in another table of
+        // the same type. When both have the same number of buckets and a
+        // stateless hash function, a key can only be in the bucket with the
+        // same index, so it's looked up there without hashing it again.
+
+        bool same_buckets(table const& other) const
+        {
+          return boost::is_empty<hasher>::value &&
+                 this->bucket_count_ == other.bucket_count_ &&
+                 this->hash_seed() == other.hash_seed();
+        }
+
+        // Finds the key of a node from another table.
+        node_pointer find_node_of(node_pointer n, bool same_buckets) const
+        {
+          const_key_type& k = this->get_key(n);
+          return same_buckets ? this->find_node_in_bucket(
+                                  n->get_bucket(), k, this->key_eq())
+                              : this->find_node(k);
+        }
+
+        // Whether the key of a node is (or isn't) in another table.
+        struct key_lookup
+        {
+          table const* table_;
+          bool same_buckets_;
+          bool found_;
+
+          bool operator()(node_pointer n) const
+          {
+            bool const found =
+              table_->find_node_of(n, same_buckets_) ? true : false;
+            return found == found_;
+          }
+        };
+
+        key_lookup lookup_in(table const& other, bool found) const
+        {
+          key_lookup pred = {&other, other.same_buckets(*this), found};
+          return pred;
+        }
+
+        bool is_subset_unique(table const& other) const
+        {
+          if (this->size_ > other.size_) {
+            return false;
+          }
+
+          key_lookup pred = this->lookup_in(other, true);
+          for (node_pointer n = this->begin(); n; n = next_node(n)) {
+            if (!pred(n)) {
+              return false;
+            }
+          }
+          return true;
+        }
+
+        // Unlinks the nodes as the list is walked, so unlike erasing by
+        // iterator, the previous node is never searched for.
+        template <class NodePredicate>
+        std::size_t erase_nodes_if(NodePredicate const& pred)
+        {
+          if (!this->size_) {
+            return 0;
+          }
+
+          std::size_t count = 0;
+          link_pointer prev = this->get_previous_start();
+          while (prev->next_) {
+            node_pointer n = next_node(prev);
+            if (pred(n)) {
+              node_pointer next = next_node(n);
+              if (next && n->is_first_in_group()) {
+                next->set_first_in_group();
+              }
+              prev->next_ = next;
+              set_prev(next, prev);
+              --size_;
+              this->fix_bucket(this->node_bucket(n), prev, next);
+              this->destroy_node(n);
+              ++count;
+            } else {
+              prev = n;
+            }
+          }
+          return count;
+        }
+
+        // Erases the elements whose keys aren't in other.
+        std::size_t intersect_unique(table const& other)
+        {
+          return this->erase_nodes_if(this->lookup_in(other, false));
+        }
+
+        // Erases the elements whose keys are in other. When other is
+        // smaller, its nodes are looked up instead.
+        std::size_t subtract_unique(table const& other)
+        {
+          if (other.size_ >= this->size_) {
+            return this->erase_nodes_if(this->lookup_in(other, true));
+          }
+
+          bool const same = this->same_buckets(other);
+          std::size_t count = 0;
+          for (node_pointer n = other.begin(); n && this->size_;
+               n = next_node(n)) {
+            const_key_type& k = this->get_key(n);
+            std::size_t bucket_index =
+              same ? n->get_bucket() : this->hash_to_bucket(this->hash(k));
+            link_pointer prev =
+              this->find_previous_node_impl(this->key_eq(), k, bucket_index);
+            if (prev) {
+              this->erase_next_unique(prev, bucket_index);
+              ++count;
+            }
+          }
+          return count;
+        }
+
+        // Inserts copies of the elements of other whose keys aren't in this
+        // table.
+        std::size_t unite_unique(table const& other)
+        {
+          std::size_t count = 0;
+          for (node_pointer n = other.begin(); n; n = next_node(n)) {
+            bool same = this->same_buckets(other);
+            if (this->find_node_of(n, same)) {
+              continue;
+            }
+
+            node_tmp b(boost::unordered::detail::func::construct_node(
+                         this->node_source(), n->value()),
+              this->node_alloc());
+            if (this->size_ + 1 > this->max_load_) {
+              this->reserve_for_insert(this->size_ + 1);
+              same = this->same_buckets(other);
+            }
+            this->add_node_unique_to_bucket(b.release(),
+              same ? n->get_bucket()
+                   : this->hash_to_bucket(this->hash(this->get_key(n))));
+            ++count;
+          }
+          return count;
+        }
+
+        // Copies the nodes of src for which pred returns true into this
+        // table, which is empty and has the same hash function and number
+        // of buckets, so each copy goes in the same bucket as its original.
+        template <class NodePredicate>
+        void copy_nodes_if(table const& src, NodePredicate const& pred)
+        {
+          BOOST_ASSERT(!this->size_);
+          BOOST_ASSERT(this->bucket_count_ == src.bucket_count_);
+          // The nodes keep their buckets, so they need the same seed.
+          this->set_hash_seed(src.hash_seed());
+          if (!src.size_) {
+            return;
+          }
+
+          if (!this->buckets_) {
+            this->create_buckets(this->bucket_count_);
+          }
+          for (node_pointer n = src.begin(); n; n = next_node(n)) {
+            if (pred(n)) {
+              this->copy_node_unique(n);
+            }
+          }
+        }
+
+        void copy_node_unique(node_pointer n)
+        {
+          this->add_node_unique_to_bucket(
+            boost::unordered::detail::func::construct_node(
+              this->node_source(), n->value()),
+            n->get_bucket());
+        }
+
+        struct all_nodes
+        {
+          bool operator()(node_pointer) const { return true; }
+        };
+
+        void copy_union_unique(table const& x, table const& y)
+        {
+          this->copy_nodes_if(x, all_nodes());
+          this->unite_unique(y);
+        }
+
+        // Copies the elements of x whose keys are in y, looking up the
+        // nodes of the smaller of the two.
+        void copy_intersection_unique(table const& x, table const& y)
+        {
+          if (x.size_ <= y.size_) {
+            this->copy_nodes_if(x, x.lookup_in(y, true));
+            return;
+          }
+
+          BOOST_ASSERT(!this->size_);
+          BOOST_ASSERT(this->bucket_count_ == x.bucket_count_);
+          this->set_hash_seed(x.hash_seed());
+          if (!y.size_) {
+            return;
+          }
+
+          if (!this->buckets_) {
+            this->create_buckets(this->bucket_count_);
+          }
+          bool const same = x.same_buckets(y);
+          for (node_pointer n = y.begin(); n; n = next_node(n)) {
+            node_pointer n2 = x.find_node_of(n, same);
+            if (n2) {
+              this->copy_node_unique(n2);
+            }
+          }
+        }
+
+        void copy_difference_unique(table const& x, table const& y)
+        {
+          this->copy_nodes_if(x, x.lookup_in(y, false));
+        }
+
+#if BOOST_UNORDERED_PARALLEL
+        bool parallel_is_subset_unique(
+          table const& other, std::size_t num_threads) const
+        {
+          if (this->size_ > other.size_) {
+            return false;
+          }
+          if (!size_) {
+            return true;
+          }
+
+          key_lookup pred = this->lookup_in(other, true);
+          std::atomic<bool> missing(false);
+          std::exception_ptr error = run_on_buckets(
+            parallel_threads(num_threads),
+            [&](std::size_t, std::size_t first, std::size_t last) {
+              for (std::size_t b = first; b != last; ++b) {
+                if (missing.load(std::memory_order_relaxed)) {
+                  return;
+                }
+
+                for (node_pointer n = this->begin(b);
+                     n && this->node_bucket(n) == b; n = next_node(n)) {
+                  if (!pred(n)) {
+                    missing.store(true, std::memory_order_relaxed);
+                    return;
+                  }
+                }
+              }
+            });
+          if (error) {
+            std::rethrow_exception(error);
+          }
+          return !missing.load();
+        }
+
+        // The threads erase nodes, so a table can't look its own keys up
+        // while they're running.
+        std::size_t parallel_intersect_unique(
+          table const& other, std::size_t num_threads)
+        {
+          if (&other == this) {
+            return 0;
+          }
+
+          key_lookup pred = this->lookup_in(other, false);
+          return this->parallel_erase_nodes_if(pred, num_threads);
+        }
+
+        std::size_t parallel_subtract_unique(
+          table const& other, std::size_t num_threads)
+        {
+          if (&other == this) {
+            std::size_t count = this->size_;
+            this->clear_impl();
+            return count;
+          }
+
+          key_lookup pred = this->lookup_in(other, true);
+          return this->parallel_erase_nodes_if(pred, num_threads);
+        }
+#endif
+
         ////////////////////////////////////////////////////////////////////////
         // fill_buckets_unique
 
@@ -3494,7 +5301,7 @@ namespace boost {
             std::size_t key_hash = this->hash(this->get_key(n));
             this->add_node_unique(
               boost::unordered::detail::func::construct_node(
-                this->node_alloc(), n->value()),
+                this->node_source(), n->value()),
               key_hash);
           }
         }
@@ -3541,51 +5348,197 @@ namespace boost {
           return true;
         }
 
-        static bool group_equals_equiv(node_pointer n1, node_pointer end1,
-          node_pointer n2, node_pointer end2)
+        bool group_equals_equiv(node_pointer n1, node_pointer end1,
+          node_pointer n2, node_pointer end2) const
+        {
+          for (;;) {
+            if (n1->value() != n2->value())
+              break;
+
+            n1 = next_node(n1);
+            n2 = next_node(n2);
+
+            if (n1 == end1)
+              return n2 == end2;
+            if (n2 == end2)
+              return false;
+          }
+
+          std::size_t remaining = 1;
+          for (node_pointer n1a = n1, n2a = n2;; ++remaining) {
+            n1a = next_node(n1a);
+            n2a = next_node(n2a);
+
+            if (n1a == end1) {
+              if (n2a == end2)
+                break;
+              else
+                return false;
+            }
+
+            if (n2a == end2)
+              return false;
+          }
+
+#if BOOST_UNORDERED_GROUP_HASH
+          typedef boost::unordered::detail::group_value_hash<value_type>
+            value_hash;
+          if (remaining > group_hash_threshold) {
+            return this->group_equals_hashed(n1, end1, n2, end2, remaining,
+              boost::unordered::detail::is_std_hashable<
+                typename value_hash::hashed_type>());
+          }
+#endif
+
+          return group_equals_counted(n1, end1, n2, end2);
+        }
+
+        // Compares what's left of two groups of the same length, by counting
+        // the matches for each distinct value. Quadratic in the length.
+
+        static bool group_equals_counted(node_pointer n1, node_pointer end1,
+          node_pointer n2, node_pointer end2)
+        {
+          node_pointer start = n1;
+          for (; n1 != end1; n1 = next_node(n1)) {
+            value_type const& v = n1->value();
+            if (!find_equiv(start, n1, v)) {
+              std::size_t matches = count_equal_equiv(n2, end2, v);
+              if (!matches)
+                return false;
+              if (matches != 1 + count_equal_equiv(next_node(n1), end1, v))
+                return false;
+            }
+          }
+
+          return true;
+        }
+
+#if BOOST_UNORDERED_GROUP_HASH
+        // Groups longer than this are compared by hashing their values, when
+        // std::hash is enabled for them.
+        static const std::size_t group_hash_threshold = 16;
+
+        static bool group_equals_hashed(node_pointer n1, node_pointer end1,
+          node_pointer n2, node_pointer end2, std::size_t, false_type)
+        {
+          return group_equals_counted(n1, end1, n2, end2);
+        }
+
+        // A distinct value from the second group, and the number of its
+        // elements that haven't been matched yet.
+        struct group_hash_slot
+        {
+          node_pointer node;
+          std::size_t count;
+        };
+
+        // The open addressing table for group_equals_hashed, allocated with
+        // the container's allocator.
+        struct group_hash_slots
         {
-          for (;;) {
-            if (n1->value() != n2->value())
-              break;
+          typedef typename boost::unordered::detail::rebind_wrap<
+            node_allocator, group_hash_slot>::type slot_allocator;
+          typedef boost::unordered::detail::allocator_traits<slot_allocator>
+            slot_allocator_traits;
 
-            n1 = next_node(n1);
-            n2 = next_node(n2);
+          slot_allocator alloc_;
+          std::size_t size_;
+          typename slot_allocator_traits::pointer slots_;
 
-            if (n1 == end1)
-              return n2 == end2;
-            if (n2 == end2)
-              return false;
+          group_hash_slots(node_allocator const& a, std::size_t size)
+              : alloc_(a), size_(size),
+                slots_(slot_allocator_traits::allocate(alloc_, size))
+          {
+            group_hash_slot* p = boost::to_address(slots_);
+            for (std::size_t i = 0; i < size_; ++i) {
+              new ((void*)(p + i)) group_hash_slot();
+            }
           }
 
-          for (node_pointer n1a = n1, n2a = n2;;) {
-            n1a = next_node(n1a);
-            n2a = next_node(n2a);
+          ~group_hash_slots()
+          {
+            group_hash_slot* p = boost::to_address(slots_);
+            for (std::size_t i = 0; i < size_; ++i) {
+              boost::unordered::detail::func::destroy(p + i);
+            }
+            slot_allocator_traits::deallocate(alloc_, slots_, size_);
+          }
 
-            if (n1a == end1) {
-              if (n2a == end2)
+          group_hash_slot& operator[](std::size_t i)
+          {
+            return boost::to_address(slots_)[i];
+          }
+
+        private:
+          group_hash_slots(group_hash_slots const&);
+          group_hash_slots& operator=(group_hash_slots const&);
+        };
+
+        // Puts each distinct value of the second group in an open addressing
+        // table, with a count of its elements. Then looks up each of the
+        // first group's values, and uses up one of the count. The groups
+        // have the same length, so if no value is missing or used up they're
+        // permutations of each other. Linear in the length, however many
+        // distinct values there are, but allocates the table.
+
+        bool group_equals_hashed(node_pointer n1, node_pointer end1,
+          node_pointer n2, node_pointer end2, std::size_t length,
+          true_type) const
+        {
+          typedef boost::unordered::detail::group_value_hash<value_type>
+            value_hash;
+          typedef typename boost::unordered::detail::pick_policy2<
+            typename value_hash::hashed_type>::type index_policy;
+
+          value_hash hf;
+          std::size_t const slot_count =
+            index_policy::new_bucket_count(length * 2);
+          int const size_index = index_policy::size_index(slot_count);
+          group_hash_slots slots(this->node_alloc(), slot_count);
+
+          for (; n2 != end2; n2 = next_node(n2)) {
+            value_type const& v = n2->value();
+            std::size_t i = index_policy::to_bucket(
+              slot_count, index_policy::apply_hash(hf, v), size_index);
+            for (;;) {
+              group_hash_slot& slot = slots[i];
+              if (!slot.node) {
+                slot.node = n2;
+                slot.count = 1;
                 break;
-              else
-                return false;
+              }
+              if (slot.node->value() == v) {
+                ++slot.count;
+                break;
+              }
+              i = i + 1 == slot_count ? 0 : i + 1;
             }
-
-            if (n2a == end2)
-              return false;
           }
 
-          node_pointer start = n1;
           for (; n1 != end1; n1 = next_node(n1)) {
             value_type const& v = n1->value();
-            if (!find_equiv(start, n1, v)) {
-              std::size_t matches = count_equal_equiv(n2, end2, v);
-              if (!matches)
-                return false;
-              if (matches != 1 + count_equal_equiv(next_node(n1), end1, v))
+            std::size_t i = index_policy::to_bucket(
+              slot_count, index_policy::apply_hash(hf, v), size_index);
+            for (;;) {
+              group_hash_slot& slot = slots[i];
+              if (!slot.node) {
                 return false;
+              }
+              if (slot.node->value() == v) {
+                if (!slot.count) {
+                  return false;
+                }
+                --slot.count;
+                break;
+              }
+              i = i + 1 == slot_count ? 0 : i + 1;
             }
           }
 
           return true;
         }
+#endif
 
         static bool find_equiv(
           node_pointer n, node_pointer end, value_type const& v)
@@ -3608,16 +5561,21 @@ namespace boost {
 
         // Emplace/Insert
 
+        // If pos isn't null, the node is added to its group, in its bucket.
+        // key_hash isn't used then, as the table might have been seeded
+        // since it was computed.
         inline node_pointer add_node_equiv(
           node_pointer n, std::size_t key_hash, node_pointer pos)
         {
-          std::size_t bucket_index = this->hash_to_bucket(key_hash);
+          std::size_t bucket_index =
+            pos ? pos->get_bucket() : this->hash_to_bucket(key_hash);
           n->bucket_info_ = bucket_index;
 
           if (pos) {
             n->reset_first_in_group();
             n->next_ = pos->next_;
             pos->next_ = n;
+            set_prev(n, pos);
             if (n->next_) {
               std::size_t next_bucket = this->node_bucket(next_node(n));
               if (next_bucket != bucket_index) {
@@ -3640,12 +5598,18 @@ namespace boost {
               b->next_ = start_node;
               n->next_ = start_node->next_;
               start_node->next_ = n;
+              set_prev(n, start_node);
             } else {
               n->next_ = b->next_->next_;
               b->next_->next_ = n;
+              set_prev(n, b->next_);
             }
           }
+          set_prev(next_node(n), n);
           ++this->size_;
+          if (!pos) {
+            this->check_chain(n);
+          }
           return n;
         }
 
@@ -3656,6 +5620,8 @@ namespace boost {
           n->reset_first_in_group();
           n->next_ = hint->next_;
           hint->next_ = n;
+          set_prev(n, hint);
+          set_prev(next_node(n), n);
           if (n->next_) {
             std::size_t next_bucket = this->node_bucket(next_node(n));
             if (next_bucket != this->node_bucket(n)) {
@@ -3713,8 +5679,9 @@ namespace boost {
             std::size_t key_hash = this->hash(k);
             node_pointer pos = this->find_node(key_hash, k);
             this->reserve_for_insert(this->size_ + 1);
-            result = iterator(this->add_node_equiv(np.ptr_, key_hash, pos));
+            node_pointer n = np.ptr_;
             np.ptr_ = node_pointer();
+            result = iterator(this->add_node_equiv(n, key_hash, pos));
           }
 
           return result;
@@ -3733,13 +5700,15 @@ namespace boost {
               this->reserve_for_insert(this->size_ + 1);
               result =
                 iterator(this->add_using_hint_equiv(np.ptr_, hint.node_));
+              np.ptr_ = node_pointer();
             } else {
               std::size_t key_hash = this->hash(k);
               node_pointer pos = this->find_node(key_hash, k);
               this->reserve_for_insert(this->size_ + 1);
-              result = iterator(this->add_node_equiv(np.ptr_, key_hash, pos));
+              node_pointer n = np.ptr_;
+              np.ptr_ = node_pointer();
+              result = iterator(this->add_node_equiv(n, key_hash, pos));
             }
-            np.ptr_ = node_pointer();
           }
 
           return result;
@@ -3760,7 +5729,7 @@ namespace boost {
           std::size_t distance = static_cast<std::size_t>(std::distance(i, j));
           if (distance == 1) {
             emplace_equiv(boost::unordered::detail::func::construct_node(
-              this->node_alloc(), *i));
+              this->node_source(), *i));
           } else {
             // Only require basic exception safety here
             this->reserve_for_insert(this->size_ + distance);
@@ -3768,7 +5737,7 @@ namespace boost {
             for (; i != j; ++i) {
               emplace_no_rehash_equiv(
                 boost::unordered::detail::func::construct_node(
-                  this->node_alloc(), *i));
+                  this->node_source(), *i));
             }
           }
         }
@@ -3779,7 +5748,7 @@ namespace boost {
         {
           for (; i != j; ++i) {
             emplace_equiv(boost::unordered::detail::func::construct_node(
-              this->node_alloc(), *i));
+              this->node_source(), *i));
           }
         }
 
@@ -3793,12 +5762,10 @@ namespace boost {
           node_pointer j(next_node(i));
           std::size_t bucket_index = this->node_bucket(i);
 
-          link_pointer prev = this->get_previous_start(bucket_index);
-          while (prev->next_ != i) {
-            prev = next_node(prev);
-          }
+          link_pointer prev = this->find_previous(i, bucket_index);
 
           prev->next_ = j;
+          set_prev(j, prev);
           if (j && i->is_first_in_group()) {
             j->set_first_in_group();
           }
@@ -3820,7 +5787,7 @@ namespace boost {
           if (!this->size_)
             return 0;
 
-          std::size_t key_hash = policy::apply_hash(this->hash_function(), k);
+          std::size_t key_hash = this->apply_hash(this->hash_function(), k);
           std::size_t bucket_index = this->hash_to_bucket(key_hash);
           link_pointer prev =
             this->find_previous_node_impl(eq, k, bucket_index);
@@ -3837,6 +5804,7 @@ namespace boost {
           } while (n && !n->is_first_in_group());
           size_ -= deleted_count;
           prev->next_ = n;
+          set_prev(n, prev);
           this->fix_bucket(bucket_index, prev, n);
           return deleted_count;
         }
@@ -3850,15 +5818,13 @@ namespace boost {
         {
           std::size_t bucket_index = this->node_bucket(i);
 
-          link_pointer prev = this->get_previous_start(bucket_index);
-          while (prev->next_ != i) {
-            prev = next_node(prev);
-          }
+          link_pointer prev = this->find_previous(i, bucket_index);
 
           // Delete the nodes.
           // Is it inefficient to call fix_bucket for every node?
           bool includes_first = false;
           prev->next_ = j;
+          set_prev(j, prev);
           do {
             includes_first = includes_first || i->is_first_in_group();
             node_pointer next = next_node(i);
@@ -3886,12 +5852,12 @@ namespace boost {
             node_pointer group_end(next_group(n));
             node_pointer pos = this->add_node_equiv(
               boost::unordered::detail::func::construct_node(
-                this->node_alloc(), n->value()),
+                this->node_source(), n->value()),
               key_hash, node_pointer());
             for (n = next_node(n); n != group_end; n = next_node(n)) {
               this->add_node_equiv(
                 boost::unordered::detail::func::construct_node(
-                  this->node_alloc(), n->value()),
+                  this->node_source(), n->value()),
                 key_hash, pos);
             }
           }
@@ -3993,19 +5959,559 @@ namespace boost {
         }
       }
 
+      // Allocate enough spare nodes for the container to hold 'size'
+      // elements. They're appended in allocation order so that subsequent
+      // inserts use them in the same order.
+      //
+      // basic exception safety, any nodes allocated before an exception
+      // remain in the spare list.
+
+      template <typename Types>
+      inline void table<Types>::reserve_nodes(std::size_t size)
+      {
+        std::size_t available = size_;
+        node_pointer last = node_pointer();
+        for (node_pointer n = spare_nodes_; n && available < size;
+             n = static_cast<node_pointer>(n->next_)) {
+          ++available;
+          last = n;
+        }
+
+        for (; available < size; ++available) {
+          node_pointer n = node_allocator_traits::allocate(node_alloc(), 1);
+          new ((void*)boost::to_address(n)) node();
+          if (last) {
+            last->next_ = n;
+          } else {
+            spare_nodes_ = n;
+          }
+          last = n;
+        }
+      }
+
+      // Reallocate all the nodes in iteration order, so that walking the
+      // node list, or a bucket, touches memory as sequentially as the
+      // allocator allows. The new nodes are all allocated before any of the
+      // old ones are freed, so that they aren't scattered into the holes left
+      // behind.
+      //
+      // Strong exception safety, as long as the value type is nothrow move
+      // constructible or copy constructible.
+
+      template <typename Types> inline void table<Types>::compact()
+      {
+        if (!size_) {
+          return;
+        }
+
+        node_pointer nodes = node_pointer();
+        node_pointer last = node_pointer();
+        std::size_t constructed = 0;
+
+        BOOST_TRY
+        {
+          for (std::size_t i = 0; i < size_; ++i) {
+            node_pointer n = node_allocator_traits::allocate(node_alloc(), 1);
+            new ((void*)boost::to_address(n)) node();
+            if (last) {
+              last->next_ = n;
+            } else {
+              nodes = n;
+            }
+            last = n;
+          }
+
+          node_pointer n2 = nodes;
+          for (node_pointer n = begin(); n; n = next_node(n)) {
+            BOOST_UNORDERED_CALL_CONSTRUCT1(node_allocator_traits,
+              node_alloc(), n2->value_ptr(),
+              boost::move_if_noexcept(n->value()));
+            n2->bucket_info_ = n->bucket_info_;
+            ++constructed;
+            n2 = next_node(n2);
+          }
+        }
+        BOOST_CATCH(...)
+        {
+          while (nodes) {
+            node_pointer next = next_node(nodes);
+            if (constructed) {
+              BOOST_UNORDERED_CALL_DESTROY(
+                node_allocator_traits, node_alloc(), nodes->value_ptr());
+              --constructed;
+            }
+            boost::unordered::detail::func::destroy(
+              boost::to_address(nodes));
+            node_allocator_traits::deallocate(node_alloc(), nodes, 1);
+            nodes = next;
+          }
+          BOOST_RETHROW
+        }
+        BOOST_CATCH_END
+
+        // nothrow from here...
+        link_pointer prev = get_previous_start();
+        node_pointer n = next_node(prev);
+        prev->next_ = nodes;
+        while (n) {
+          node_pointer next = next_node(n);
+          destroy_node(n);
+          n = next;
+        }
+
+        // The nodes are in the same order, so only the buckets' links to
+        // the node before their first node need to be updated.
+        clear_buckets();
+        std::size_t last_bucket = bucket_count_;
+        for (n = nodes; n; n = next_node(n)) {
+          std::size_t n_bucket = n->get_bucket();
+          if (n_bucket != last_bucket) {
+            get_bucket_pointer(n_bucket)->next_ = prev;
+            last_bucket = n_bucket;
+          }
+          set_prev(n, prev);
+          prev = n;
+        }
+      }
+
+#if BOOST_UNORDERED_PARALLEL
+      // The nodes are erased in two passes. Each bucket is only modified by
+      // the thread it belongs to, except for the link from the node before
+      // its first node. That node belongs to another bucket, so the links
+      // between buckets are only rebuilt in the second pass.
+      //
+      // 1. Each thread unlinks the nodes to erase from within its buckets,
+      //    and records the first and last remaining node of each bucket, and
+      //    the bucket that followed it in the node list. It doesn't write to
+      //    the last node of a bucket, which is how the next bucket is found,
+      //    or free any nodes.
+      // 2. Each thread links the last remaining node of each of its buckets
+      //    to the first remaining node of the next bucket in the list that
+      //    still has any, and frees its erased nodes.
+      //
+      // If the predicate throws, the rest of that thread's nodes are kept,
+      // and the exception is rethrown after both passes are complete.
+
+      template <typename Types>
+      template <class NodePredicate>
+      std::size_t table<Types>::parallel_erase_nodes_if(
+        NodePredicate& pred, std::size_t num_threads)
+      {
+        if (!size_) {
+          return 0;
+        }
+
+        num_threads = parallel_threads(num_threads);
+        std::size_t const no_bucket = bucket_count_;
+
+        std::vector<node_pointer> firsts(bucket_count_);
+        std::vector<node_pointer> lasts(bucket_count_);
+        std::vector<std::size_t> nexts(bucket_count_);
+        std::vector<std::vector<node_pointer> > erased(num_threads);
+        std::vector<std::exception_ptr> errors(num_threads);
+
+        link_pointer start = this->get_previous_start();
+        std::size_t const first_bucket =
+          this->node_bucket(next_node(start));
+
+        // 1. Unlink the nodes within each bucket.
+
+        run_on_buckets(num_threads, [&](std::size_t t, std::size_t first,
+                                      std::size_t last) {
+          for (std::size_t b = first; b != last; ++b) {
+            nexts[b] = no_bucket;
+            node_pointer n = this->begin(b);
+            node_pointer first_node = node_pointer();
+            node_pointer last_node = node_pointer();
+
+            // Set when the first node of a group is erased, so that the
+            // next remaining node of the group can replace it.
+            bool promote = false;
+
+            for (; n && this->node_bucket(n) == b; n = next_node(n)) {
+              bool const group_start = n->is_first_in_group();
+              bool erase = false;
+              if (!errors[t]) {
+                BOOST_TRY
+                {
+                  if (pred(n)) {
+                    erased[t].push_back(n);
+                    erase = true;
+                  }
+                }
+                BOOST_CATCH(...) { errors[t] = std::current_exception(); }
+                BOOST_CATCH_END
+              }
+
+              if (erase) {
+                promote = promote || group_start;
+              } else {
+                if (promote && !group_start) {
+                  n->set_first_in_group();
+                }
+                promote = false;
+
+                if (!last_node) {
+                  first_node = n;
+                } else if (last_node->next_ != n) {
+                  last_node->next_ = n;
+                  set_prev(n, last_node);
+                }
+                last_node = n;
+              }
+            }
+
+            firsts[b] = first_node;
+            lasts[b] = last_node;
+            if (n) {
+              nexts[b] = this->node_bucket(n);
+            }
+          }
+        });
+
+        // 2. Link the buckets together, and free the erased nodes.
+
+        run_on_buckets(num_threads, [&](std::size_t t, std::size_t first,
+                                      std::size_t last) {
+          for (std::size_t b = first; b != last; ++b) {
+            if (!lasts[b]) {
+              bucket_pointer bp = this->get_bucket_pointer(b);
+              if (bp->next_) {
+                bp->next_ = link_pointer();
+              }
+              continue;
+            }
+
+            std::size_t next = nexts[b];
+            while (next != no_bucket && !firsts[next]) {
+              next = nexts[next];
+            }
+
+            if (next == no_bucket) {
+              lasts[b]->next_ = link_pointer();
+            } else {
+              lasts[b]->next_ = firsts[next];
+              set_prev(firsts[next], lasts[b]);
+              this->get_bucket_pointer(next)->next_ = lasts[b];
+            }
+          }
+
+          for (std::size_t i = 0; i < erased[t].size(); ++i) {
+            this->destroy_node(erased[t][i]);
+          }
+        });
+
+        std::size_t next = first_bucket;
+        while (next != no_bucket && !firsts[next]) {
+          next = nexts[next];
+        }
+        if (next == no_bucket) {
+          start->next_ = link_pointer();
+        } else {
+          start->next_ = firsts[next];
+          set_prev(firsts[next], start);
+          this->get_bucket_pointer(next)->next_ = start;
+        }
+
+        std::size_t count = 0;
+        for (std::size_t t = 0; t < num_threads; ++t) {
+          count += erased[t].size();
+        }
+        size_ -= count;
+
+        for (std::size_t t = 0; t < num_threads; ++t) {
+          if (errors[t]) {
+            std::rethrow_exception(errors[t]);
+          }
+        }
+        return count;
+      }
+#endif
+
+#if BOOST_UNORDERED_PARALLEL
+      // Parallel insert for containers with unique keys:
+      //
+      // 1. The keys are hashed in parallel, and the elements are partitioned
+      //    by the range of buckets that they belong to. Each partition keeps
+      //    the original order of its elements.
+      // 2. Each thread looks up the elements of one partition and constructs
+      //    the new ones into a chain for each bucket, private to the thread.
+      //    Nothing in the table is written to, so the existing nodes can be
+      //    read without any locking.
+      // 3. Each thread splices its chains into its own buckets. The new nodes
+      //    of buckets that already had elements go after the bucket's first
+      //    node, which only the bucket's thread writes to. Previously empty
+      //    buckets are linked into one chain per thread.
+      // 4. Finally, those chains are added to the start of the node list.
+      //
+      // Since each partition is processed in order, the first of any
+      // equivalent elements is the one that's inserted, as with a serial
+      // insert. If an exception is thrown by the hash function, no elements
+      // are inserted. If one is thrown while constructing a node, the nodes
+      // that were already constructed are inserted before it's rethrown.
+
+      template <typename Types>
+      template <class InputIt>
+      void table<Types>::insert_range_unique_parallel(
+        const_key_type& k, InputIt first, InputIt last, std::size_t num_threads)
+      {
+        if (!boost::unordered::detail::is_forward<InputIt>::value) {
+          insert_range_unique(k, first, last);
+          return;
+        }
+
+        std::vector<InputIt> elements;
+        for (InputIt it = first; it != last; ++it) {
+          elements.push_back(it);
+        }
+
+        std::size_t const num_elements = elements.size();
+        num_threads =
+          boost::unordered::detail::parallel_thread_count(num_threads, num_elements);
+        if (num_threads <= 1) {
+          insert_range_unique(k, first, last);
+          return;
+        }
+
+        // Create enough buckets for the whole range up front, so that the
+        // bucket indexes don't change.
+        this->reserve_for_insert(size_ + num_elements);
+
+        std::size_t const per_thread =
+          (num_elements + num_threads - 1) / num_threads;
+        std::size_t const buckets_per_thread =
+          (bucket_count_ + num_threads - 1) / num_threads;
+
+        // 1. Hash and partition.
+
+        std::vector<std::size_t> hashes(num_elements);
+        std::vector<std::size_t> offsets(num_threads * num_threads);
+        std::vector<std::size_t> order(num_elements);
+
+        std::exception_ptr error = boost::unordered::detail::run_in_parallel(
+          num_threads, [&](std::size_t t) {
+            std::size_t const end =
+              (std::min)(num_elements, (t + 1) * per_thread);
+            for (std::size_t i = t * per_thread; i < end; ++i) {
+              hashes[i] = this->hash(extractor::extract(*elements[i]));
+              ++offsets[t * num_threads +
+                        this->hash_to_bucket(hashes[i]) / buckets_per_thread];
+            }
+          });
+        if (error) {
+          std::rethrow_exception(error);
+        }
+
+        std::vector<std::size_t> partition_start(num_threads + 1);
+        std::size_t total = 0;
+        for (std::size_t p = 0; p < num_threads; ++p) {
+          partition_start[p] = total;
+          for (std::size_t t = 0; t < num_threads; ++t) {
+            std::size_t const count = offsets[t * num_threads + p];
+            offsets[t * num_threads + p] = total;
+            total += count;
+          }
+        }
+        partition_start[num_threads] = total;
+
+        boost::unordered::detail::run_in_parallel(
+          num_threads, [&](std::size_t t) {
+            std::size_t const end =
+              (std::min)(num_elements, (t + 1) * per_thread);
+            for (std::size_t i = t * per_thread; i < end; ++i) {
+              order[offsets[t * num_threads +
+                            this->hash_to_bucket(hashes[i]) /
+                              buckets_per_thread]++] = i;
+            }
+          });
+
+        // 2. Construct the new nodes.
+
+        struct new_nodes
+        {
+          std::size_t bucket_index;
+          node_pointer first; // the bucket's first node before the insert
+          node_pointer head;
+          node_pointer tail;
+        };
+
+        struct partition
+        {
+          std::vector<new_nodes> buckets;
+          std::size_t size;
+          node_pointer head; // chain of previously empty buckets
+          node_pointer tail;
+        };
+
+        std::vector<partition> partitions(num_threads);
+
+        error = boost::unordered::detail::run_in_parallel(
+          num_threads, [&](std::size_t t) {
+            partition& part = partitions[t];
+            part.size = 0;
+
+            std::size_t const first_bucket = t * buckets_per_thread;
+            std::size_t const last_bucket =
+              (std::min)(bucket_count_, first_bucket + buckets_per_thread);
+            if (first_bucket >= last_bucket) {
+              return;
+            }
+
+            // Index + 1 of each bucket's entry in 'part.buckets'.
+            std::vector<std::size_t> slots(last_bucket - first_bucket);
+
+            for (std::size_t o = partition_start[t];
+                 o != partition_start[t + 1]; ++o) {
+              std::size_t const i = order[o];
+              const_key_type& key = extractor::extract(*elements[i]);
+              std::size_t const bucket_index = this->hash_to_bucket(hashes[i]);
+
+              if (this->find_node_impl(hashes[i], key, this->key_eq())) {
+                continue;
+              }
+
+              std::size_t& slot = slots[bucket_index - first_bucket];
+              if (slot) {
+                node_pointer n = part.buckets[slot - 1].head;
+                while (n && !this->key_eq()(key, this->get_key(n))) {
+                  n = next_node(n);
+                }
+                if (n) {
+                  continue;
+                }
+              } else {
+                new_nodes b = {
+                  bucket_index, this->begin(bucket_index), node_pointer(),
+                  node_pointer()};
+                part.buckets.push_back(b);
+                slot = part.buckets.size();
+              }
+
+              node_constructor a(this->node_alloc());
+              a.create_node();
+              BOOST_UNORDERED_CALL_CONSTRUCT1(node_allocator_traits,
+                a.alloc_, a.node_->value_ptr(), *elements[i]);
+              node_pointer n = a.release();
+              n->bucket_info_ = bucket_index;
+              n->set_first_in_group();
+
+              new_nodes& b = part.buckets[slot - 1];
+              n->next_ = b.head;
+              set_prev(b.head, n);
+              b.head = n;
+              if (!b.tail) {
+                b.tail = n;
+              }
+              ++part.size;
+            }
+          });
+
+        // 3. Link them into their buckets, this doesn't throw.
+
+        boost::unordered::detail::run_in_parallel(
+          num_threads, [&](std::size_t t) {
+            partition& part = partitions[t];
+            part.head = node_pointer();
+            part.tail = node_pointer();
+
+            for (std::size_t i = 0; i < part.buckets.size(); ++i) {
+              new_nodes& b = part.buckets[i];
+              if (!b.head) {
+                continue;
+              }
+
+              if (b.first) {
+                node_pointer next = next_node(b.first);
+                b.tail->next_ = next;
+                set_prev(next, b.tail);
+                b.first->next_ = b.head;
+                set_prev(b.head, b.first);
+                if (next && this->node_bucket(next) != b.bucket_index) {
+                  this->get_bucket_pointer(this->node_bucket(next))->next_ =
+                    b.tail;
+                }
+              } else if (part.tail) {
+                part.tail->next_ = b.head;
+                set_prev(b.head, part.tail);
+                this->get_bucket_pointer(b.bucket_index)->next_ = part.tail;
+                part.tail = b.tail;
+              } else {
+                part.head = b.head;
+                part.tail = b.tail;
+              }
+            }
+          });
+
+        // 4. Add the chains of previously empty buckets to the start of the
+        // node list.
+
+        for (std::size_t t = 0; t < num_threads; ++t) {
+          partition& part = partitions[t];
+          size_ += part.size;
+          if (!part.head) {
+            continue;
+          }
+
+          link_pointer start = this->get_previous_start();
+          node_pointer next = next_node(start);
+          part.tail->next_ = next;
+          set_prev(next, part.tail);
+          if (next) {
+            this->get_bucket_pointer(this->node_bucket(next))->next_ =
+              part.tail;
+          }
+          start->next_ = part.head;
+          set_prev(part.head, start);
+          this->get_bucket_pointer(this->node_bucket(part.head))->next_ =
+            start;
+        }
+
+        // 5. Now that the nodes are linked, check the chains that grew, as a
+        // serial insert would.
+
+        if (adaptive_hash::value) {
+          for (std::size_t t = 0; t < num_threads && !this->hash_seed(); ++t) {
+            partition& part = partitions[t];
+            for (std::size_t i = 0; i < part.buckets.size(); ++i) {
+              if (part.buckets[i].head) {
+                this->check_chain(this->begin(part.buckets[i].bucket_index));
+              }
+            }
+          }
+        }
+
+        if (error) {
+          std::rethrow_exception(error);
+        }
+      }
+#endif
+
       template <typename Types>
       inline void table<Types>::rehash_impl(std::size_t num_buckets)
       {
         BOOST_ASSERT(this->buckets_);
 
         this->create_buckets(num_buckets);
+        this->rehash_nodes();
+      }
+
+      // Links the nodes into the buckets, which must all be empty.
+      //
+      // basic exception safety if the hash function throws, nothrow
+      // otherwise.
+
+      template <typename Types> inline void table<Types>::rehash_nodes()
+      {
         link_pointer prev = this->get_previous_start();
         BOOST_TRY
         {
           while (prev->next_) {
             node_pointer n = next_node(prev);
+            boost::unordered::detail::func::prefetch(n->next_);
             std::size_t key_hash = this->hash(this->get_key(n));
             std::size_t bucket_index = this->hash_to_bucket(key_hash);
+            bucket_pointer b = this->get_bucket_pointer(bucket_index);
+            boost::unordered::detail::func::prefetch(b);
 
             n->bucket_info_ = bucket_index;
             n->set_first_in_group();
@@ -4023,7 +6529,6 @@ namespace boost {
             }
 
             // n is now the last node in the group
-            bucket_pointer b = this->get_bucket_pointer(bucket_index);
             if (!b->next_) {
               b->next_ = prev;
               prev = n;
@@ -4032,6 +6537,9 @@ namespace boost {
               n->next_ = b->next_->next_;
               b->next_->next_ = prev->next_;
               prev->next_ = next;
+              set_prev(next_node(b->next_), b->next_);
+              set_prev(next_node(n), n);
+              set_prev(next_node(prev), prev);
             }
           }
         }
@@ -4081,6 +6589,30 @@ namespace boost {
           then<Key const&, no_key>::type type;
       };
 
+      // 'key_from<Key, T>::type' is what a key is extracted as from an
+      // argument of type 'T'. That's a reference when 'T' is the key type,
+      // and a converted copy when both are arithmetic types, as converting
+      // them has no side effects and gives the same key the node would have.
+      // Otherwise the node has to be constructed to find out the key.
+
+      template <typename Key, typename T> struct key_from
+      {
+        typedef typename boost::remove_cv<
+          typename boost::remove_reference<T>::type>::type arg_type;
+
+        enum
+        {
+          convert = boost::is_arithmetic<Key>::value &&
+                    boost::is_arithmetic<arg_type>::value
+        };
+
+        typedef typename boost::detail::if_true<
+          is_key<Key, T>::value>::BOOST_NESTED_TEMPLATE
+          then<Key const&,
+            typename boost::detail::if_true<convert>::BOOST_NESTED_TEMPLATE
+              then<Key, no_key>::type>::type type;
+      };
+
       template <class ValueType> struct set_extractor
       {
         typedef ValueType value_type;
@@ -4095,9 +6627,10 @@ namespace boost {
 
         static no_key extract() { return no_key(); }
 
-        template <class Arg> static no_key extract(Arg const&)
+        template <class Arg>
+        static typename key_from<key_type, Arg>::type extract(Arg const& arg)
         {
-          return no_key();
+          return typename key_from<key_type, Arg>::type(arg);
         }
 
 #if !defined(BOOST_NO_CXX11_VARIADIC_TEMPLATES)
@@ -4123,41 +6656,24 @@ namespace boost {
 
         static key_type const& extract(value_type const& v) { return v.first; }
 
-        template <class Second>
-        static key_type const& extract(std::pair<key_type, Second> const& v)
-        {
-          return v.first;
-        }
-
-        template <class Second>
-        static key_type const& extract(
-          std::pair<key_type const, Second> const& v)
+        // Pairs that aren't 'value_type', such as ones with a different
+        // mapped type or a reference to the key.
+        template <class First, class Second>
+        static typename key_from<key_type, First>::type extract(
+          std::pair<First, Second> const& v)
         {
-          return v.first;
+          return typename key_from<key_type, First>::type(v.first);
         }
 
 #if defined(BOOST_NO_CXX11_RVALUE_REFERENCES)
-        template <class Second>
-        static key_type const& extract(
-          boost::rv<std::pair<key_type, Second> > const& v)
-        {
-          return v.first;
-        }
-
-        template <class Second>
-        static key_type const& extract(
-          boost::rv<std::pair<key_type const, Second> > const& v)
+        template <class First, class Second>
+        static typename key_from<key_type, First>::type extract(
+          boost::rv<std::pair<First, Second> > const& v)
         {
-          return v.first;
+          return typename key_from<key_type, First>::type(v.first);
         }
 #endif
 
-        template <class Arg1>
-        static key_type const& extract(key_type const& k, Arg1 const&)
-        {
-          return k;
-        }
-
         static no_key extract() { return no_key(); }
 
         template <class Arg> static no_key extract(Arg const&)
@@ -4165,10 +6681,12 @@ namespace boost {
           return no_key();
         }
 
+        // A key and the arguments for the mapped value.
         template <class Arg1, class Arg2>
-        static no_key extract(Arg1 const&, Arg2 const&)
+        static typename key_from<key_type, Arg1>::type extract(
+          Arg1 const& k, Arg2 const&)
         {
-          return no_key();
+          return typename key_from<key_type, Arg1>::type(k);
         }
 
 #if !defined(BOOST_NO_CXX11_VARIADIC_TEMPLATES)
@@ -4191,11 +6709,11 @@ namespace boost {
   }                                                                            \
                                                                                \
   template <typename T, typename T2>                                           \
-  static typename is_key<key_type, T>::type extract(                           \
+  static typename key_from<key_type, T>::type extract(                         \
     boost::unordered::piecewise_construct_t, namespace_ tuple<T> const& k,     \
     T2 const&)                                                                 \
   {                                                                            \
-    return typename is_key<key_type, T>::type(namespace_ get<0>(k));           \
+    return typename key_from<key_type, T>::type(namespace_ get<0>(k));         \
   }
 
 #else
@@ -4208,10 +6726,10 @@ namespace boost {
   }                                                                            \
                                                                                \
   template <typename T>                                                        \
-  static typename is_key<key_type, T>::type extract(                           \
+  static typename key_from<key_type, T>::type extract(                         \
     boost::unordered::piecewise_construct_t, namespace_ tuple<T> const& k)     \
   {                                                                            \
-    return typename is_key<key_type, T>::type(namespace_ get<0>(k));           \
+    return typename key_from<key_type, T>::type(namespace_ get<0>(k));         \
   }
 
 #endif
@@ -4225,15 +6743,47 @@ namespace boost {
 #undef BOOST_UNORDERED_KEY_FROM_TUPLE
       };
 
+      // The update used by batch_insert_or_assign: replaces the mapped value.
+      struct assign_mapped
+      {
+        template <class Mapped, class Value>
+        void operator()(Mapped& x, BOOST_FWD_REF(Value) v) const
+        {
+          x = boost::forward<Value>(v);
+        }
+      };
+
+      ////////////////////////////////////////////////////////////////////////
+      // Back links
+      //
+      // A base of the node types, holding the link to the previous node when
+      // the hash function's link policy is back_links, and empty otherwise.
+
+      template <typename LinkPointer, bool BackLinks> struct node_back_link
+      {
+      };
+
+      template <typename LinkPointer> struct node_back_link<LinkPointer, true>
+      {
+        LinkPointer prev_;
+
+        node_back_link() : prev_() {}
+      };
+
       ////////////////////////////////////////////////////////////////////////
       // Unique nodes
 
-      template <typename A, typename T>
-      struct node : boost::unordered::detail::value_base<T>
+      template <typename A, typename T, bool BackLinks>
+      struct node
+          : boost::unordered::detail::value_base<T>,
+            boost::unordered::detail::node_back_link<
+              typename ::boost::unordered::detail::allocator_traits<
+                typename ::boost::unordered::detail::rebind_wrap<A,
+                  node<A, T, BackLinks> >::type>::pointer,
+              BackLinks>
       {
-        typedef
-          typename ::boost::unordered::detail::rebind_wrap<A, node<A, T> >::type
-            allocator;
+        typedef typename ::boost::unordered::detail::rebind_wrap<A,
+          node<A, T, BackLinks> >::type allocator;
         typedef typename ::boost::unordered::detail::allocator_traits<
           allocator>::pointer node_pointer;
         typedef node_pointer link_pointer;
@@ -4271,12 +6821,14 @@ namespace boost {
         node& operator=(node const&);
       };
 
-      template <typename T>
-      struct ptr_node : boost::unordered::detail::ptr_bucket
+      template <typename T, bool BackLinks>
+      struct ptr_node : boost::unordered::detail::ptr_bucket,
+                        boost::unordered::detail::node_back_link<
+                          boost::unordered::detail::ptr_bucket*, BackLinks>
       {
         typedef T value_type;
         typedef boost::unordered::detail::ptr_bucket bucket_base;
-        typedef ptr_node<T>* node_pointer;
+        typedef ptr_node<T, BackLinks>* node_pointer;
         typedef ptr_bucket* link_pointer;
         typedef ptr_bucket* bucket_pointer;
 
@@ -4316,10 +6868,11 @@ namespace boost {
       // If the allocator uses raw pointers use ptr_node
       // Otherwise use node.
 
-      template <typename A, typename T, typename NodePtr, typename BucketPtr>
+      template <typename A, typename T, bool BackLinks, typename NodePtr,
+        typename BucketPtr>
       struct pick_node2
       {
-        typedef boost::unordered::detail::node<A, T> node;
+        typedef boost::unordered::detail::node<A, T, BackLinks> node;
 
         typedef typename boost::unordered::detail::allocator_traits<
           typename boost::unordered::detail::rebind_wrap<A,
@@ -4329,22 +6882,24 @@ namespace boost {
         typedef node_pointer link_pointer;
       };
 
-      template <typename A, typename T>
-      struct pick_node2<A, T, boost::unordered::detail::ptr_node<T>*,
+      template <typename A, typename T, bool BackLinks>
+      struct pick_node2<A, T, BackLinks,
+        boost::unordered::detail::ptr_node<T, BackLinks>*,
         boost::unordered::detail::ptr_bucket*>
       {
-        typedef boost::unordered::detail::ptr_node<T> node;
+        typedef boost::unordered::detail::ptr_node<T, BackLinks> node;
         typedef boost::unordered::detail::ptr_bucket bucket;
         typedef bucket* link_pointer;
       };
 
-      template <typename A, typename T> struct pick_node
+      template <typename A, typename T, bool BackLinks = false>
+      struct pick_node
       {
         typedef typename boost::remove_const<T>::type nonconst;
 
         typedef boost::unordered::detail::allocator_traits<
           typename boost::unordered::detail::rebind_wrap<A,
-            boost::unordered::detail::ptr_node<nonconst> >::type>
+            boost::unordered::detail::ptr_node<nonconst, BackLinks> >::type>
           tentative_node_traits;
 
         typedef boost::unordered::detail::allocator_traits<
@@ -4352,7 +6907,8 @@ namespace boost {
             boost::unordered::detail::ptr_bucket>::type>
           tentative_bucket_traits;
 
-        typedef pick_node2<A, nonconst, typename tentative_node_traits::pointer,
+        typedef pick_node2<A, nonconst, BackLinks,
+          typename tentative_node_traits::pointer,
           typename tentative_bucket_traits::pointer>
           pick;
 
@@ -0,0 +1,677 @@
+
+// Copyright 2022 Christian Mazakas.
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_UNORDERED_DETAIL_INTEGER_FLAT_TABLE_HPP
+#define BOOST_UNORDERED_DETAIL_INTEGER_FLAT_TABLE_HPP
+
+#include <boost/config.hpp>
+#if defined(BOOST_HAS_PRAGMA_ONCE)
+#pragma once
+#endif
+
+#include <boost/unordered/detail/implementation.hpp>
+
+#if !defined(BOOST_NO_CXX11_RVALUE_REFERENCES) &&                              \
+  !defined(BOOST_NO_CXX11_VARIADIC_TEMPLATES)
+
+#include <boost/static_assert.hpp>
+#include <boost/type_traits/is_integral.hpp>
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+// BOOST_UNORDERED_SIMD
+//
+// Compare the keys of integer_flat_set and integer_flat_map a group at a
+// time with AVX2 (2) or SSE2 (1) instructions, rather than one at a time.
+// Picked from the compiler's target options; define to 0 to use a loop.
+
+#if !defined(BOOST_UNORDERED_SIMD)
+#if defined(__AVX2__)
+#define BOOST_UNORDERED_SIMD 2
+#elif defined(__SSE2__) || defined(_M_X64) ||                                 \
+  (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BOOST_UNORDERED_SIMD 1
+#else
+#define BOOST_UNORDERED_SIMD 0
+#endif
+#endif
+
+#if BOOST_UNORDERED_SIMD == 2
+#include <immintrin.h>
+#elif BOOST_UNORDERED_SIMD == 1
+#include <emmintrin.h>
+#endif
+
+namespace boost {
+  namespace unordered {
+    namespace detail {
+
+      ////////////////////////////////////////////////////////////////////////
+      // Integer flat table
+      //
+      // The keys are stored in an open addressed array, in groups of 8, with
+      // the mapped values, if any, in a parallel array. A key hashes to a
+      // group, and the groups after it are probed in turn, comparing the
+      // whole group at once. Two key values mark the slots that aren't in
+      // use: 0 for an empty slot and 1 for a slot whose element was erased.
+      // Keys 0 and 1 themselves are stored in two extra slots after the
+      // array.
+      //
+      // A lookup stops at the first group with an empty slot, so erasing
+      // from a full group leaves a deleted slot instead, which insertion
+      // can reuse. Deleted slots are cleared when the array is rehashed.
+
+      static const std::size_t integer_group_size = 8;
+
+      // 'match' returns a mask with bit 'i' set when the 'i'th key of the
+      // group at 'p' is equal to 'k'.
+
+      template <std::size_t KeySize> struct integer_group;
+
+      template <> struct integer_group<4>
+      {
+        typedef boost::uint32_t word;
+
+        static unsigned match(void const* p, word k)
+        {
+#if BOOST_UNORDERED_SIMD == 2
+          __m256i const x = _mm256_cmpeq_epi32(
+            _mm256_loadu_si256(static_cast<__m256i const*>(p)),
+            _mm256_set1_epi32(static_cast<int>(k)));
+          return static_cast<unsigned>(
+            _mm256_movemask_ps(_mm256_castsi256_ps(x)));
+#elif BOOST_UNORDERED_SIMD == 1
+          __m128i const* q = static_cast<__m128i const*>(p);
+          __m128i const key = _mm_set1_epi32(static_cast<int>(k));
+          __m128i const lo = _mm_cmpeq_epi32(_mm_loadu_si128(q), key);
+          __m128i const hi = _mm_cmpeq_epi32(_mm_loadu_si128(q + 1), key);
+          return static_cast<unsigned>(
+            _mm_movemask_ps(_mm_castsi128_ps(lo)) |
+            (_mm_movemask_ps(_mm_castsi128_ps(hi)) << 4));
+#else
+          word const* w = static_cast<word const*>(p);
+          unsigned m = 0;
+          for (unsigned i = 0; i < integer_group_size; ++i) {
+            m |= static_cast<unsigned>(w[i] == k) << i;
+          }
+          return m;
+#endif
+        }
+      };
+
+      template <> struct integer_group<8>
+      {
+        typedef boost::uint64_t word;
+
+#if BOOST_UNORDERED_SIMD == 1
+        // Gathers the low and the high halves of the four 64 bit lanes of
+        // two 32 bit comparisons, so that a lane is set when both are.
+        static int half_match(__m128i a, __m128i b)
+        {
+          __m128 const x = _mm_castsi128_ps(a);
+          __m128 const y = _mm_castsi128_ps(b);
+          return _mm_movemask_ps(
+            _mm_and_ps(_mm_shuffle_ps(x, y, _MM_SHUFFLE(2, 0, 2, 0)),
+              _mm_shuffle_ps(x, y, _MM_SHUFFLE(3, 1, 3, 1))));
+        }
+#endif
+
+        static unsigned match(void const* p, word k)
+        {
+#if BOOST_UNORDERED_SIMD == 2
+          __m256i const* q = static_cast<__m256i const*>(p);
+          __m256i const key = _mm256_set1_epi64x(static_cast<long long>(k));
+          __m256i const lo = _mm256_cmpeq_epi64(_mm256_loadu_si256(q), key);
+          __m256i const hi =
+            _mm256_cmpeq_epi64(_mm256_loadu_si256(q + 1), key);
+          return static_cast<unsigned>(
+            _mm256_movemask_pd(_mm256_castsi256_pd(lo)) |
+            (_mm256_movemask_pd(_mm256_castsi256_pd(hi)) << 4));
+#elif BOOST_UNORDERED_SIMD == 1
+          // SSE2 only compares 32 bit lanes, so a 64 bit lane is equal when
+          // both its halves are.
+          __m128i const* q = static_cast<__m128i const*>(p);
+          __m128i const key = _mm_set1_epi64x(static_cast<long long>(k));
+          return static_cast<unsigned>(
+            half_match(_mm_cmpeq_epi32(_mm_loadu_si128(q), key),
+              _mm_cmpeq_epi32(_mm_loadu_si128(q + 1), key)) |
+            (half_match(_mm_cmpeq_epi32(_mm_loadu_si128(q + 2), key),
+               _mm_cmpeq_epi32(_mm_loadu_si128(q + 3), key))
+              << 4));
+#else
+          word const* w = static_cast<word const*>(p);
+          unsigned m = 0;
+          for (unsigned i = 0; i < integer_group_size; ++i) {
+            m |= static_cast<unsigned>(w[i] == k) << i;
+          }
+          return m;
+#endif
+        }
+      };
+
+      // The mapped values of integer_flat_map, in an array parallel to the
+      // keys. integer_flat_set uses the void specialization, which stores
+      // nothing.
+
+      template <typename M, typename A> struct integer_flat_values
+      {
+        typedef typename boost::unordered::detail::rebind_wrap<A, M>::type
+          allocator;
+        typedef boost::unordered::detail::allocator_traits<allocator> traits;
+
+        BOOST_STATIC_ASSERT(
+          (boost::is_same<typename traits::pointer, M*>::value));
+
+        M* values_;
+
+        integer_flat_values() : values_() {}
+
+        M& operator[](std::size_t i) const { return values_[i]; }
+
+        void allocate(A const& a, std::size_t n)
+        {
+          allocator al(a);
+          values_ = traits::allocate(al, n);
+        }
+
+        void deallocate(A const& a, std::size_t n)
+        {
+          if (values_) {
+            allocator al(a);
+            traits::deallocate(al, values_, n);
+            values_ = 0;
+          }
+        }
+
+        template <class... Args>
+        void construct(A const& a, std::size_t i, Args&&... args)
+        {
+          allocator al(a);
+          traits::construct(al, values_ + i, std::forward<Args>(args)...);
+        }
+
+        void destroy(A const& a, std::size_t i)
+        {
+          allocator al(a);
+          traits::destroy(al, values_ + i);
+        }
+
+        void copy(A const& a, std::size_t i, integer_flat_values const& x,
+          std::size_t j)
+        {
+          this->construct(a, i, x.values_[j]);
+        }
+
+        void move(
+          A const& a, std::size_t i, integer_flat_values& x, std::size_t j)
+        {
+          this->construct(a, i, std::move(x.values_[j]));
+        }
+
+        void swap(integer_flat_values& x) { boost::swap(values_, x.values_); }
+      };
+
+      template <typename A> struct integer_flat_values<void, A>
+      {
+        void allocate(A const&, std::size_t) {}
+        void deallocate(A const&, std::size_t) {}
+        void construct(A const&, std::size_t) {}
+        void destroy(A const&, std::size_t) {}
+        void copy(A const&, std::size_t, integer_flat_values const&,
+          std::size_t)
+        {
+        }
+        void move(A const&, std::size_t, integer_flat_values&, std::size_t) {}
+        void swap(integer_flat_values&) {}
+      };
+
+      template <typename K, typename M, typename H, typename A>
+      struct integer_flat_table
+      {
+        BOOST_STATIC_ASSERT(boost::is_integral<K>::value);
+        BOOST_STATIC_ASSERT(sizeof(K) == 4 || sizeof(K) == 8);
+
+        typedef boost::unordered::detail::integer_group<sizeof(K)> group;
+        typedef typename group::word word;
+        typedef typename boost::unordered::detail::pick_bucket_policy<K,
+          H>::type policy;
+
+        typedef typename boost::unordered::detail::rebind_wrap<A, K>::type
+          key_allocator;
+        typedef boost::unordered::detail::allocator_traits<key_allocator>
+          key_allocator_traits;
+
+        BOOST_STATIC_ASSERT(
+          (boost::is_same<typename key_allocator_traits::pointer, K*>::value));
+
+        K* keys_;
+        boost::unordered::detail::integer_flat_values<M, A> values_;
+        std::size_t groups_;
+        int size_index_;
+        std::size_t size_;
+        // The slots of the array that aren't empty, including deleted ones.
+        std::size_t occupied_;
+        std::size_t max_load_;
+        // Bit 'k' is set when key 'k' is in its extra slot.
+        unsigned special_;
+        H hf_;
+        A alloc_;
+
+        integer_flat_table(std::size_t n, H const& hf, A const& a)
+            : keys_(), values_(), groups_(0), size_index_(0), size_(0),
+              occupied_(0), max_load_(0), special_(0), hf_(hf), alloc_(a)
+        {
+          if (n) {
+            this->create(this->min_groups_for(n));
+          }
+        }
+
+        integer_flat_table(integer_flat_table const& x, A const& a)
+            : keys_(), values_(), groups_(0), size_index_(0), size_(0),
+              occupied_(0), max_load_(0), special_(0), hf_(x.hf_), alloc_(a)
+        {
+          if (!x.keys_) {
+            return;
+          }
+          this->create(x.groups_);
+          BOOST_TRY
+          {
+            for (std::size_t i = x.first(); i != x.end(); i = x.next(i)) {
+              std::size_t const j = this->new_slot(x.keys_[i]);
+              values_.copy(alloc_, j, x.values_, i);
+              this->use_slot(j, x.keys_[i]);
+            }
+          }
+          BOOST_CATCH(...)
+          {
+            this->destroy();
+            BOOST_RETHROW
+          }
+          BOOST_CATCH_END
+        }
+
+        ~integer_flat_table() { this->destroy(); }
+
+        static bool is_special(K k) { return static_cast<word>(k) <= 1; }
+
+        std::size_t slot_count() const { return groups_ * integer_group_size; }
+
+        // One past the extra slots.
+        std::size_t end() const { return this->slot_count() + 2; }
+
+        std::size_t special_count() const
+        {
+          return (special_ & 1) + (special_ >> 1);
+        }
+
+        bool in_use(std::size_t i) const
+        {
+          std::size_t const n = this->slot_count();
+          return i < n ? !is_special(keys_[i]) : ((special_ >> (i - n)) & 1);
+        }
+
+        std::size_t next(std::size_t i) const
+        {
+          std::size_t const e = this->end();
+          do {
+            ++i;
+          } while (i != e && !this->in_use(i));
+          return i;
+        }
+
+        std::size_t first() const
+        {
+          return this->in_use(0) ? 0 : this->next(0);
+        }
+
+        std::size_t position(K k) const
+        {
+          return policy::to_bucket(
+            groups_, policy::apply_hash(hf_, k), size_index_);
+        }
+
+        std::size_t next_group(std::size_t g) const
+        {
+          return ++g == groups_ ? 0 : g;
+        }
+
+        // Returns the slot of key 'k', or end().
+        std::size_t find(K k) const
+        {
+          if (is_special(k)) {
+            std::size_t const s = static_cast<std::size_t>(k);
+            return ((special_ >> s) & 1) ? this->slot_count() + s
+                                         : this->end();
+          }
+          if (!keys_) {
+            return this->end();
+          }
+          word const w = static_cast<word>(k);
+          for (std::size_t g = this->position(k);; g = this->next_group(g)) {
+            K const* p = keys_ + g * integer_group_size;
+            unsigned const m = group::match(p, w);
+            if (m) {
+              return g * integer_group_size +
+                     static_cast<std::size_t>(boost::core::countr_zero(m));
+            }
+            if (group::match(p, 0)) {
+              return this->end();
+            }
+          }
+        }
+
+        template <class... Args>
+        std::pair<std::size_t, bool> try_emplace(K k, Args&&... args)
+        {
+          std::size_t i = this->find(k);
+          if (i != this->end()) {
+            return std::make_pair(i, false);
+          }
+          if (!keys_ || (!is_special(k) && occupied_ >= max_load_)) {
+            this->grow();
+          }
+          i = this->new_slot(k);
+          values_.construct(alloc_, i, std::forward<Args>(args)...);
+          this->use_slot(i, k);
+          return std::make_pair(i, true);
+        }
+
+        void erase(std::size_t i)
+        {
+          values_.destroy(alloc_, i);
+          --size_;
+          std::size_t const n = this->slot_count();
+          if (i >= n) {
+            special_ &= ~(1u << (i - n));
+            return;
+          }
+          K const* p = keys_ + (i / integer_group_size) * integer_group_size;
+          if (group::match(p, 0)) {
+            keys_[i] = K(0);
+            --occupied_;
+          } else {
+            keys_[i] = K(1);
+          }
+        }
+
+        void clear()
+        {
+          if (!keys_) {
+            return;
+          }
+          for (std::size_t i = this->first(); i != this->end();
+               i = this->next(i)) {
+            values_.destroy(alloc_, i);
+          }
+          std::fill(keys_, keys_ + this->slot_count(), K(0));
+          size_ = 0;
+          occupied_ = 0;
+          special_ = 0;
+        }
+
+        // Rehashes so that 'n' elements fit without another rehash.
+        void reserve(std::size_t n)
+        {
+          std::size_t const groups =
+            this->min_groups_for((std::max)(n, size_ - this->special_count()));
+          if (groups != groups_) {
+            this->rehash_impl(groups);
+          }
+        }
+
+        void swap(integer_flat_table& x)
+        {
+          boost::swap(keys_, x.keys_);
+          values_.swap(x.values_);
+          boost::swap(groups_, x.groups_);
+          boost::swap(size_index_, x.size_index_);
+          boost::swap(size_, x.size_);
+          boost::swap(occupied_, x.occupied_);
+          boost::swap(max_load_, x.max_load_);
+          boost::swap(special_, x.special_);
+          boost::swap(hf_, x.hf_);
+          boost::swap(alloc_, x.alloc_);
+        }
+
+        // The maximum load is 7/8 of the array.
+        std::size_t min_groups_for(std::size_t n) const
+        {
+          std::size_t const slots = n + n / 7 + 1;
+          return policy::new_bucket_count(
+            (slots + integer_group_size - 1) / integer_group_size);
+        }
+
+      private:
+        integer_flat_table(integer_flat_table const&);
+        integer_flat_table& operator=(integer_flat_table const&);
+
+        void create(std::size_t groups)
+        {
+          BOOST_ASSERT(!keys_);
+          std::size_t const n = groups * integer_group_size + 2;
+          key_allocator ka(alloc_);
+          keys_ = key_allocator_traits::allocate(ka, n);
+          BOOST_TRY { values_.allocate(alloc_, n); }
+          BOOST_CATCH(...)
+          {
+            key_allocator_traits::deallocate(ka, keys_, n);
+            keys_ = 0;
+            BOOST_RETHROW
+          }
+          BOOST_CATCH_END
+          std::fill(keys_, keys_ + n, K(0));
+          keys_[n - 1] = K(1);
+          groups_ = groups;
+          size_index_ = policy::size_index(groups);
+          max_load_ = groups * (integer_group_size - 1);
+        }
+
+        void destroy()
+        {
+          if (!keys_) {
+            return;
+          }
+          this->clear();
+          std::size_t const n = this->end();
+          values_.deallocate(alloc_, n);
+          key_allocator ka(alloc_);
+          key_allocator_traits::deallocate(ka, keys_, n);
+          keys_ = 0;
+          groups_ = 0;
+          max_load_ = 0;
+        }
+
+        // The slot for a key that isn't in the table: its extra slot, or the
+        // first free slot of its probe sequence.
+        std::size_t new_slot(K k) const
+        {
+          if (is_special(k)) {
+            return this->slot_count() + static_cast<std::size_t>(k);
+          }
+          for (std::size_t g = this->position(k);; g = this->next_group(g)) {
+            K const* p = keys_ + g * integer_group_size;
+            unsigned const m = group::match(p, 0) | group::match(p, 1);
+            if (m) {
+              return g * integer_group_size +
+                     static_cast<std::size_t>(boost::core::countr_zero(m));
+            }
+          }
+        }
+
+        // Called once the value is constructed, so that if that throws the
+        // slot is still free.
+        void use_slot(std::size_t i, K k)
+        {
+          std::size_t const n = this->slot_count();
+          if (i >= n) {
+            special_ |= 1u << (i - n);
+          } else {
+            if (static_cast<word>(keys_[i]) == 0) {
+              ++occupied_;
+            }
+            keys_[i] = k;
+          }
+          ++size_;
+        }
+
+        // Doubles the array when most of its occupied slots are in use, and
+        // otherwise rehashes it at the same size, to clear the deleted ones.
+        void grow()
+        {
+          std::size_t const n = size_ - this->special_count() + 1;
+          this->rehash_impl(this->min_groups_for(
+            n >= max_load_ - max_load_ / 8 ? 2 * n : n));
+        }
+
+        void rehash_impl(std::size_t groups)
+        {
+          integer_flat_table tmp(0, hf_, alloc_);
+          tmp.create(groups);
+          for (std::size_t i = this->first(); i != this->end();
+               i = this->next(i)) {
+            std::size_t const j = tmp.new_slot(keys_[i]);
+            tmp.values_.move(alloc_, j, values_, i);
+            tmp.use_slot(j, keys_[i]);
+          }
+          this->swap(tmp);
+        }
+      };
+    }
+
+    namespace iterator_detail {
+
+      // Forward iterators over the slots of an integer_flat_table, which
+      // stay valid until the table is rehashed or the element is erased.
+
+      template <typename Table, typename K> struct integer_set_iterator
+      {
+        Table const* table_;
+        std::size_t slot_;
+
+        typedef K value_type;
+        typedef K const* pointer;
+        typedef K const& reference;
+        typedef std::ptrdiff_t difference_type;
+        typedef std::forward_iterator_tag iterator_category;
+
+        integer_set_iterator() BOOST_NOEXCEPT : table_(), slot_() {}
+
+        integer_set_iterator(Table const* t, std::size_t i) BOOST_NOEXCEPT
+            : table_(t),
+              slot_(i)
+        {
+        }
+
+        reference operator*() const { return table_->keys_[slot_]; }
+
+        pointer operator->() const { return table_->keys_ + slot_; }
+
+        integer_set_iterator& operator++()
+        {
+          slot_ = table_->next(slot_);
+          return *this;
+        }
+
+        integer_set_iterator operator++(int)
+        {
+          integer_set_iterator tmp(*this);
+          ++(*this);
+          return tmp;
+        }
+
+        bool operator==(integer_set_iterator const& x) const BOOST_NOEXCEPT
+        {
+          return slot_ == x.slot_;
+        }
+
+        bool operator!=(integer_set_iterator const& x) const BOOST_NOEXCEPT
+        {
+          return slot_ != x.slot_;
+        }
+      };
+
+      // The keys and mapped values are in separate arrays, so dereferencing
+      // returns a pair of references rather than a reference to a pair.
+
+      template <typename Reference> struct arrow_proxy
+      {
+        Reference ref_;
+
+        Reference* operator->() { return boost::addressof(ref_); }
+      };
+
+      template <typename Table, typename K, typename M>
+      struct integer_map_iterator
+      {
+        Table const* table_;
+        std::size_t slot_;
+
+        typedef std::pair<K const, typename boost::remove_const<M>::type>
+          value_type;
+        typedef std::pair<K const&, M&> reference;
+        typedef boost::unordered::iterator_detail::arrow_proxy<reference>
+          pointer;
+        typedef std::ptrdiff_t difference_type;
+        typedef std::forward_iterator_tag iterator_category;
+
+        integer_map_iterator() BOOST_NOEXCEPT : table_(), slot_() {}
+
+        integer_map_iterator(Table const* t, std::size_t i) BOOST_NOEXCEPT
+            : table_(t),
+              slot_(i)
+        {
+        }
+
+        integer_map_iterator(integer_map_iterator<Table, K,
+          typename boost::remove_const<M>::type> const& x) BOOST_NOEXCEPT
+            : table_(x.table_),
+              slot_(x.slot_)
+        {
+        }
+
+        reference operator*() const
+        {
+          return reference(table_->keys_[slot_], table_->values_[slot_]);
+        }
+
+        pointer operator->() const
+        {
+          pointer p = {**this};
+          return p;
+        }
+
+        integer_map_iterator& operator++()
+        {
+          slot_ = table_->next(slot_);
+          return *this;
+        }
+
+        integer_map_iterator operator++(int)
+        {
+          integer_map_iterator tmp(*this);
+          ++(*this);
+          return tmp;
+        }
+
+        friend bool operator==(integer_map_iterator const& x,
+          integer_map_iterator const& y) BOOST_NOEXCEPT
+        {
+          return x.slot_ == y.slot_;
+        }
+
+        friend bool operator!=(integer_map_iterator const& x,
+          integer_map_iterator const& y) BOOST_NOEXCEPT
+        {
+          return x.slot_ != y.slot_;
+        }
+      };
+    }
+  }
+}
+
+#endif
+
+#endif
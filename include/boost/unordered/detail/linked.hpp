@@ -0,0 +1,362 @@
+
+// Copyright 2022 Christian Mazakas.
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_UNORDERED_DETAIL_LINKED_HPP
+#define BOOST_UNORDERED_DETAIL_LINKED_HPP
+
+#include <boost/config.hpp>
+#if defined(BOOST_HAS_PRAGMA_ONCE)
+#pragma once
+#endif
+
+#include <boost/unordered/detail/implementation.hpp>
+#include <cstddef>
+#include <iterator>
+
+namespace boost {
+  namespace unordered {
+    template <class K, class T, class H, class P, class A>
+    class linked_unordered_map;
+    template <class T, class H, class P, class A> class linked_unordered_set;
+
+    namespace detail {
+
+      ////////////////////////////////////////////////////////////////////////
+      // Insertion order
+      //
+      // Each node of an insertion ordered container is also linked into a
+      // circular list, through an order_link after its value. The list's
+      // sentinel is an order_link owned by the container, which is what the
+      // end iterator points to.
+
+      struct order_link
+      {
+        order_link* order_prev_;
+        order_link* order_next_;
+
+        order_link() : order_prev_(this), order_next_(this) {}
+
+      private:
+        order_link(order_link const&);
+        order_link& operator=(order_link const&);
+      };
+
+      template <typename T, bool BackLinks = false>
+      struct linked_node : boost::unordered::detail::ptr_node<T, BackLinks>,
+                           boost::unordered::detail::order_link
+      {
+        typedef linked_node<T, BackLinks>* node_pointer;
+
+        linked_node()
+            : boost::unordered::detail::ptr_node<T, BackLinks>(),
+              boost::unordered::detail::order_link()
+        {
+        }
+
+        static node_pointer from_link(order_link* x)
+        {
+          return static_cast<node_pointer>(x);
+        }
+
+      private:
+        linked_node& operator=(linked_node const&);
+      };
+
+      struct order_list
+      {
+        order_link head_;
+
+        order_list() {}
+
+        bool empty() const { return head_.order_next_ == &head_; }
+
+        order_link* first() const { return head_.order_next_; }
+
+        order_link* last() const { return head_.order_prev_; }
+
+        order_link* end() const { return const_cast<order_link*>(&head_); }
+
+        void link_back(order_link* n) BOOST_NOEXCEPT
+        {
+          n->order_prev_ = head_.order_prev_;
+          n->order_next_ = &head_;
+          head_.order_prev_->order_next_ = n;
+          head_.order_prev_ = n;
+        }
+
+        static void unlink(order_link* n) BOOST_NOEXCEPT
+        {
+          n->order_prev_->order_next_ = n->order_next_;
+          n->order_next_->order_prev_ = n->order_prev_;
+        }
+
+        void clear() BOOST_NOEXCEPT
+        {
+          head_.order_prev_ = &head_;
+          head_.order_next_ = &head_;
+        }
+
+        // The sentinel can't be swapped with the nodes' links, so the end
+        // nodes of each list are pointed at their new sentinel.
+        void swap(order_list& x) BOOST_NOEXCEPT
+        {
+          order_list tmp;
+          tmp.take(*this);
+          this->take(x);
+          x.take(tmp);
+        }
+
+      private:
+        order_list(order_list const&);
+        order_list& operator=(order_list const&);
+
+        void take(order_list& x) BOOST_NOEXCEPT
+        {
+          if (x.empty()) {
+            this->clear();
+          } else {
+            head_.order_next_ = x.head_.order_next_;
+            head_.order_prev_ = x.head_.order_prev_;
+            head_.order_next_->order_prev_ = &head_;
+            head_.order_prev_->order_next_ = &head_;
+            x.clear();
+          }
+        }
+      };
+
+      template <typename A, typename K, typename M, typename H, typename P>
+      struct linked_map
+      {
+        typedef boost::unordered::detail::linked_map<A, K, M, H, P> types;
+
+        typedef std::pair<K const, M> value_type;
+        typedef H hasher;
+        typedef P key_equal;
+        typedef K const const_key_type;
+
+        typedef
+          typename ::boost::unordered::detail::rebind_wrap<A, value_type>::type
+            value_allocator;
+        typedef boost::unordered::detail::allocator_traits<value_allocator>
+          value_allocator_traits;
+
+        typedef boost::unordered::detail::linked_node<value_type,
+          boost::unordered::detail::pick_back_links<H>::value>
+          node;
+        typedef boost::unordered::detail::ptr_bucket bucket;
+        typedef bucket* link_pointer;
+
+        typedef boost::unordered::detail::table<types> table;
+        typedef boost::unordered::detail::map_extractor<value_type> extractor;
+
+        typedef typename boost::unordered::detail::pick_bucket_policy<K,
+          H>::type policy;
+
+        typedef boost::unordered::iterator_detail::iterator<node> iterator;
+        typedef boost::unordered::iterator_detail::c_iterator<node> c_iterator;
+        typedef boost::unordered::iterator_detail::l_iterator<node> l_iterator;
+        typedef boost::unordered::iterator_detail::cl_iterator<node>
+          cl_iterator;
+      };
+
+      template <typename A, typename T, typename H, typename P>
+      struct linked_set
+      {
+        typedef boost::unordered::detail::linked_set<A, T, H, P> types;
+
+        typedef T value_type;
+        typedef H hasher;
+        typedef P key_equal;
+        typedef T const const_key_type;
+
+        typedef
+          typename ::boost::unordered::detail::rebind_wrap<A, value_type>::type
+            value_allocator;
+        typedef boost::unordered::detail::allocator_traits<value_allocator>
+          value_allocator_traits;
+
+        typedef boost::unordered::detail::linked_node<value_type,
+          boost::unordered::detail::pick_back_links<H>::value>
+          node;
+        typedef boost::unordered::detail::ptr_bucket bucket;
+        typedef bucket* link_pointer;
+
+        typedef boost::unordered::detail::table<types> table;
+        typedef boost::unordered::detail::set_extractor<value_type> extractor;
+
+        typedef typename boost::unordered::detail::pick_bucket_policy<T,
+          H>::type policy;
+
+        typedef boost::unordered::iterator_detail::c_iterator<node> iterator;
+        typedef boost::unordered::iterator_detail::c_iterator<node> c_iterator;
+        typedef boost::unordered::iterator_detail::cl_iterator<node> l_iterator;
+        typedef boost::unordered::iterator_detail::cl_iterator<node>
+          cl_iterator;
+      };
+    }
+
+    namespace iterator_detail {
+
+      // Bidirectional iterators that follow the insertion order.
+
+      template <typename Node> struct order_c_iterator;
+
+      template <typename Node> struct order_iterator
+      {
+        friend struct boost::unordered::iterator_detail::order_c_iterator<Node>;
+#if !defined(BOOST_NO_MEMBER_TEMPLATE_FRIENDS)
+        template <class, class, class, class, class>
+        friend class boost::unordered::linked_unordered_map;
+
+      private:
+#endif
+        boost::unordered::detail::order_link* link_;
+
+      public:
+        typedef typename Node::value_type value_type;
+        typedef value_type* pointer;
+        typedef value_type& reference;
+        typedef std::ptrdiff_t difference_type;
+        typedef std::bidirectional_iterator_tag iterator_category;
+
+        order_iterator() BOOST_NOEXCEPT : link_() {}
+
+        explicit order_iterator(
+          boost::unordered::detail::order_link* x) BOOST_NOEXCEPT : link_(x)
+        {
+        }
+
+        value_type& operator*() const
+        {
+          return Node::from_link(link_)->value();
+        }
+
+        value_type* operator->() const
+        {
+          return Node::from_link(link_)->value_ptr();
+        }
+
+        order_iterator& operator++()
+        {
+          link_ = link_->order_next_;
+          return *this;
+        }
+
+        order_iterator operator++(int)
+        {
+          order_iterator tmp(link_);
+          ++(*this);
+          return tmp;
+        }
+
+        order_iterator& operator--()
+        {
+          link_ = link_->order_prev_;
+          return *this;
+        }
+
+        order_iterator operator--(int)
+        {
+          order_iterator tmp(link_);
+          --(*this);
+          return tmp;
+        }
+
+        bool operator==(order_iterator const& x) const BOOST_NOEXCEPT
+        {
+          return link_ == x.link_;
+        }
+
+        bool operator!=(order_iterator const& x) const BOOST_NOEXCEPT
+        {
+          return link_ != x.link_;
+        }
+      };
+
+      template <typename Node> struct order_c_iterator
+      {
+#if !defined(BOOST_NO_MEMBER_TEMPLATE_FRIENDS)
+        template <class, class, class, class, class>
+        friend class boost::unordered::linked_unordered_map;
+        template <class, class, class, class>
+        friend class boost::unordered::linked_unordered_set;
+
+      private:
+#endif
+        typedef boost::unordered::iterator_detail::order_iterator<Node>
+          n_iterator;
+        boost::unordered::detail::order_link* link_;
+
+      public:
+        typedef typename Node::value_type value_type;
+        typedef value_type const* pointer;
+        typedef value_type const& reference;
+        typedef std::ptrdiff_t difference_type;
+        typedef std::bidirectional_iterator_tag iterator_category;
+
+        order_c_iterator() BOOST_NOEXCEPT : link_() {}
+
+        explicit order_c_iterator(
+          boost::unordered::detail::order_link* x) BOOST_NOEXCEPT : link_(x)
+        {
+        }
+
+        order_c_iterator(n_iterator const& x) BOOST_NOEXCEPT : link_(x.link_)
+        {
+        }
+
+        value_type const& operator*() const
+        {
+          return Node::from_link(link_)->value();
+        }
+
+        value_type const* operator->() const
+        {
+          return Node::from_link(link_)->value_ptr();
+        }
+
+        order_c_iterator& operator++()
+        {
+          link_ = link_->order_next_;
+          return *this;
+        }
+
+        order_c_iterator operator++(int)
+        {
+          order_c_iterator tmp(link_);
+          ++(*this);
+          return tmp;
+        }
+
+        order_c_iterator& operator--()
+        {
+          link_ = link_->order_prev_;
+          return *this;
+        }
+
+        order_c_iterator operator--(int)
+        {
+          order_c_iterator tmp(link_);
+          --(*this);
+          return tmp;
+        }
+
+        friend bool operator==(
+          order_c_iterator const& x, order_c_iterator const& y) BOOST_NOEXCEPT
+        {
+          return x.link_ == y.link_;
+        }
+
+        friend bool operator!=(
+          order_c_iterator const& x, order_c_iterator const& y) BOOST_NOEXCEPT
+        {
+          return x.link_ != y.link_;
+        }
+      };
+    }
+  }
+}
+
+#endif
@@ -25,7 +25,9 @@ namespace boost {
         typedef boost::unordered::detail::allocator_traits<value_allocator>
           value_allocator_traits;
 
-        typedef boost::unordered::detail::pick_node<A, value_type> pick;
+        typedef boost::unordered::detail::pick_node<A, value_type,
+          boost::unordered::detail::pick_back_links<H>::value>
+          pick;
         typedef typename pick::node node;
         typedef typename pick::bucket bucket;
         typedef typename pick::link_pointer link_pointer;
@@ -33,7 +35,8 @@ namespace boost {
         typedef boost::unordered::detail::table<types> table;
         typedef boost::unordered::detail::map_extractor<value_type> extractor;
 
-        typedef typename boost::unordered::detail::pick_policy<K>::type policy;
+        typedef typename boost::unordered::detail::pick_bucket_policy<K,
+          H>::type policy;
 
         typedef boost::unordered::iterator_detail::iterator<node> iterator;
         typedef boost::unordered::iterator_detail::c_iterator<node> c_iterator;
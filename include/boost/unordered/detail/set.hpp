@@ -24,7 +24,9 @@ namespace boost {
         typedef boost::unordered::detail::allocator_traits<value_allocator>
           value_allocator_traits;
 
-        typedef boost::unordered::detail::pick_node<A, value_type> pick;
+        typedef boost::unordered::detail::pick_node<A, value_type,
+          boost::unordered::detail::pick_back_links<H>::value>
+          pick;
         typedef typename pick::node node;
         typedef typename pick::bucket bucket;
         typedef typename pick::link_pointer link_pointer;
@@ -32,7 +34,8 @@ namespace boost {
         typedef boost::unordered::detail::table<types> table;
         typedef boost::unordered::detail::set_extractor<value_type> extractor;
 
-        typedef typename boost::unordered::detail::pick_policy<T>::type policy;
+        typedef typename boost::unordered::detail::pick_bucket_policy<T,
+          H>::type policy;
 
         typedef boost::unordered::iterator_detail::c_iterator<node> iterator;
         typedef boost::unordered::iterator_detail::c_iterator<node> c_iterator;
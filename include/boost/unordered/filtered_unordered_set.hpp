@@ -0,0 +1,447 @@
+
+// Copyright 2022 Christian Mazakas.
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_UNORDERED_FILTERED_UNORDERED_SET_HPP_INCLUDED
+#define BOOST_UNORDERED_FILTERED_UNORDERED_SET_HPP_INCLUDED
+
+#include <boost/config.hpp>
+#if defined(BOOST_HAS_PRAGMA_ONCE)
+#pragma once
+#endif
+
+#include <boost/unordered/unordered_set.hpp>
+
+#if !defined(BOOST_NO_CXX11_RVALUE_REFERENCES) &&                              \
+  !defined(BOOST_NO_CXX11_VARIADIC_TEMPLATES)
+
+#include <boost/assert.hpp>
+#include <boost/core/swap.hpp>
+#include <boost/unordered/detail/bloom_filter.hpp>
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <utility>
+
+#if !defined(BOOST_NO_CXX11_HDR_INITIALIZER_LIST)
+#include <initializer_list>
+#endif
+
+namespace boost {
+  namespace unordered {
+
+    // A set for lookups that mostly miss. It keeps a blocked Bloom filter
+    // of its elements' hash values, which 'find', 'contains' and 'count'
+    // check before the buckets, so a miss usually only reads one cache
+    // line of the filter.
+    //
+    // The filter is sized for the elements the buckets can hold, and is
+    // rebuilt when they are rehashed. Erased elements leave their bits set,
+    // so once the number erased reaches a quarter of the filter's capacity,
+    // the next insertion rebuilds it from the remaining elements.
+
+    template <class T, class H = boost::hash<T>, class P = std::equal_to<T>,
+      class A = std::allocator<T> >
+    class filtered_unordered_set
+    {
+      typedef boost::unordered::detail::set<A, T, H, P> types;
+      typedef typename types::table table;
+      typedef typename table::node_pointer node_pointer;
+      typedef typename table::node_allocator_traits node_allocator_traits;
+      typedef boost::unordered::detail::blocked_bloom_filter<A> filter;
+
+    public:
+      typedef T key_type;
+      typedef T value_type;
+      typedef H hasher;
+      typedef P key_equal;
+      typedef A allocator_type;
+      typedef std::size_t size_type;
+      typedef std::ptrdiff_t difference_type;
+      typedef value_type& reference;
+      typedef value_type const& const_reference;
+      typedef typename table::iterator iterator;
+      typedef typename table::c_iterator const_iterator;
+
+      // About 1% false positives.
+      static const size_type default_filter_bits_per_element = 10;
+
+    private:
+      table table_;
+      filter filter_;
+      size_type erased_; // since the filter was built
+      std::size_t filter_seed_; // the table's hash seed when it was built
+
+    public:
+      // construct/destroy
+
+      filtered_unordered_set()
+          : table_(boost::unordered::detail::default_bucket_count, hasher(),
+              key_equal(), typename table::node_allocator(allocator_type())),
+            filter_(allocator_type(), default_filter_bits_per_element),
+            erased_(0), filter_seed_(0)
+      {
+      }
+
+      explicit filtered_unordered_set(size_type n,
+        hasher const& hf = hasher(), key_equal const& eq = key_equal(),
+        allocator_type const& a = allocator_type())
+          : table_(n, hf, eq, typename table::node_allocator(a)),
+            filter_(a, default_filter_bits_per_element), erased_(0),
+            filter_seed_(0)
+      {
+      }
+
+      explicit filtered_unordered_set(allocator_type const& a)
+          : table_(boost::unordered::detail::default_bucket_count, hasher(),
+              key_equal(), typename table::node_allocator(a)),
+            filter_(a, default_filter_bits_per_element), erased_(0),
+            filter_seed_(0)
+      {
+      }
+
+      template <class InputIt>
+      filtered_unordered_set(InputIt first, InputIt last,
+        size_type n = boost::unordered::detail::default_bucket_count,
+        hasher const& hf = hasher(), key_equal const& eq = key_equal(),
+        allocator_type const& a = allocator_type())
+          : table_(n, hf, eq, typename table::node_allocator(a)),
+            filter_(a, default_filter_bits_per_element), erased_(0),
+            filter_seed_(0)
+      {
+        this->insert(first, last);
+      }
+
+#if !defined(BOOST_NO_CXX11_HDR_INITIALIZER_LIST)
+      filtered_unordered_set(std::initializer_list<value_type> list,
+        size_type n = boost::unordered::detail::default_bucket_count,
+        hasher const& hf = hasher(), key_equal const& eq = key_equal(),
+        allocator_type const& a = allocator_type())
+          : table_(n, hf, eq, typename table::node_allocator(a)),
+            filter_(a, default_filter_bits_per_element), erased_(0),
+            filter_seed_(0)
+      {
+        this->insert(list.begin(), list.end());
+      }
+#endif
+
+      filtered_unordered_set(filtered_unordered_set const& x)
+          : table_(x.table_, node_allocator_traits::
+                               select_on_container_copy_construction(
+                                 x.table_.node_alloc())),
+            filter_(x.filter_, this->get_allocator()), erased_(x.erased_),
+            filter_seed_(x.filter_seed_)
+      {
+        if (x.table_.size_) {
+          table_.copy_buckets(x.table_, boost::unordered::detail::true_type());
+        }
+      }
+
+      filtered_unordered_set(filtered_unordered_set&& x)
+          : table_(x.table_, boost::unordered::detail::move_tag()),
+            filter_(x.get_allocator(), x.filter_.bits_per_element_),
+            erased_(x.erased_), filter_seed_(x.filter_seed_)
+      {
+        filter_.swap(x.filter_);
+      }
+
+      filtered_unordered_set& operator=(filtered_unordered_set const& x)
+      {
+        if (this != &x) {
+          filtered_unordered_set tmp(x);
+          this->swap(tmp);
+        }
+        return *this;
+      }
+
+      filtered_unordered_set& operator=(filtered_unordered_set&& x)
+      {
+        if (this != &x) {
+          filtered_unordered_set tmp(std::move(x));
+          this->swap(tmp);
+        }
+        return *this;
+      }
+
+      allocator_type get_allocator() const
+      {
+        return allocator_type(table_.node_alloc());
+      }
+
+      // iterators
+
+      iterator begin() BOOST_NOEXCEPT { return iterator(table_.begin()); }
+
+      const_iterator begin() const BOOST_NOEXCEPT
+      {
+        return const_iterator(table_.begin());
+      }
+
+      iterator end() BOOST_NOEXCEPT { return iterator(); }
+
+      const_iterator end() const BOOST_NOEXCEPT { return const_iterator(); }
+
+      const_iterator cbegin() const BOOST_NOEXCEPT { return this->begin(); }
+
+      const_iterator cend() const BOOST_NOEXCEPT { return this->end(); }
+
+      // size and capacity
+
+      bool empty() const BOOST_NOEXCEPT { return table_.size_ == 0; }
+
+      size_type size() const BOOST_NOEXCEPT { return table_.size_; }
+
+      size_type max_size() const BOOST_NOEXCEPT
+      {
+        using namespace std;
+
+        // size <= mlf_ * count
+        return boost::unordered::detail::double_to_size(
+                 ceil(static_cast<double>(table_.mlf_) *
+                      static_cast<double>(table_.max_bucket_count()))) -
+               1;
+      }
+
+      // modifiers
+
+      template <class... Args>
+      std::pair<iterator, bool> emplace(Args&&... args)
+      {
+        this->reserve_for_insert();
+        return this->add_new(table_.emplace_unique(
+          table::extractor::extract(std::forward<Args>(args)...),
+          std::forward<Args>(args)...));
+      }
+
+      std::pair<iterator, bool> insert(value_type const& x)
+      {
+        return this->emplace(x);
+      }
+
+      std::pair<iterator, bool> insert(value_type&& x)
+      {
+        return this->emplace(std::move(x));
+      }
+
+      template <class InputIt> void insert(InputIt first, InputIt last)
+      {
+        for (; first != last; ++first) {
+          this->emplace(*first);
+        }
+      }
+
+#if !defined(BOOST_NO_CXX11_HDR_INITIALIZER_LIST)
+      void insert(std::initializer_list<value_type> list)
+      {
+        this->insert(list.begin(), list.end());
+      }
+#endif
+
+      iterator erase(const_iterator position)
+      {
+        node_pointer n = table::get_node(position);
+        BOOST_ASSERT(n);
+        node_pointer next = table::next_node(n);
+        table_.erase_nodes_unique(n, next);
+        ++erased_;
+        return iterator(next);
+      }
+
+      size_type erase(key_type const& k)
+      {
+        std::size_t const n =
+          table_.erase_key_unique_impl(table_.key_eq(), k);
+        erased_ += n;
+        return n;
+      }
+
+      void clear() BOOST_NOEXCEPT
+      {
+        table_.clear_impl();
+        filter_.clear();
+        erased_ = 0;
+        filter_seed_ = table_.hash_seed();
+      }
+
+      void swap(filtered_unordered_set& x)
+      {
+        table_.swap(x.table_);
+        filter_.swap(x.filter_);
+        boost::swap(erased_, x.erased_);
+        boost::swap(filter_seed_, x.filter_seed_);
+      }
+
+      // observers
+
+      hasher hash_function() const { return table_.hash_function(); }
+
+      key_equal key_eq() const { return table_.key_eq(); }
+
+      // lookup, which checks the filter first
+
+      iterator find(key_type const& k)
+      {
+        return iterator(this->find_node(k));
+      }
+
+      const_iterator find(key_type const& k) const
+      {
+        return const_iterator(this->find_node(k));
+      }
+
+      bool contains(key_type const& k) const
+      {
+        return this->find_node(k) != node_pointer();
+      }
+
+      size_type count(key_type const& k) const
+      {
+        return this->contains(k) ? 1 : 0;
+      }
+
+      // filter
+
+      size_type filter_bits_per_element() const BOOST_NOEXCEPT
+      {
+        return filter_.bits_per_element_;
+      }
+
+      // Rebuilds the filter with 'n' bits for each element the buckets can
+      // hold, or drops it when 'n' is 0.
+      void filter_bits_per_element(size_type n)
+      {
+        filter tmp(this->get_allocator(), n);
+        tmp.swap(filter_);
+        BOOST_TRY { this->rebuild_filter(table_.max_load_); }
+        BOOST_CATCH(...)
+        {
+          filter_.swap(tmp);
+          BOOST_RETHROW
+        }
+        BOOST_CATCH_END
+      }
+
+      size_type filter_memory() const BOOST_NOEXCEPT
+      {
+        return filter_.bytes();
+      }
+
+      double filter_false_positive_rate() const
+      {
+        return filter_.false_positive_rate(table_.size_ + erased_);
+      }
+
+      // False when 'k' is certainly not an element.
+      bool filter_might_contain(key_type const& k) const
+      {
+        return filter_.may_contain(table_.hash(k));
+      }
+
+      // Clears the bits left by erased elements.
+      void refresh_filter() { this->rebuild_filter(filter_.capacity_); }
+
+      // hash policy
+
+      size_type bucket_count() const BOOST_NOEXCEPT
+      {
+        return table_.bucket_count_;
+      }
+
+      float load_factor() const BOOST_NOEXCEPT
+      {
+        BOOST_ASSERT(table_.bucket_count_ != 0);
+        return static_cast<float>(table_.size_) /
+               static_cast<float>(table_.bucket_count_);
+      }
+
+      float max_load_factor() const BOOST_NOEXCEPT { return table_.mlf_; }
+
+      void max_load_factor(float m) BOOST_NOEXCEPT
+      {
+        table_.max_load_factor(m);
+      }
+
+      void rehash(size_type n)
+      {
+        table_.rehash(n);
+        this->rebuild_filter(table_.max_load_);
+      }
+
+      void reserve(size_type n)
+      {
+        this->rehash(static_cast<std::size_t>(
+          std::ceil(static_cast<double>(n) / table_.mlf_)));
+      }
+
+    private:
+      node_pointer find_node(key_type const& k) const
+      {
+        std::size_t const key_hash = table_.hash(k);
+        return filter_.may_contain(key_hash) ? table_.find_node(key_hash, k)
+                                             : node_pointer();
+      }
+
+      // Called before inserting, so that if the buckets grow, the filter is
+      // rebuilt with them, and if that throws, the element isn't inserted.
+      void reserve_for_insert()
+      {
+        if (!filter_.enabled()) {
+          return;
+        }
+        table_.reserve_for_insert(table_.size_ + 1);
+        if (filter_.capacity_ < table_.max_load_) {
+          this->rebuild_filter(table_.max_load_);
+        } else if (erased_ >= filter_.capacity_ / 4 && erased_) {
+          this->rebuild_filter(filter_.capacity_);
+        }
+      }
+
+      std::pair<iterator, bool> add_new(
+        typename table::emplace_return const& r)
+      {
+        if (r.second && filter_.enabled()) {
+          // An adaptive hash may have been seeded by the insert, which
+          // changes every hash value in the filter.
+          if (table_.hash_seed() != filter_seed_) {
+            this->rebuild_filter(filter_.capacity_);
+          } else {
+            filter_.add(
+              table_.hash(table_.get_key(table::get_node(r.first))));
+          }
+        }
+        return r;
+      }
+
+      void rebuild_filter(size_type capacity)
+      {
+        filter_.reset((std::max)(capacity, table_.size_));
+        if (filter_.enabled()) {
+          for (node_pointer n = table_.begin(); n; n = table::next_node(n)) {
+            filter_.add(table_.hash(table_.get_key(n)));
+          }
+        }
+        erased_ = 0;
+        filter_seed_ = table_.hash_seed();
+      }
+    };
+
+    template <class T, class H, class P, class A>
+    typename filtered_unordered_set<T, H, P, A>::size_type const
+      filtered_unordered_set<T, H, P, A>::default_filter_bits_per_element;
+
+    template <class T, class H, class P, class A>
+    inline void swap(filtered_unordered_set<T, H, P, A>& x,
+      filtered_unordered_set<T, H, P, A>& y)
+    {
+      x.swap(y);
+    }
+  }
+
+  using boost::unordered::filtered_unordered_set;
+}
+
+#endif
+
+#endif
@@ -0,0 +1,412 @@
+
+// Copyright 2022 Christian Mazakas.
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_UNORDERED_HASH_JOIN_HPP_INCLUDED
+#define BOOST_UNORDERED_HASH_JOIN_HPP_INCLUDED
+
+#include <boost/config.hpp>
+#if defined(BOOST_HAS_PRAGMA_ONCE)
+#pragma once
+#endif
+
+#include <boost/assert.hpp>
+#include <boost/functional/hash.hpp>
+#include <boost/unordered/hash_traits.hpp>
+#include <boost/unordered/unordered_map.hpp>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace boost {
+  namespace unordered {
+    namespace detail {
+
+      // A partition is meant to stay in cache while the rows that probe it
+      // are streamed through, so a build side is split until its partitions
+      // have about this many elements.
+      static const std::size_t hash_join_partition_size = 16384;
+      static const int hash_join_max_partition_bits = 12;
+
+      inline int hash_join_partition_bits(std::size_t n)
+      {
+        int bits = 0;
+        while (bits < hash_join_max_partition_bits &&
+               (n >> bits) > hash_join_partition_size) {
+          ++bits;
+        }
+        return bits;
+      }
+
+      // The hash function of the partitions. The high bits of the mixed hash
+      // value select the partition, so they're shifted out, leaving the bits
+      // below them to select the bucket within the partition.
+      template <class K, class H> struct partition_hash
+      {
+        typedef void is_avalanching;
+        typedef boost::unordered::power_of_two_buckets bucket_policy;
+        typedef typename boost::unordered::detail::pick_policy<K, H>::type
+          policy;
+
+        H hf_;
+        int bits_;
+
+        partition_hash(H const& hf, int bits) : hf_(hf), bits_(bits) {}
+
+        std::size_t mixed(K const& k) const
+        {
+          return policy::apply_hash(hf_, k);
+        }
+
+        std::size_t partition(std::size_t mixed_hash) const
+        {
+          return bits_ ? mixed_hash >>
+                           (std::numeric_limits<std::size_t>::digits - bits_)
+                       : 0;
+        }
+
+        std::size_t operator()(K const& k) const { return mixed(k) << bits_; }
+      };
+
+      // Returns a hash value that was computed when the rows were
+      // partitioned.
+      struct precomputed_hash
+      {
+        std::size_t hash_;
+
+        template <class K> std::size_t operator()(K const&) const
+        {
+          return hash_;
+        }
+      };
+
+      template <class Iterator> struct hash_join_entry
+      {
+        Iterator it_;
+        std::size_t hash_;
+      };
+
+      struct hash_join_first
+      {
+        template <class Pair>
+        typename Pair::first_type const& operator()(Pair const& x) const
+        {
+          return x.first;
+        }
+      };
+    }
+
+    // Matches the rows of a probe side against a build side, which is stored
+    // in a number of unordered_multimaps selected by the high bits of the
+    // mixed hash value. Ranges of rows are first sorted by partition, and
+    // then handled one partition at a time, so that while a partition is in
+    // use, it's all that's being looked up.
+
+    template <class K, class T, class H = boost::hash<K>,
+      class P = std::equal_to<K>,
+      class A = std::allocator<std::pair<const K, T> > >
+    class hash_join
+    {
+      typedef boost::unordered::detail::partition_hash<K, H> partition_hasher;
+
+    public:
+      typedef K key_type;
+      typedef T mapped_type;
+      typedef std::pair<const K, T> value_type;
+      typedef H hasher;
+      typedef P key_equal;
+      typedef A allocator_type;
+      typedef std::size_t size_type;
+      typedef boost::unordered_multimap<K, T, partition_hasher, P, A>
+        partition_type;
+
+    private:
+      partition_hasher hash_;
+      std::vector<partition_type> partitions_;
+
+    public:
+      // construct/destroy
+
+      explicit hash_join(size_type n = 0, hasher const& hf = hasher(),
+        key_equal const& eq = key_equal(),
+        allocator_type const& a = allocator_type())
+          : hash_(hf, boost::unordered::detail::hash_join_partition_bits(n)),
+            partitions_()
+      {
+        size_type const count = size_type(1) << hash_.bits_;
+        partitions_.reserve(count);
+        for (size_type i = 0; i < count; ++i) {
+          partitions_.push_back(partition_type(
+            boost::unordered::detail::default_bucket_count, hash_, eq, a));
+          if (n) {
+            partitions_.back().reserve(n >> hash_.bits_);
+          }
+        }
+      }
+
+      allocator_type get_allocator() const
+      {
+        return partitions_.front().get_allocator();
+      }
+
+      // size
+
+      bool empty() const BOOST_NOEXCEPT { return size() == 0; }
+
+      size_type size() const BOOST_NOEXCEPT
+      {
+        size_type n = 0;
+        for (size_type i = 0; i < partitions_.size(); ++i) {
+          n += partitions_[i].size();
+        }
+        return n;
+      }
+
+      // partitions
+
+      size_type partition_count() const BOOST_NOEXCEPT
+      {
+        return partitions_.size();
+      }
+
+      partition_type const& partition(size_type i) const
+      {
+        BOOST_ASSERT(i < partitions_.size());
+        return partitions_[i];
+      }
+
+      size_type partition_index(key_type const& k) const
+      {
+        return hash_.partition(hash_.mixed(k));
+      }
+
+      // build
+
+      void insert(value_type const& x)
+      {
+        partitions_[partition_index(x.first)].insert(x);
+      }
+
+      template <class ForwardIt> void insert(ForwardIt first, ForwardIt last)
+      {
+        std::vector<boost::unordered::detail::hash_join_entry<ForwardIt> >
+          entries;
+        std::vector<size_type> offsets;
+        this->partition_rows(first, last,
+          boost::unordered::detail::hash_join_first(), entries, offsets);
+        for (size_type p = 0; p < partitions_.size(); ++p) {
+          this->insert_partition(p, entries, offsets);
+        }
+      }
+
+      void clear()
+      {
+        for (size_type i = 0; i < partitions_.size(); ++i) {
+          partitions_[i].clear();
+        }
+      }
+
+      // probe
+
+      // Calls f(row, x) for each row in [first, last) and each element x
+      // whose key is equivalent to key_of(row).
+      template <class ForwardIt, class KeyOf, class F>
+      size_type probe(
+        ForwardIt first, ForwardIt last, KeyOf key_of, F f) const
+      {
+        if (partitions_.size() == 1) {
+          key_equal const eq = this->key_eq();
+          size_type count = 0;
+          for (; first != last; ++first) {
+            key_type const& k = key_of(*first);
+            count += this->probe_row(
+              partitions_.front(), *first, k, hash_.mixed(k), eq, f);
+          }
+          return count;
+        }
+
+        std::vector<boost::unordered::detail::hash_join_entry<ForwardIt> >
+          entries;
+        std::vector<size_type> offsets;
+        this->partition_rows(first, last, key_of, entries, offsets);
+        size_type count = 0;
+        for (size_type p = 0; p < partitions_.size(); ++p) {
+          count += this->probe_partition(p, entries, offsets, key_of, f);
+        }
+        return count;
+      }
+
+#if BOOST_UNORDERED_PARALLEL
+      // parallel algorithms
+
+      template <class ForwardIt>
+      void parallel_insert(
+        ForwardIt first, ForwardIt last, std::size_t num_threads = 0)
+      {
+        std::vector<boost::unordered::detail::hash_join_entry<ForwardIt> >
+          entries;
+        std::vector<size_type> offsets;
+        this->partition_rows(first, last,
+          boost::unordered::detail::hash_join_first(), entries, offsets);
+        this->for_each_partition(
+          entries.size(), num_threads, [&](size_type p) {
+            this->insert_partition(p, entries, offsets);
+          });
+      }
+
+      template <class ForwardIt, class KeyOf, class F>
+      size_type parallel_probe(ForwardIt first, ForwardIt last, KeyOf key_of,
+        F f, std::size_t num_threads = 0) const
+      {
+        std::vector<boost::unordered::detail::hash_join_entry<ForwardIt> >
+          entries;
+        std::vector<size_type> offsets;
+        this->partition_rows(first, last, key_of, entries, offsets);
+
+        std::vector<size_type> counts(partitions_.size());
+        this->for_each_partition(
+          entries.size(), num_threads, [&](size_type p) {
+            counts[p] = this->probe_partition(p, entries, offsets, key_of, f);
+          });
+
+        size_type count = 0;
+        for (size_type p = 0; p < counts.size(); ++p) {
+          count += counts[p];
+        }
+        return count;
+      }
+#endif
+
+      // observers
+
+      hasher hash_function() const { return hash_.hf_; }
+
+      key_equal key_eq() const { return partitions_.front().key_eq(); }
+
+    private:
+      // Sorts the rows by partition, with a counting sort. The rows of
+      // partition p end up in [offsets[p], offsets[p + 1]).
+      template <class ForwardIt, class KeyOf>
+      void partition_rows(ForwardIt first, ForwardIt last, KeyOf const& key_of,
+        std::vector<boost::unordered::detail::hash_join_entry<ForwardIt> >&
+          entries,
+        std::vector<size_type>& offsets) const
+      {
+        std::vector<std::size_t> hashes;
+        hashes.reserve(static_cast<size_type>(std::distance(first, last)));
+        offsets.assign(partitions_.size() + 1, 0);
+        for (ForwardIt it = first; it != last; ++it) {
+          std::size_t const h = hash_.mixed(key_of(*it));
+          hashes.push_back(h);
+          ++offsets[hash_.partition(h) + 1];
+        }
+        for (size_type p = 0; p < partitions_.size(); ++p) {
+          offsets[p + 1] += offsets[p];
+        }
+
+        entries.resize(hashes.size());
+        std::vector<size_type> next(offsets.begin(), offsets.end() - 1);
+        size_type i = 0;
+        for (ForwardIt it = first; it != last; ++it, ++i) {
+          boost::unordered::detail::hash_join_entry<ForwardIt>& e =
+            entries[next[hash_.partition(hashes[i])]++];
+          e.it_ = it;
+          e.hash_ = hashes[i];
+        }
+      }
+
+      template <class ForwardIt>
+      void insert_partition(size_type p,
+        std::vector<
+          boost::unordered::detail::hash_join_entry<ForwardIt> > const& entries,
+        std::vector<size_type> const& offsets)
+      {
+        partition_type& part = partitions_[p];
+        part.reserve(part.size() + (offsets[p + 1] - offsets[p]));
+        for (size_type i = offsets[p]; i != offsets[p + 1]; ++i) {
+          part.insert(*entries[i].it_);
+        }
+      }
+
+      template <class ForwardIt, class KeyOf, class F>
+      size_type probe_partition(size_type p,
+        std::vector<
+          boost::unordered::detail::hash_join_entry<ForwardIt> > const& entries,
+        std::vector<size_type> const& offsets, KeyOf const& key_of,
+        F& f) const
+      {
+        partition_type const& part = partitions_[p];
+        if (part.empty()) {
+          return 0;
+        }
+
+        key_equal const eq = part.key_eq();
+        size_type count = 0;
+        for (size_type i = offsets[p]; i != offsets[p + 1]; ++i) {
+          count += this->probe_row(part, *entries[i].it_,
+            key_of(*entries[i].it_), entries[i].hash_, eq, f);
+        }
+        return count;
+      }
+
+      // The equivalent elements are adjacent, so the matches are the
+      // elements from the first one found until the key changes.
+      template <class Row, class F>
+      size_type probe_row(partition_type const& part, Row const& row,
+        key_type const& k, std::size_t mixed_hash, key_equal const& eq,
+        F& f) const
+      {
+        boost::unordered::detail::precomputed_hash const hf = {
+          mixed_hash << hash_.bits_};
+        typename partition_type::const_iterator it = part.find(k, hf, eq),
+                                                end = part.end();
+        size_type count = 0;
+        for (; it != end && eq(it->first, k); ++it) {
+          f(row, *it);
+          ++count;
+        }
+        return count;
+      }
+
+#if BOOST_UNORDERED_PARALLEL
+      // Splits the partitions into one contiguous range per thread.
+      template <class F>
+      void for_each_partition(
+        size_type n, std::size_t num_threads, F const& f) const
+      {
+        size_type const count = partitions_.size();
+        num_threads = (std::min)(count,
+          boost::unordered::detail::parallel_thread_count(num_threads, n));
+        if (num_threads <= 1) {
+          for (size_type p = 0; p < count; ++p) {
+            f(p);
+          }
+          return;
+        }
+
+        size_type const per_thread = (count + num_threads - 1) / num_threads;
+        std::exception_ptr error = boost::unordered::detail::run_in_parallel(
+          num_threads, [&](std::size_t t) {
+            size_type const first = (std::min)(count, t * per_thread);
+            size_type const last = (std::min)(count, first + per_thread);
+            for (size_type p = first; p != last; ++p) {
+              f(p);
+            }
+          });
+        if (error) {
+          std::rethrow_exception(error);
+        }
+      }
+#endif
+    };
+  }
+
+  using boost::unordered::hash_join;
+}
+
+#endif
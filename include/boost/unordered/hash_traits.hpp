@@ -0,0 +1,194 @@
+
+// Copyright 2022 Christian Mazakas.
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_UNORDERED_HASH_TRAITS_HPP_INCLUDED
+#define BOOST_UNORDERED_HASH_TRAITS_HPP_INCLUDED
+
+#include <boost/config.hpp>
+#if defined(BOOST_HAS_PRAGMA_ONCE)
+#pragma once
+#endif
+
+#include <boost/type_traits/integral_constant.hpp>
+#include <boost/type_traits/make_void.hpp>
+
+namespace boost {
+  namespace unordered {
+
+    // A hash function can declare that its results are already well
+    // distributed over all of their bits by providing a nested
+    // 'is_avalanching' typedef. The containers then use the hash value
+    // directly, instead of mixing it first.
+
+    template <class Hash, class = void>
+    struct hash_is_avalanching : boost::false_type
+    {
+    };
+
+    template <class Hash>
+    struct hash_is_avalanching<Hash,
+      typename boost::make_void<typename Hash::is_avalanching>::type>
+        : boost::true_type
+    {
+    };
+
+    // A hash function can also choose how its hash values are mapped to
+    // buckets, by providing a nested 'bucket_policy' typedef naming one of
+    // the following:
+    //
+    // default_buckets - whatever suits the platform, currently the same as
+    //   power_of_two_buckets when size_t has 32 or 64 bits.
+    // prime_buckets - a prime number of buckets, indexed by the remainder of
+    //   the unmixed hash value. Slower, but keeps every bit of the hash
+    //   value.
+    // power_of_two_buckets - the hash value is mixed, and its high bits
+    //   select a bucket. The bucket count doubles as the container grows.
+    // fastrange_buckets - the hash value is mixed, and the high half of its
+    //   product with the bucket count selects a bucket. Any bucket count can
+    //   be used, so the container grows in smaller steps.
+
+    struct default_buckets
+    {
+    };
+
+    struct prime_buckets
+    {
+    };
+
+    struct power_of_two_buckets
+    {
+    };
+
+    struct fastrange_buckets
+    {
+    };
+
+    template <class Hash, class = void> struct hash_bucket_policy
+    {
+      typedef default_buckets type;
+    };
+
+    template <class Hash>
+    struct hash_bucket_policy<Hash,
+      typename boost::make_void<typename Hash::bucket_policy>::type>
+    {
+      typedef typename Hash::bucket_policy type;
+    };
+
+    // Adds a bucket policy to an existing hash function, so that one can be
+    // picked per container type:
+    //
+    //   boost::unordered_map<int, int,
+    //     bucket_policy_hash<boost::hash<int>, fastrange_buckets> >
+
+    template <class Hash, class BucketPolicy>
+    struct bucket_policy_hash : Hash
+    {
+      typedef BucketPolicy bucket_policy;
+
+      bucket_policy_hash() : Hash() {}
+      explicit bucket_policy_hash(Hash const& hf) : Hash(hf) {}
+    };
+
+    // A hash function can ask the node based containers to defend against
+    // long collision chains, by providing a nested 'collision_policy'
+    // typedef naming one of the following:
+    //
+    // no_collision_defence - the default, hash values are only mixed as the
+    //   bucket policy requires.
+    // adaptive_collision_defence - inserting into a bucket counts the
+    //   elements already there. When there are too many, the container picks
+    //   a random seed, mixes every hash value with it from then on, and
+    //   rehashes. Until that happens, hashing costs the same as with
+    //   no_collision_defence. Keys with equal hash values still collide.
+
+    struct no_collision_defence
+    {
+    };
+
+    struct adaptive_collision_defence
+    {
+    };
+
+    template <class Hash, class = void> struct hash_collision_policy
+    {
+      typedef no_collision_defence type;
+    };
+
+    template <class Hash>
+    struct hash_collision_policy<Hash,
+      typename boost::make_void<typename Hash::collision_policy>::type>
+    {
+      typedef typename Hash::collision_policy type;
+    };
+
+    // Adds a collision policy to an existing hash function, in the same way
+    // as bucket_policy_hash:
+    //
+    //   boost::unordered_map<int, int,
+    //     collision_policy_hash<boost::hash<int>,
+    //       adaptive_collision_defence> >
+
+    template <class Hash, class CollisionPolicy>
+    struct collision_policy_hash : Hash
+    {
+      typedef CollisionPolicy collision_policy;
+
+      collision_policy_hash() : Hash() {}
+      explicit collision_policy_hash(Hash const& hf) : Hash(hf) {}
+    };
+
+    // A hash function can also choose how the node based containers link
+    // their nodes, by providing a nested 'link_policy' typedef naming one of
+    // the following:
+    //
+    // forward_links - the default, each node only links to the next one.
+    //   Erasing or extracting by iterator walks the element's bucket to find
+    //   the node before it.
+    // back_links - each node also links to the node before it, so erasing
+    //   or extracting by iterator takes constant time, however long the
+    //   bucket's chain. Costs an extra pointer per node.
+    //
+    // The policy is part of the container's type, so containers with and
+    // without back links can be mixed freely.
+
+    struct forward_links
+    {
+    };
+
+    struct back_links
+    {
+    };
+
+    template <class Hash, class = void> struct hash_link_policy
+    {
+      typedef forward_links type;
+    };
+
+    template <class Hash>
+    struct hash_link_policy<Hash,
+      typename boost::make_void<typename Hash::link_policy>::type>
+    {
+      typedef typename Hash::link_policy type;
+    };
+
+    // Adds a link policy to an existing hash function, in the same way as
+    // bucket_policy_hash:
+    //
+    //   boost::unordered_map<int, int,
+    //     link_policy_hash<boost::hash<int>, back_links> >
+
+    template <class Hash, class LinkPolicy>
+    struct link_policy_hash : Hash
+    {
+      typedef LinkPolicy link_policy;
+
+      link_policy_hash() : Hash() {}
+      explicit link_policy_hash(Hash const& hf) : Hash(hf) {}
+    };
+  }
+}
+
+#endif
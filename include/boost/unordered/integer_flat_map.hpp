@@ -0,0 +1,311 @@
+
+// Copyright 2022 Christian Mazakas.
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_UNORDERED_INTEGER_FLAT_MAP_HPP_INCLUDED
+#define BOOST_UNORDERED_INTEGER_FLAT_MAP_HPP_INCLUDED
+
+#include <boost/config.hpp>
+#if defined(BOOST_HAS_PRAGMA_ONCE)
+#pragma once
+#endif
+
+#include <boost/unordered/detail/integer_flat_table.hpp>
+
+#if !defined(BOOST_NO_CXX11_RVALUE_REFERENCES) &&                              \
+  !defined(BOOST_NO_CXX11_VARIADIC_TEMPLATES)
+
+#include <boost/functional/hash.hpp>
+#include <boost/throw_exception.hpp>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+#if !defined(BOOST_NO_CXX11_HDR_INITIALIZER_LIST)
+#include <initializer_list>
+#endif
+
+namespace boost {
+  namespace unordered {
+
+    // An open addressing map for keys of integral types of 4 or 8 bytes.
+    // The keys are kept in their own array, and compared a group at a time,
+    // so the values are reached through a pair of references.
+
+    template <class K, class T, class H = boost::hash<K>,
+      class A = std::allocator<std::pair<const K, T> > >
+    class integer_flat_map
+    {
+      typedef boost::unordered::detail::integer_flat_table<K, T, H, A> table;
+
+    public:
+      typedef K key_type;
+      typedef T mapped_type;
+      typedef std::pair<const K, T> value_type;
+      typedef H hasher;
+      typedef A allocator_type;
+      typedef std::size_t size_type;
+      typedef std::ptrdiff_t difference_type;
+      typedef boost::unordered::iterator_detail::integer_map_iterator<table, K,
+        T>
+        iterator;
+      typedef boost::unordered::iterator_detail::integer_map_iterator<table, K,
+        T const>
+        const_iterator;
+      typedef typename iterator::reference reference;
+      typedef typename const_iterator::reference const_reference;
+
+    private:
+      table table_;
+
+    public:
+      // construct/destroy
+
+      integer_flat_map() : table_(0, hasher(), allocator_type()) {}
+
+      explicit integer_flat_map(size_type n, hasher const& hf = hasher(),
+        allocator_type const& a = allocator_type())
+          : table_(n, hf, a)
+      {
+      }
+
+      explicit integer_flat_map(allocator_type const& a)
+          : table_(0, hasher(), a)
+      {
+      }
+
+      template <class InputIt>
+      integer_flat_map(InputIt first, InputIt last, size_type n = 0,
+        hasher const& hf = hasher(),
+        allocator_type const& a = allocator_type())
+          : table_(n, hf, a)
+      {
+        this->insert(first, last);
+      }
+
+#if !defined(BOOST_NO_CXX11_HDR_INITIALIZER_LIST)
+      integer_flat_map(std::initializer_list<value_type> list,
+        size_type n = 0, hasher const& hf = hasher(),
+        allocator_type const& a = allocator_type())
+          : table_(n, hf, a)
+      {
+        this->insert(list.begin(), list.end());
+      }
+#endif
+
+      integer_flat_map(integer_flat_map const& x)
+          : table_(x.table_,
+              boost::unordered::detail::allocator_traits<allocator_type>::
+                select_on_container_copy_construction(x.table_.alloc_))
+      {
+      }
+
+      integer_flat_map(integer_flat_map&& x)
+          : table_(0, x.table_.hf_, x.table_.alloc_)
+      {
+        table_.swap(x.table_);
+      }
+
+      integer_flat_map& operator=(integer_flat_map const& x)
+      {
+        if (this != &x) {
+          integer_flat_map tmp(x);
+          this->swap(tmp);
+        }
+        return *this;
+      }
+
+      integer_flat_map& operator=(integer_flat_map&& x)
+      {
+        if (this != &x) {
+          integer_flat_map tmp(std::move(x));
+          this->swap(tmp);
+        }
+        return *this;
+      }
+
+      allocator_type get_allocator() const { return table_.alloc_; }
+
+      // iterators
+
+      iterator begin() BOOST_NOEXCEPT
+      {
+        return iterator(&table_, table_.first());
+      }
+
+      const_iterator begin() const BOOST_NOEXCEPT
+      {
+        return const_iterator(&table_, table_.first());
+      }
+
+      iterator end() BOOST_NOEXCEPT { return iterator(&table_, table_.end()); }
+
+      const_iterator end() const BOOST_NOEXCEPT
+      {
+        return const_iterator(&table_, table_.end());
+      }
+
+      const_iterator cbegin() const BOOST_NOEXCEPT { return this->begin(); }
+
+      const_iterator cend() const BOOST_NOEXCEPT { return this->end(); }
+
+      // size and capacity
+
+      bool empty() const BOOST_NOEXCEPT { return table_.size_ == 0; }
+
+      size_type size() const BOOST_NOEXCEPT { return table_.size_; }
+
+      size_type max_size() const BOOST_NOEXCEPT
+      {
+        return (std::numeric_limits<size_type>::max)() /
+               (sizeof(K) + sizeof(T));
+      }
+
+      // modifiers
+
+      template <class... Args>
+      std::pair<iterator, bool> try_emplace(key_type k, Args&&... args)
+      {
+        std::pair<std::size_t, bool> r =
+          table_.try_emplace(k, std::forward<Args>(args)...);
+        return std::make_pair(iterator(&table_, r.first), r.second);
+      }
+
+      std::pair<iterator, bool> insert(value_type const& x)
+      {
+        return this->try_emplace(x.first, x.second);
+      }
+
+      std::pair<iterator, bool> insert(value_type&& x)
+      {
+        return this->try_emplace(x.first, std::move(x.second));
+      }
+
+      template <class InputIt> void insert(InputIt first, InputIt last)
+      {
+        for (; first != last; ++first) {
+          this->insert(*first);
+        }
+      }
+
+#if !defined(BOOST_NO_CXX11_HDR_INITIALIZER_LIST)
+      void insert(std::initializer_list<value_type> list)
+      {
+        this->insert(list.begin(), list.end());
+      }
+#endif
+
+      template <class M>
+      std::pair<iterator, bool> insert_or_assign(key_type k, M&& obj)
+      {
+        std::pair<iterator, bool> r =
+          this->try_emplace(k, std::forward<M>(obj));
+        if (!r.second) {
+          r.first->second = std::forward<M>(obj);
+        }
+        return r;
+      }
+
+      // Erasing leaves the other elements in place, so the iterators to
+      // them stay valid.
+      iterator erase(const_iterator position)
+      {
+        table_.erase(position.slot_);
+        return iterator(&table_, table_.next(position.slot_));
+      }
+
+      iterator erase(iterator position)
+      {
+        return this->erase(const_iterator(position));
+      }
+
+      size_type erase(key_type k)
+      {
+        std::size_t const i = table_.find(k);
+        if (i == table_.end()) {
+          return 0;
+        }
+        table_.erase(i);
+        return 1;
+      }
+
+      void clear() BOOST_NOEXCEPT { table_.clear(); }
+
+      void swap(integer_flat_map& x) { table_.swap(x.table_); }
+
+      // observers
+
+      hasher hash_function() const { return table_.hf_; }
+
+      // lookup
+
+      iterator find(key_type k) { return iterator(&table_, table_.find(k)); }
+
+      const_iterator find(key_type k) const
+      {
+        return const_iterator(&table_, table_.find(k));
+      }
+
+      bool contains(key_type k) const { return table_.find(k) != table_.end(); }
+
+      size_type count(key_type k) const { return this->contains(k) ? 1 : 0; }
+
+      mapped_type& operator[](key_type k)
+      {
+        return table_.values_[table_.try_emplace(k).first];
+      }
+
+      mapped_type& at(key_type k)
+      {
+        std::size_t const i = table_.find(k);
+        if (i == table_.end()) {
+          boost::throw_exception(
+            std::out_of_range("Unable to find key in integer_flat_map."));
+        }
+        return table_.values_[i];
+      }
+
+      mapped_type const& at(key_type k) const
+      {
+        std::size_t const i = table_.find(k);
+        if (i == table_.end()) {
+          boost::throw_exception(
+            std::out_of_range("Unable to find key in integer_flat_map."));
+        }
+        return table_.values_[i];
+      }
+
+      // hash policy
+
+      size_type bucket_count() const BOOST_NOEXCEPT
+      {
+        return table_.slot_count();
+      }
+
+      float load_factor() const BOOST_NOEXCEPT
+      {
+        return table_.groups_ ? static_cast<float>(table_.size_) /
+                                  static_cast<float>(table_.slot_count())
+                              : 0.0f;
+      }
+
+      float max_load_factor() const BOOST_NOEXCEPT { return 0.875f; }
+
+      void reserve(size_type n) { table_.reserve(n); }
+    };
+
+    template <class K, class T, class H, class A>
+    inline void swap(
+      integer_flat_map<K, T, H, A>& x, integer_flat_map<K, T, H, A>& y)
+    {
+      x.swap(y);
+    }
+  }
+
+  using boost::unordered::integer_flat_map;
+}
+
+#endif
+
+#endif
@@ -0,0 +1,240 @@
+
+// Copyright 2022 Christian Mazakas.
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_UNORDERED_INTEGER_FLAT_SET_HPP_INCLUDED
+#define BOOST_UNORDERED_INTEGER_FLAT_SET_HPP_INCLUDED
+
+#include <boost/config.hpp>
+#if defined(BOOST_HAS_PRAGMA_ONCE)
+#pragma once
+#endif
+
+#include <boost/unordered/detail/integer_flat_table.hpp>
+
+#if !defined(BOOST_NO_CXX11_RVALUE_REFERENCES) &&                              \
+  !defined(BOOST_NO_CXX11_VARIADIC_TEMPLATES)
+
+#include <boost/functional/hash.hpp>
+#include <memory>
+#include <utility>
+
+#if !defined(BOOST_NO_CXX11_HDR_INITIALIZER_LIST)
+#include <initializer_list>
+#endif
+
+namespace boost {
+  namespace unordered {
+
+    // An open addressing set for keys of integral types of 4 or 8 bytes,
+    // which compares the keys a group at a time.
+
+    template <class K, class H = boost::hash<K>, class A = std::allocator<K> >
+    class integer_flat_set
+    {
+      typedef boost::unordered::detail::integer_flat_table<K, void, H, A>
+        table;
+
+    public:
+      typedef K key_type;
+      typedef K value_type;
+      typedef H hasher;
+      typedef A allocator_type;
+      typedef std::size_t size_type;
+      typedef std::ptrdiff_t difference_type;
+      typedef value_type const& reference;
+      typedef value_type const& const_reference;
+      typedef boost::unordered::iterator_detail::integer_set_iterator<table, K>
+        iterator;
+      typedef iterator const_iterator;
+
+    private:
+      table table_;
+
+    public:
+      // construct/destroy
+
+      integer_flat_set() : table_(0, hasher(), allocator_type()) {}
+
+      explicit integer_flat_set(size_type n, hasher const& hf = hasher(),
+        allocator_type const& a = allocator_type())
+          : table_(n, hf, a)
+      {
+      }
+
+      explicit integer_flat_set(allocator_type const& a)
+          : table_(0, hasher(), a)
+      {
+      }
+
+      template <class InputIt>
+      integer_flat_set(InputIt first, InputIt last, size_type n = 0,
+        hasher const& hf = hasher(),
+        allocator_type const& a = allocator_type())
+          : table_(n, hf, a)
+      {
+        this->insert(first, last);
+      }
+
+#if !defined(BOOST_NO_CXX11_HDR_INITIALIZER_LIST)
+      integer_flat_set(std::initializer_list<value_type> list,
+        size_type n = 0, hasher const& hf = hasher(),
+        allocator_type const& a = allocator_type())
+          : table_(n, hf, a)
+      {
+        this->insert(list.begin(), list.end());
+      }
+#endif
+
+      integer_flat_set(integer_flat_set const& x)
+          : table_(x.table_,
+              boost::unordered::detail::allocator_traits<allocator_type>::
+                select_on_container_copy_construction(x.table_.alloc_))
+      {
+      }
+
+      integer_flat_set(integer_flat_set&& x)
+          : table_(0, x.table_.hf_, x.table_.alloc_)
+      {
+        table_.swap(x.table_);
+      }
+
+      integer_flat_set& operator=(integer_flat_set const& x)
+      {
+        if (this != &x) {
+          integer_flat_set tmp(x);
+          this->swap(tmp);
+        }
+        return *this;
+      }
+
+      integer_flat_set& operator=(integer_flat_set&& x)
+      {
+        if (this != &x) {
+          integer_flat_set tmp(std::move(x));
+          this->swap(tmp);
+        }
+        return *this;
+      }
+
+      allocator_type get_allocator() const { return table_.alloc_; }
+
+      // iterators
+
+      iterator begin() const BOOST_NOEXCEPT
+      {
+        return iterator(&table_, table_.first());
+      }
+
+      iterator end() const BOOST_NOEXCEPT
+      {
+        return iterator(&table_, table_.end());
+      }
+
+      const_iterator cbegin() const BOOST_NOEXCEPT { return this->begin(); }
+
+      const_iterator cend() const BOOST_NOEXCEPT { return this->end(); }
+
+      // size and capacity
+
+      bool empty() const BOOST_NOEXCEPT { return table_.size_ == 0; }
+
+      size_type size() const BOOST_NOEXCEPT { return table_.size_; }
+
+      size_type max_size() const BOOST_NOEXCEPT
+      {
+        return (std::numeric_limits<size_type>::max)() / sizeof(K);
+      }
+
+      // modifiers
+
+      std::pair<iterator, bool> insert(key_type k)
+      {
+        std::pair<std::size_t, bool> r = table_.try_emplace(k);
+        return std::make_pair(iterator(&table_, r.first), r.second);
+      }
+
+      template <class InputIt> void insert(InputIt first, InputIt last)
+      {
+        for (; first != last; ++first) {
+          this->insert(*first);
+        }
+      }
+
+#if !defined(BOOST_NO_CXX11_HDR_INITIALIZER_LIST)
+      void insert(std::initializer_list<value_type> list)
+      {
+        this->insert(list.begin(), list.end());
+      }
+#endif
+
+      // Erasing leaves the other elements in place, so the iterators to
+      // them stay valid.
+      iterator erase(const_iterator position)
+      {
+        table_.erase(position.slot_);
+        return iterator(&table_, table_.next(position.slot_));
+      }
+
+      size_type erase(key_type k)
+      {
+        std::size_t const i = table_.find(k);
+        if (i == table_.end()) {
+          return 0;
+        }
+        table_.erase(i);
+        return 1;
+      }
+
+      void clear() BOOST_NOEXCEPT { table_.clear(); }
+
+      void swap(integer_flat_set& x) { table_.swap(x.table_); }
+
+      // observers
+
+      hasher hash_function() const { return table_.hf_; }
+
+      // lookup
+
+      const_iterator find(key_type k) const
+      {
+        return const_iterator(&table_, table_.find(k));
+      }
+
+      bool contains(key_type k) const { return table_.find(k) != table_.end(); }
+
+      size_type count(key_type k) const { return this->contains(k) ? 1 : 0; }
+
+      // hash policy
+
+      size_type bucket_count() const BOOST_NOEXCEPT
+      {
+        return table_.slot_count();
+      }
+
+      float load_factor() const BOOST_NOEXCEPT
+      {
+        return table_.groups_ ? static_cast<float>(table_.size_) /
+                                  static_cast<float>(table_.slot_count())
+                              : 0.0f;
+      }
+
+      float max_load_factor() const BOOST_NOEXCEPT { return 0.875f; }
+
+      void reserve(size_type n) { table_.reserve(n); }
+    };
+
+    template <class K, class H, class A>
+    inline void swap(integer_flat_set<K, H, A>& x, integer_flat_set<K, H, A>& y)
+    {
+      x.swap(y);
+    }
+  }
+
+  using boost::unordered::integer_flat_set;
+}
+
+#endif
+
+#endif
@@ -0,0 +1,400 @@
+
+// Copyright 2022 Christian Mazakas.
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_UNORDERED_LINKED_UNORDERED_SET_HPP_INCLUDED
+#define BOOST_UNORDERED_LINKED_UNORDERED_SET_HPP_INCLUDED
+
+#include <boost/config.hpp>
+#if defined(BOOST_HAS_PRAGMA_ONCE)
+#pragma once
+#endif
+
+#include <boost/unordered/unordered_set.hpp>
+
+#if !defined(BOOST_NO_CXX11_RVALUE_REFERENCES) &&                              \
+  !defined(BOOST_NO_CXX11_VARIADIC_TEMPLATES)
+
+#include <boost/assert.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/type_traits/is_same.hpp>
+#include <boost/unordered/detail/linked.hpp>
+#include <cmath>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <utility>
+
+#if !defined(BOOST_NO_CXX11_HDR_INITIALIZER_LIST)
+#include <initializer_list>
+#endif
+
+namespace boost {
+  namespace unordered {
+
+    // A set that iterates over its elements in the order they were
+    // inserted. Lookup uses the buckets, as unordered_set does, while
+    // iteration follows a list through links in the nodes, so erasing is
+    // still constant time, and iterating doesn't allocate.
+
+    template <class T, class H = boost::hash<T>, class P = std::equal_to<T>,
+      class A = std::allocator<T> >
+    class linked_unordered_set
+    {
+      typedef boost::unordered::detail::linked_set<A, T, H, P> types;
+      typedef typename types::table table;
+      typedef typename types::node node;
+      typedef typename table::node_pointer node_pointer;
+      typedef typename table::node_allocator_traits node_allocator_traits;
+      typedef boost::unordered::detail::order_link order_link;
+      typedef boost::unordered::detail::order_list order_list;
+
+      BOOST_STATIC_ASSERT((boost::is_same<node_pointer, node*>::value));
+
+    public:
+      typedef T key_type;
+      typedef T value_type;
+      typedef H hasher;
+      typedef P key_equal;
+      typedef A allocator_type;
+      typedef std::size_t size_type;
+      typedef std::ptrdiff_t difference_type;
+      typedef value_type& reference;
+      typedef value_type const& const_reference;
+      typedef boost::unordered::iterator_detail::order_c_iterator<node>
+        iterator;
+      typedef boost::unordered::iterator_detail::order_c_iterator<node>
+        const_iterator;
+      typedef std::reverse_iterator<iterator> reverse_iterator;
+      typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+    private:
+      table table_;
+      order_list order_;
+
+    public:
+      // construct/destroy
+
+      linked_unordered_set()
+          : table_(boost::unordered::detail::default_bucket_count, hasher(),
+              key_equal(), typename table::node_allocator(allocator_type()))
+      {
+      }
+
+      explicit linked_unordered_set(size_type n, hasher const& hf = hasher(),
+        key_equal const& eq = key_equal(),
+        allocator_type const& a = allocator_type())
+          : table_(n, hf, eq, typename table::node_allocator(a))
+      {
+      }
+
+      explicit linked_unordered_set(allocator_type const& a)
+          : table_(boost::unordered::detail::default_bucket_count, hasher(),
+              key_equal(), typename table::node_allocator(a))
+      {
+      }
+
+      template <class InputIt>
+      linked_unordered_set(InputIt first, InputIt last,
+        size_type n = boost::unordered::detail::default_bucket_count,
+        hasher const& hf = hasher(), key_equal const& eq = key_equal(),
+        allocator_type const& a = allocator_type())
+          : table_(n, hf, eq, typename table::node_allocator(a))
+      {
+        this->insert(first, last);
+      }
+
+#if !defined(BOOST_NO_CXX11_HDR_INITIALIZER_LIST)
+      linked_unordered_set(std::initializer_list<value_type> list,
+        size_type n = boost::unordered::detail::default_bucket_count,
+        hasher const& hf = hasher(), key_equal const& eq = key_equal(),
+        allocator_type const& a = allocator_type())
+          : table_(n, hf, eq, typename table::node_allocator(a))
+      {
+        this->insert(list.begin(), list.end());
+      }
+#endif
+
+      // Copies the elements in order, so that the copy iterates over them
+      // in the same order.
+      linked_unordered_set(linked_unordered_set const& x)
+          : table_(x.table_, node_allocator_traits::
+                               select_on_container_copy_construction(
+                                 x.table_.node_alloc()))
+      {
+        for (order_link* l = x.order_.first(); l != x.order_.end();
+             l = l->order_next_) {
+          node_pointer n = node::from_link(l);
+          order_.link_back(table_.resize_and_add_node_unique(
+            boost::unordered::detail::func::construct_node(
+              table_.node_source(), n->value()),
+            table_.hash(n->value())));
+        }
+      }
+
+      linked_unordered_set(linked_unordered_set&& x)
+          : table_(x.table_, boost::unordered::detail::move_tag())
+      {
+        order_.swap(x.order_);
+      }
+
+      linked_unordered_set& operator=(linked_unordered_set const& x)
+      {
+        if (this != &x) {
+          linked_unordered_set tmp(x);
+          this->swap(tmp);
+        }
+        return *this;
+      }
+
+      linked_unordered_set& operator=(linked_unordered_set&& x)
+      {
+        if (this != &x) {
+          linked_unordered_set tmp(std::move(x));
+          this->swap(tmp);
+        }
+        return *this;
+      }
+
+#if !defined(BOOST_NO_CXX11_HDR_INITIALIZER_LIST)
+      linked_unordered_set& operator=(std::initializer_list<value_type> list)
+      {
+        this->clear();
+        this->insert(list.begin(), list.end());
+        return *this;
+      }
+#endif
+
+      allocator_type get_allocator() const
+      {
+        return allocator_type(table_.node_alloc());
+      }
+
+      // iterators, in insertion order
+
+      const_iterator begin() const BOOST_NOEXCEPT
+      {
+        return const_iterator(order_.first());
+      }
+
+      const_iterator end() const BOOST_NOEXCEPT
+      {
+        return const_iterator(order_.end());
+      }
+
+      const_iterator cbegin() const BOOST_NOEXCEPT { return this->begin(); }
+
+      const_iterator cend() const BOOST_NOEXCEPT { return this->end(); }
+
+      const_reverse_iterator rbegin() const BOOST_NOEXCEPT
+      {
+        return const_reverse_iterator(this->end());
+      }
+
+      const_reverse_iterator rend() const BOOST_NOEXCEPT
+      {
+        return const_reverse_iterator(this->begin());
+      }
+
+      // The first and last inserted elements.
+
+      const_reference front() const
+      {
+        BOOST_ASSERT(!this->empty());
+        return *this->begin();
+      }
+
+      const_reference back() const
+      {
+        BOOST_ASSERT(!this->empty());
+        return *const_iterator(order_.last());
+      }
+
+      // size and capacity
+
+      bool empty() const BOOST_NOEXCEPT { return table_.size_ == 0; }
+
+      size_type size() const BOOST_NOEXCEPT { return table_.size_; }
+
+      size_type max_size() const BOOST_NOEXCEPT
+      {
+        using namespace std;
+
+        // size <= mlf_ * count
+        return boost::unordered::detail::double_to_size(
+                 ceil(static_cast<double>(table_.mlf_) *
+                      static_cast<double>(table_.max_bucket_count()))) -
+               1;
+      }
+
+      // modifiers, which add new elements after the existing ones
+
+      template <class... Args>
+      std::pair<iterator, bool> emplace(Args&&... args)
+      {
+        return this->link_new(table_.emplace_unique(
+          table::extractor::extract(std::forward<Args>(args)...),
+          std::forward<Args>(args)...));
+      }
+
+      std::pair<iterator, bool> insert(value_type const& x)
+      {
+        return this->emplace(x);
+      }
+
+      std::pair<iterator, bool> insert(value_type&& x)
+      {
+        return this->emplace(std::move(x));
+      }
+
+      template <class InputIt> void insert(InputIt first, InputIt last)
+      {
+        for (; first != last; ++first) {
+          this->emplace(*first);
+        }
+      }
+
+#if !defined(BOOST_NO_CXX11_HDR_INITIALIZER_LIST)
+      void insert(std::initializer_list<value_type> list)
+      {
+        this->insert(list.begin(), list.end());
+      }
+#endif
+
+      // Returns the element that followed the erased one in the order.
+      iterator erase(const_iterator position)
+      {
+        BOOST_ASSERT(position != this->end());
+        node_pointer n = node::from_link(position.link_);
+        order_link* next = n->order_next_;
+        order_list::unlink(n);
+        table_.erase_nodes_unique(n, table::next_node(n));
+        return iterator(next);
+      }
+
+      iterator erase(const_iterator first, const_iterator last)
+      {
+        while (first != last) {
+          first = this->erase(first);
+        }
+        return iterator(last.link_);
+      }
+
+      size_type erase(key_type const& k)
+      {
+        node_pointer n = table_.find_node(k);
+        if (!n) {
+          return 0;
+        }
+        this->erase(const_iterator(n));
+        return 1;
+      }
+
+      void clear() BOOST_NOEXCEPT
+      {
+        table_.clear_impl();
+        order_.clear();
+      }
+
+      void swap(linked_unordered_set& x)
+      {
+        table_.swap(x.table_);
+        order_.swap(x.order_);
+      }
+
+      // observers
+
+      hasher hash_function() const { return table_.hash_function(); }
+
+      key_equal key_eq() const { return table_.key_eq(); }
+
+      // lookup
+
+      const_iterator find(key_type const& k) const
+      {
+        return this->make_iterator(table_.find_node(k));
+      }
+
+      bool contains(key_type const& k) const
+      {
+        return table_.find_node(k) != node_pointer();
+      }
+
+      size_type count(key_type const& k) const
+      {
+        return this->contains(k) ? 1 : 0;
+      }
+
+      std::pair<const_iterator, const_iterator> equal_range(
+        key_type const& k) const
+      {
+        node_pointer n = table_.find_node(k);
+        if (!n) {
+          return std::make_pair(this->end(), this->end());
+        }
+        return std::make_pair(
+          const_iterator(n), const_iterator(n->order_next_));
+      }
+
+      // hash policy
+
+      size_type bucket_count() const BOOST_NOEXCEPT
+      {
+        return table_.bucket_count_;
+      }
+
+      float load_factor() const BOOST_NOEXCEPT
+      {
+        BOOST_ASSERT(table_.bucket_count_ != 0);
+        return static_cast<float>(table_.size_) /
+               static_cast<float>(table_.bucket_count_);
+      }
+
+      float max_load_factor() const BOOST_NOEXCEPT { return table_.mlf_; }
+
+      void max_load_factor(float m) BOOST_NOEXCEPT
+      {
+        table_.max_load_factor(m);
+      }
+
+      void rehash(size_type n) { table_.rehash(n); }
+
+      void reserve(size_type n)
+      {
+        table_.rehash(static_cast<std::size_t>(
+          std::ceil(static_cast<double>(n) / table_.mlf_)));
+      }
+
+    private:
+      // Links a newly inserted node at the end of the order.
+      std::pair<iterator, bool> link_new(
+        typename table::emplace_return const& r)
+      {
+        node_pointer n = table::get_node(r.first);
+        if (r.second) {
+          order_.link_back(n);
+        }
+        return std::make_pair(iterator(n), r.second);
+      }
+
+      iterator make_iterator(node_pointer n) const
+      {
+        return n ? iterator(n) : iterator(order_.end());
+      }
+    };
+
+    template <class T, class H, class P, class A>
+    inline void swap(
+      linked_unordered_set<T, H, P, A>& x, linked_unordered_set<T, H, P, A>& y)
+    {
+      x.swap(y);
+    }
+  }
+
+  using boost::unordered::linked_unordered_set;
+}
+
+#endif
+
+#endif
@@ -0,0 +1,478 @@
+
+// Copyright 2022 Christian Mazakas.
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_UNORDERED_LRU_UNORDERED_MAP_HPP_INCLUDED
+#define BOOST_UNORDERED_LRU_UNORDERED_MAP_HPP_INCLUDED
+
+#include <boost/config.hpp>
+#if defined(BOOST_HAS_PRAGMA_ONCE)
+#pragma once
+#endif
+
+#include <boost/unordered/unordered_map.hpp>
+
+#if !defined(BOOST_NO_CXX11_RVALUE_REFERENCES) &&                              \
+  !defined(BOOST_NO_CXX11_VARIADIC_TEMPLATES)
+
+#include <boost/assert.hpp>
+#include <boost/core/swap.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/throw_exception.hpp>
+#include <boost/type_traits/is_same.hpp>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+namespace boost {
+  namespace unordered {
+    namespace detail {
+
+      // A node that is also linked into a list in order of use, through the
+      // links after its value.
+      template <typename T, bool BackLinks = false>
+      struct lru_node : boost::unordered::detail::ptr_node<T, BackLinks>
+      {
+        typedef lru_node<T, BackLinks>* node_pointer;
+
+        node_pointer lru_prev_;
+        node_pointer lru_next_;
+
+        lru_node()
+            : boost::unordered::detail::ptr_node<T, BackLinks>(), lru_prev_(),
+              lru_next_()
+        {
+        }
+
+      private:
+        lru_node& operator=(lru_node const&);
+      };
+
+      template <typename A, typename K, typename M, typename H, typename P>
+      struct lru_map
+      {
+        typedef boost::unordered::detail::lru_map<A, K, M, H, P> types;
+
+        typedef std::pair<K const, M> value_type;
+        typedef H hasher;
+        typedef P key_equal;
+        typedef K const const_key_type;
+
+        typedef
+          typename ::boost::unordered::detail::rebind_wrap<A, value_type>::type
+            value_allocator;
+        typedef boost::unordered::detail::allocator_traits<value_allocator>
+          value_allocator_traits;
+
+        typedef boost::unordered::detail::lru_node<value_type,
+          boost::unordered::detail::pick_back_links<H>::value>
+          node;
+        typedef boost::unordered::detail::ptr_bucket bucket;
+        typedef bucket* link_pointer;
+
+        typedef boost::unordered::detail::table<types> table;
+        typedef boost::unordered::detail::map_extractor<value_type> extractor;
+
+        typedef typename boost::unordered::detail::pick_bucket_policy<K,
+          H>::type policy;
+
+        typedef boost::unordered::iterator_detail::iterator<node> iterator;
+        typedef boost::unordered::iterator_detail::c_iterator<node> c_iterator;
+        typedef boost::unordered::iterator_detail::l_iterator<node> l_iterator;
+        typedef boost::unordered::iterator_detail::cl_iterator<node>
+          cl_iterator;
+      };
+    }
+
+    // The default eviction callback, which does nothing.
+    struct ignore_eviction
+    {
+      template <class T> void operator()(T&) const {}
+    };
+
+    // A map that holds at most 'capacity' elements, and makes room for a new
+    // one by evicting the least recently used. The order of use is kept in
+    // links stored in the nodes themselves, so marking an element as used
+    // doesn't allocate, and an evicted node is reused for a later element.
+
+    template <class K, class T, class H = boost::hash<K>,
+      class P = std::equal_to<K>,
+      class A = std::allocator<std::pair<const K, T> >,
+      class E = boost::unordered::ignore_eviction>
+    class lru_unordered_map
+    {
+      typedef boost::unordered::detail::lru_map<A, K, T, H, P> types;
+      typedef typename types::table table;
+      typedef typename table::node_pointer node_pointer;
+      typedef typename table::node_allocator_traits node_allocator_traits;
+
+      BOOST_STATIC_ASSERT((boost::is_same<node_pointer,
+        typename types::node*>::value));
+
+    public:
+      typedef K key_type;
+      typedef T mapped_type;
+      typedef std::pair<const K, T> value_type;
+      typedef H hasher;
+      typedef P key_equal;
+      typedef A allocator_type;
+      typedef E eviction_callback;
+      typedef std::size_t size_type;
+      typedef std::ptrdiff_t difference_type;
+      typedef value_type& reference;
+      typedef value_type const& const_reference;
+      typedef typename types::iterator iterator;
+      typedef typename types::c_iterator const_iterator;
+
+    private:
+      table table_;
+      node_pointer head_; // most recently used
+      node_pointer tail_; // least recently used
+      size_type capacity_;
+      eviction_callback on_evict_;
+
+    public:
+      // construct/destroy
+
+      explicit lru_unordered_map(size_type capacity,
+        eviction_callback const& on_evict = eviction_callback(),
+        hasher const& hf = hasher(), key_equal const& eq = key_equal(),
+        allocator_type const& a = allocator_type())
+          : table_(boost::unordered::detail::default_bucket_count, hf, eq,
+              typename table::node_allocator(a)),
+            head_(), tail_(), capacity_(capacity), on_evict_(on_evict)
+      {
+        BOOST_ASSERT(capacity_ > 0);
+      }
+
+      // Copies the elements from least to most recently used, so that the
+      // copy has the same order.
+      lru_unordered_map(lru_unordered_map const& x)
+          : table_(x.table_, node_allocator_traits::
+                               select_on_container_copy_construction(
+                                 x.table_.node_alloc())),
+            head_(), tail_(), capacity_(x.capacity_), on_evict_(x.on_evict_)
+      {
+        for (node_pointer n = x.tail_; n; n = n->lru_prev_) {
+          this->link_front(table_.resize_and_add_node_unique(
+            boost::unordered::detail::func::construct_node(
+              table_.node_source(), n->value()),
+            table_.hash(n->value().first)));
+        }
+      }
+
+      lru_unordered_map(lru_unordered_map&& x)
+          : table_(x.table_, boost::unordered::detail::move_tag()),
+            head_(x.head_), tail_(x.tail_), capacity_(x.capacity_),
+            on_evict_(x.on_evict_)
+      {
+        x.head_ = node_pointer();
+        x.tail_ = node_pointer();
+      }
+
+      lru_unordered_map& operator=(lru_unordered_map const& x)
+      {
+        if (this != &x) {
+          lru_unordered_map tmp(x);
+          this->swap(tmp);
+        }
+        return *this;
+      }
+
+      lru_unordered_map& operator=(lru_unordered_map&& x)
+      {
+        if (this != &x) {
+          lru_unordered_map tmp(std::move(x));
+          this->swap(tmp);
+        }
+        return *this;
+      }
+
+      allocator_type get_allocator() const
+      {
+        return allocator_type(table_.node_alloc());
+      }
+
+      // iterators, in no particular order
+
+      iterator begin() BOOST_NOEXCEPT { return iterator(table_.begin()); }
+
+      const_iterator begin() const BOOST_NOEXCEPT
+      {
+        return const_iterator(table_.begin());
+      }
+
+      iterator end() BOOST_NOEXCEPT { return iterator(); }
+
+      const_iterator end() const BOOST_NOEXCEPT { return const_iterator(); }
+
+      // recency
+
+      // The element that would be evicted next, or end() if empty.
+      const_iterator least_recent() const BOOST_NOEXCEPT
+      {
+        return const_iterator(tail_);
+      }
+
+      const_iterator most_recent() const BOOST_NOEXCEPT
+      {
+        return const_iterator(head_);
+      }
+
+      // Calls f with each element, from the most to the least recently used.
+      template <class F> void visit_by_recency(F f) const
+      {
+        for (node_pointer n = head_; n; n = n->lru_next_) {
+          f(const_cast<value_type const&>(n->value()));
+        }
+      }
+
+      // Marks an element as the most recently used.
+      void touch(const_iterator it)
+      {
+        node_pointer n = table::get_node(it);
+        BOOST_ASSERT(n);
+        this->promote(n);
+      }
+
+      // size and capacity
+
+      bool empty() const BOOST_NOEXCEPT { return table_.size_ == 0; }
+
+      size_type size() const BOOST_NOEXCEPT { return table_.size_; }
+
+      size_type capacity() const BOOST_NOEXCEPT { return capacity_; }
+
+      // Evicts the least recently used elements until there are no more
+      // than 'capacity'.
+      void set_capacity(size_type capacity)
+      {
+        BOOST_ASSERT(capacity > 0);
+        while (table_.size_ > capacity) {
+          this->evict();
+        }
+        capacity_ = capacity;
+      }
+
+      // lookup, which marks the element found as the most recently used
+
+      iterator find(key_type const& k)
+      {
+        node_pointer n = table_.find_node(k);
+        if (n) {
+          this->promote(n);
+        }
+        return iterator(n);
+      }
+
+      mapped_type& at(key_type const& k)
+      {
+        node_pointer n = table_.find_node(k);
+        if (!n) {
+          boost::throw_exception(
+            std::out_of_range("Unable to find key in lru_unordered_map."));
+        }
+        this->promote(n);
+        return n->value().second;
+      }
+
+      mapped_type& operator[](key_type const& k)
+      {
+        return this->try_emplace(k).first->second;
+      }
+
+      // lookup, which leaves the order of use unchanged
+
+      const_iterator peek(key_type const& k) const
+      {
+        return const_iterator(table_.find_node(k));
+      }
+
+      bool contains(key_type const& k) const
+      {
+        return table_.find_node(k) != node_pointer();
+      }
+
+      size_type count(key_type const& k) const
+      {
+        return this->contains(k) ? 1 : 0;
+      }
+
+      // modifiers, which mark the element inserted or found as the most
+      // recently used
+
+      template <class... Args>
+      std::pair<iterator, bool> try_emplace(key_type const& k, Args&&... args)
+      {
+        return this->try_emplace_impl(k, std::forward<Args>(args)...);
+      }
+
+      template <class... Args>
+      std::pair<iterator, bool> try_emplace(key_type&& k, Args&&... args)
+      {
+        return this->try_emplace_impl(
+          std::move(k), std::forward<Args>(args)...);
+      }
+
+      std::pair<iterator, bool> insert(value_type const& x)
+      {
+        return this->try_emplace_impl(x.first, x.second);
+      }
+
+      std::pair<iterator, bool> insert(value_type&& x)
+      {
+        return this->try_emplace_impl(x.first, std::move(x.second));
+      }
+
+      template <class M>
+      std::pair<iterator, bool> insert_or_assign(key_type const& k, M&& obj)
+      {
+        node_pointer n = table_.find_node(k);
+        if (n) {
+          n->value().second = std::forward<M>(obj);
+          this->promote(n);
+          return std::make_pair(iterator(n), false);
+        }
+        return this->try_emplace_impl(k, std::forward<M>(obj));
+      }
+
+      // erasure, which doesn't call the eviction callback
+
+      iterator erase(const_iterator position)
+      {
+        node_pointer n = table::get_node(position);
+        BOOST_ASSERT(n);
+        node_pointer next = table::next_node(n);
+        this->unlink(n);
+        table_.erase_nodes_unique(n, next);
+        return iterator(next);
+      }
+
+      size_type erase(key_type const& k)
+      {
+        node_pointer n = table_.find_node(k);
+        if (!n) {
+          return 0;
+        }
+        this->erase(const_iterator(n));
+        return 1;
+      }
+
+      void clear() BOOST_NOEXCEPT
+      {
+        table_.clear_impl();
+        head_ = node_pointer();
+        tail_ = node_pointer();
+      }
+
+      void swap(lru_unordered_map& x)
+      {
+        table_.swap(x.table_);
+        boost::swap(head_, x.head_);
+        boost::swap(tail_, x.tail_);
+        boost::swap(capacity_, x.capacity_);
+        boost::swap(on_evict_, x.on_evict_);
+      }
+
+      // observers
+
+      hasher hash_function() const { return table_.hash_function(); }
+
+      key_equal key_eq() const { return table_.key_eq(); }
+
+      eviction_callback const& get_eviction_callback() const
+      {
+        return on_evict_;
+      }
+
+    private:
+      template <class Key, class... Args>
+      std::pair<iterator, bool> try_emplace_impl(Key&& k, Args&&... args)
+      {
+        std::size_t const key_hash = table_.hash(k);
+        node_pointer n = table_.find_node(key_hash, k);
+        if (n) {
+          this->promote(n);
+          return std::make_pair(iterator(n), false);
+        }
+
+        // The new element is constructed before anything is evicted, so if
+        // that throws, or the arguments refer to the element that's evicted,
+        // the map is unchanged. The evicted node is kept as a spare for the
+        // next new element. Evicting keeps the size within the current
+        // load, so adding the node doesn't rehash.
+        typename table::node_tmp b(
+          boost::unordered::detail::func::construct_node_pair_from_args(
+            table_.node_source(), std::forward<Key>(k),
+            std::forward<Args>(args)...),
+          table_.node_alloc());
+        if (table_.size_ >= capacity_) {
+          this->evict();
+        }
+        n = table_.resize_and_add_node_unique(b.release(), key_hash);
+        this->link_front(n);
+        return std::make_pair(iterator(n), true);
+      }
+
+      // The callback is called first, so if it throws, nothing is evicted.
+      void evict()
+      {
+        node_pointer n = tail_;
+        BOOST_ASSERT(n);
+        on_evict_(n->value());
+        this->unlink(n);
+        table_.recycle_node(
+          table_.extract_by_iterator_unique(const_iterator(n)));
+      }
+
+      void link_front(node_pointer n) BOOST_NOEXCEPT
+      {
+        n->lru_prev_ = node_pointer();
+        n->lru_next_ = head_;
+        if (head_) {
+          head_->lru_prev_ = n;
+        } else {
+          tail_ = n;
+        }
+        head_ = n;
+      }
+
+      void unlink(node_pointer n) BOOST_NOEXCEPT
+      {
+        if (n->lru_prev_) {
+          n->lru_prev_->lru_next_ = n->lru_next_;
+        } else {
+          head_ = n->lru_next_;
+        }
+        if (n->lru_next_) {
+          n->lru_next_->lru_prev_ = n->lru_prev_;
+        } else {
+          tail_ = n->lru_prev_;
+        }
+      }
+
+      void promote(node_pointer n) BOOST_NOEXCEPT
+      {
+        if (n != head_) {
+          this->unlink(n);
+          this->link_front(n);
+        }
+      }
+    };
+
+    template <class K, class T, class H, class P, class A, class E>
+    inline void swap(lru_unordered_map<K, T, H, P, A, E>& x,
+      lru_unordered_map<K, T, H, P, A, E>& y)
+    {
+      x.swap(y);
+    }
+  }
+
+  using boost::unordered::lru_unordered_map;
+}
+
+#endif
+
+#endif
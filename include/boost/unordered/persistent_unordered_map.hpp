@@ -0,0 +1,438 @@
+
+// Copyright 2022 Christian Mazakas.
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_UNORDERED_PERSISTENT_UNORDERED_MAP_HPP_INCLUDED
+#define BOOST_UNORDERED_PERSISTENT_UNORDERED_MAP_HPP_INCLUDED
+
+#include <boost/config.hpp>
+#if defined(BOOST_HAS_PRAGMA_ONCE)
+#pragma once
+#endif
+
+#include <boost/unordered/detail/hamt.hpp>
+
+#if !defined(BOOST_NO_CXX11_HDR_ATOMIC) &&                                     \
+  !defined(BOOST_NO_CXX11_RVALUE_REFERENCES) &&                                \
+  !defined(BOOST_NO_CXX11_VARIADIC_TEMPLATES)
+
+#include <boost/functional/hash.hpp>
+#include <boost/throw_exception.hpp>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+
+#if !defined(BOOST_NO_CXX11_HDR_INITIALIZER_LIST)
+#include <initializer_list>
+#endif
+
+namespace boost {
+  namespace unordered {
+
+    // A map whose copies share their elements, so that copying it is
+    // constant time, and a copy is a snapshot that later changes to the
+    // original don't affect. A change copies the nodes on the path to the
+    // element, if they are shared, and an element's value is copied before
+    // it's changed, if it's shared.
+    //
+    // The elements can't be changed through the iterators, which are all
+    // constant. Different copies can be used on different threads at the
+    // same time, including changing one while others are read.
+
+    template <class K, class T, class H = boost::hash<K>,
+      class P = std::equal_to<K>,
+      class A = std::allocator<std::pair<const K, T> > >
+    class persistent_unordered_map
+    {
+      typedef boost::unordered::detail::hamt_table<A, K, T, H, P> table;
+      typedef typename table::leaf leaf;
+
+    public:
+      typedef K key_type;
+      typedef T mapped_type;
+      typedef std::pair<const K, T> value_type;
+      typedef H hasher;
+      typedef P key_equal;
+      typedef A allocator_type;
+      typedef std::size_t size_type;
+      typedef std::ptrdiff_t difference_type;
+      typedef value_type& reference;
+      typedef value_type const& const_reference;
+      typedef typename table::iterator iterator;
+      typedef typename table::iterator const_iterator;
+
+    private:
+      table table_;
+
+    public:
+      // construct/destroy
+
+      persistent_unordered_map() : table_(hasher(), key_equal(), A()) {}
+
+      // There are no buckets, so 'n' is only accepted for compatibility with
+      // unordered_map.
+      explicit persistent_unordered_map(size_type, hasher const& hf = hasher(),
+        key_equal const& eq = key_equal(),
+        allocator_type const& a = allocator_type())
+          : table_(hf, eq, a)
+      {
+      }
+
+      explicit persistent_unordered_map(allocator_type const& a)
+          : table_(hasher(), key_equal(), a)
+      {
+      }
+
+      template <class InputIt>
+      persistent_unordered_map(InputIt first, InputIt last, size_type = 0,
+        hasher const& hf = hasher(), key_equal const& eq = key_equal(),
+        allocator_type const& a = allocator_type())
+          : table_(hf, eq, a)
+      {
+        this->insert(first, last);
+      }
+
+#if !defined(BOOST_NO_CXX11_HDR_INITIALIZER_LIST)
+      persistent_unordered_map(std::initializer_list<value_type> list,
+        size_type = 0, hasher const& hf = hasher(),
+        key_equal const& eq = key_equal(),
+        allocator_type const& a = allocator_type())
+          : table_(hf, eq, a)
+      {
+        this->insert(list.begin(), list.end());
+      }
+#endif
+
+      // Constant time, as the copy shares the elements.
+      persistent_unordered_map(persistent_unordered_map const& x)
+          : table_(x.table_)
+      {
+      }
+
+      persistent_unordered_map(persistent_unordered_map&& x)
+          : table_(x.table_.hf_, x.table_.eq_, x.get_allocator())
+      {
+        table_.swap(x.table_);
+      }
+
+      persistent_unordered_map& operator=(persistent_unordered_map const& x)
+      {
+        if (this != &x) {
+          persistent_unordered_map tmp(x);
+          this->swap(tmp);
+        }
+        return *this;
+      }
+
+      persistent_unordered_map& operator=(persistent_unordered_map&& x)
+      {
+        if (this != &x) {
+          persistent_unordered_map tmp(std::move(x));
+          this->swap(tmp);
+        }
+        return *this;
+      }
+
+#if !defined(BOOST_NO_CXX11_HDR_INITIALIZER_LIST)
+      persistent_unordered_map& operator=(
+        std::initializer_list<value_type> list)
+      {
+        persistent_unordered_map tmp(
+          list, 0, table_.hf_, table_.eq_, this->get_allocator());
+        this->swap(tmp);
+        return *this;
+      }
+#endif
+
+      allocator_type get_allocator() const
+      {
+        return allocator_type(table_.leaf_alloc_);
+      }
+
+      // iterators, which are invalidated by any change to this copy
+
+      const_iterator begin() const BOOST_NOEXCEPT { return table_.begin(); }
+
+      const_iterator end() const BOOST_NOEXCEPT { return const_iterator(); }
+
+      const_iterator cbegin() const BOOST_NOEXCEPT { return this->begin(); }
+
+      const_iterator cend() const BOOST_NOEXCEPT { return this->end(); }
+
+      // size and capacity
+
+      bool empty() const BOOST_NOEXCEPT { return table_.size_ == 0; }
+
+      size_type size() const BOOST_NOEXCEPT { return table_.size_; }
+
+      size_type max_size() const BOOST_NOEXCEPT
+      {
+        return (std::numeric_limits<size_type>::max)() / sizeof(leaf);
+      }
+
+      // modifiers
+
+      template <class... Args>
+      std::pair<iterator, bool> emplace(Args&&... args)
+      {
+        leaf* l = table_.create_leaf(std::forward<Args>(args)...);
+        BOOST_TRY
+        {
+          l->hash_ = table_.hash(table::key(l));
+          if (table_.find(l->hash_, table::key(l))) {
+            std::pair<iterator, bool> r(
+              table_.find_iterator(l->hash_, table::key(l)), false);
+            table_.destroy_leaf(l);
+            return r;
+          }
+          table_.insert(l);
+        }
+        BOOST_CATCH(...)
+        {
+          table_.destroy_leaf(l);
+          BOOST_RETHROW
+        }
+        BOOST_CATCH_END
+        return std::make_pair(
+          table_.find_iterator(l->hash_, table::key(l)), true);
+      }
+
+      template <class... Args>
+      std::pair<iterator, bool> try_emplace(key_type const& k, Args&&... args)
+      {
+        return this->try_emplace_impl(k, std::forward<Args>(args)...);
+      }
+
+      template <class... Args>
+      std::pair<iterator, bool> try_emplace(key_type&& k, Args&&... args)
+      {
+        return this->try_emplace_impl(
+          std::move(k), std::forward<Args>(args)...);
+      }
+
+      std::pair<iterator, bool> insert(value_type const& x)
+      {
+        return this->try_emplace_impl(x.first, x.second);
+      }
+
+      std::pair<iterator, bool> insert(value_type&& x)
+      {
+        return this->try_emplace_impl(x.first, std::move(x.second));
+      }
+
+      template <class InputIt> void insert(InputIt first, InputIt last)
+      {
+        for (; first != last; ++first) {
+          this->emplace(*first);
+        }
+      }
+
+#if !defined(BOOST_NO_CXX11_HDR_INITIALIZER_LIST)
+      void insert(std::initializer_list<value_type> list)
+      {
+        this->insert(list.begin(), list.end());
+      }
+#endif
+
+      template <class M>
+      std::pair<iterator, bool> insert_or_assign(key_type const& k, M&& obj)
+      {
+        return this->insert_or_assign_impl(k, std::forward<M>(obj));
+      }
+
+      template <class M>
+      std::pair<iterator, bool> insert_or_assign(key_type&& k, M&& obj)
+      {
+        return this->insert_or_assign_impl(std::move(k), std::forward<M>(obj));
+      }
+
+      // As the nodes can be rearranged, the next element is found again,
+      // from its key.
+      iterator erase(const_iterator position)
+      {
+        leaf const* l = table::get_leaf(position);
+        const_iterator next = position;
+        ++next;
+        table_.erase(l->hash_, table::key(l));
+        if (next == this->end()) {
+          return next;
+        }
+        l = table::get_leaf(next);
+        return table_.find_iterator(l->hash_, table::key(l));
+      }
+
+      iterator erase(const_iterator first, const_iterator last)
+      {
+        while (first != last) {
+          first = this->erase(first);
+        }
+        return first;
+      }
+
+      size_type erase(key_type const& k)
+      {
+        boost::uint64_t const h = table_.hash(k);
+        if (!table_.find(h, k)) {
+          return 0;
+        }
+        table_.erase(h, k);
+        return 1;
+      }
+
+      void clear() BOOST_NOEXCEPT { table_.clear(); }
+
+      void swap(persistent_unordered_map& x) { table_.swap(x.table_); }
+
+      // observers
+
+      hasher hash_function() const { return table_.hf_; }
+
+      key_equal key_eq() const { return table_.eq_; }
+
+      // lookup
+
+      const_iterator find(key_type const& k) const
+      {
+        return table_.find_iterator(table_.hash(k), k);
+      }
+
+      bool contains(key_type const& k) const
+      {
+        return table_.find(table_.hash(k), k) != 0;
+      }
+
+      size_type count(key_type const& k) const
+      {
+        return this->contains(k) ? 1 : 0;
+      }
+
+      std::pair<const_iterator, const_iterator> equal_range(
+        key_type const& k) const
+      {
+        const_iterator it = this->find(k);
+        const_iterator next = it;
+        if (next != this->end()) {
+          ++next;
+        }
+        return std::make_pair(it, next);
+      }
+
+      // The references returned by the non-const members are invalidated by
+      // copying the map, as well as by erasing the element.
+
+      mapped_type& operator[](key_type const& k)
+      {
+        return this->mapped(this->try_emplace_impl(k).first);
+      }
+
+      mapped_type& operator[](key_type&& k)
+      {
+        return this->mapped(this->try_emplace_impl(std::move(k)).first);
+      }
+
+      mapped_type& at(key_type const& k)
+      {
+        const_iterator it = this->find(k);
+        if (it == this->end()) {
+          boost::throw_exception(std::out_of_range(
+            "Unable to find key in persistent_unordered_map."));
+        }
+        return this->mapped(it);
+      }
+
+      mapped_type const& at(key_type const& k) const
+      {
+        leaf const* l = table_.find(table_.hash(k), k);
+        if (!l) {
+          boost::throw_exception(std::out_of_range(
+            "Unable to find key in persistent_unordered_map."));
+        }
+        return l->value().second;
+      }
+
+    private:
+      // Copies the element first if it's shared, so that it can be changed.
+      mapped_type& mapped(const_iterator it)
+      {
+        leaf const* l = table::get_leaf(it);
+        return table_.unshare_leaf(l->hash_, table::key(l))->value().second;
+      }
+
+      template <class Key, class... Args>
+      std::pair<iterator, bool> try_emplace_impl(Key&& k, Args&&... args)
+      {
+        boost::uint64_t const h = table_.hash(k);
+        if (table_.find(h, k)) {
+          return std::make_pair(table_.find_iterator(h, k), false);
+        }
+        leaf* l = table_.create_leaf(std::piecewise_construct,
+          std::forward_as_tuple(std::forward<Key>(k)),
+          std::forward_as_tuple(std::forward<Args>(args)...));
+        l->hash_ = h;
+        BOOST_TRY { table_.insert(l); }
+        BOOST_CATCH(...)
+        {
+          table_.destroy_leaf(l);
+          BOOST_RETHROW
+        }
+        BOOST_CATCH_END
+        return std::make_pair(table_.find_iterator(h, table::key(l)), true);
+      }
+
+      template <class Key, class M>
+      std::pair<iterator, bool> insert_or_assign_impl(Key&& k, M&& obj)
+      {
+        const_iterator it = this->find(k);
+        if (it != this->end()) {
+          this->mapped(it) = std::forward<M>(obj);
+          return std::make_pair(this->find(k), false);
+        }
+        return this->try_emplace_impl(
+          std::forward<Key>(k), std::forward<M>(obj));
+      }
+    };
+
+    template <class K, class T, class H, class P, class A>
+    inline bool operator==(persistent_unordered_map<K, T, H, P, A> const& x,
+      persistent_unordered_map<K, T, H, P, A> const& y)
+    {
+      if (x.size() != y.size()) {
+        return false;
+      }
+      for (typename persistent_unordered_map<K, T, H, P,
+             A>::const_iterator it = x.begin();
+           it != x.end(); ++it) {
+        typename persistent_unordered_map<K, T, H, P, A>::const_iterator pos =
+          y.find(it->first);
+        if (pos == y.end() || !(pos->second == it->second)) {
+          return false;
+        }
+      }
+      return true;
+    }
+
+    template <class K, class T, class H, class P, class A>
+    inline bool operator!=(persistent_unordered_map<K, T, H, P, A> const& x,
+      persistent_unordered_map<K, T, H, P, A> const& y)
+    {
+      return !(x == y);
+    }
+
+    template <class K, class T, class H, class P, class A>
+    inline void swap(persistent_unordered_map<K, T, H, P, A>& x,
+      persistent_unordered_map<K, T, H, P, A>& y)
+    {
+      x.swap(y);
+    }
+  }
+
+  using boost::unordered::persistent_unordered_map;
+}
+
+#endif
+
+#endif
@@ -0,0 +1,199 @@
+
+// Copyright 2022 Christian Mazakas.
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_UNORDERED_STRING_HASH_HPP_INCLUDED
+#define BOOST_UNORDERED_STRING_HASH_HPP_INCLUDED
+
+#include <boost/config.hpp>
+#if defined(BOOST_HAS_PRAGMA_ONCE)
+#pragma once
+#endif
+
+#include <boost/cstdint.hpp>
+#include <cstddef>
+#include <cstring>
+#include <string>
+
+#if !defined(BOOST_NO_CXX17_HDR_STRING_VIEW)
+#include <string_view>
+#endif
+
+#if defined(BOOST_MSVC) && defined(_M_X64) && !defined(BOOST_HAS_INT128)
+#include <intrin.h>
+#pragma intrinsic(_umul128)
+#endif
+
+namespace boost {
+  namespace unordered {
+    namespace detail {
+      namespace string_hash_impl {
+
+        // Based on wyhash (final version 4) by Wang Yi, which is released
+        // into the public domain: https://github.com/wangyi-fudan/wyhash
+        //
+        // The input is read 8 bytes at a time in native byte order, so hash
+        // values differ between little and big endian platforms.
+
+        static const boost::uint64_t secret0 =
+          (boost::uint64_t(0xa0761d64u) << 32) + 0x78bd642fu;
+        static const boost::uint64_t secret1 =
+          (boost::uint64_t(0xe7037ed1u) << 32) + 0xa0b428dbu;
+        static const boost::uint64_t secret2 =
+          (boost::uint64_t(0x8ebc6af0u) << 32) + 0x9c88c6e3u;
+        static const boost::uint64_t secret3 =
+          (boost::uint64_t(0x589965ccu) << 32) + 0x75374cc3u;
+
+        // 64x64 -> 128 bit multiplication, returns the low half in 'a' and
+        // the high half in 'b'.
+        inline void mum(boost::uint64_t& a, boost::uint64_t& b)
+        {
+#if defined(BOOST_HAS_INT128)
+          boost::uint128_type r = a;
+          r *= b;
+          a = static_cast<boost::uint64_t>(r);
+          b = static_cast<boost::uint64_t>(r >> 64);
+#elif defined(BOOST_MSVC) && defined(_M_X64)
+          a = _umul128(a, b, &b);
+#else
+          boost::uint64_t ha = a >> 32, hb = b >> 32;
+          boost::uint64_t la = a & 0xffffffffu, lb = b & 0xffffffffu;
+          boost::uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la,
+                          rl = la * lb;
+          boost::uint64_t t = rl + (rm0 << 32);
+          boost::uint64_t c = t < rl;
+          boost::uint64_t lo = t + (rm1 << 32);
+          c += lo < t;
+          boost::uint64_t hi = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+          a = lo;
+          b = hi;
+#endif
+        }
+
+        inline boost::uint64_t mix(boost::uint64_t a, boost::uint64_t b)
+        {
+          mum(a, b);
+          return a ^ b;
+        }
+
+        inline boost::uint64_t read8(unsigned char const* p)
+        {
+          boost::uint64_t v;
+          std::memcpy(&v, p, 8);
+          return v;
+        }
+
+        inline boost::uint64_t read4(unsigned char const* p)
+        {
+          boost::uint32_t v;
+          std::memcpy(&v, p, 4);
+          return v;
+        }
+
+        inline boost::uint64_t read_small(unsigned char const* p, std::size_t k)
+        {
+          return (static_cast<boost::uint64_t>(p[0]) << 16) |
+                 (static_cast<boost::uint64_t>(p[k >> 1]) << 8) | p[k - 1];
+        }
+
+        inline boost::uint64_t hash_bytes(
+          void const* data, std::size_t len, boost::uint64_t seed)
+        {
+          unsigned char const* p = static_cast<unsigned char const*>(data);
+          seed ^= mix(seed ^ secret0, secret1);
+
+          boost::uint64_t a, b;
+          if (len <= 16) {
+            if (len >= 4) {
+              std::size_t const offset = (len >> 3) << 2;
+              a = (read4(p) << 32) | read4(p + offset);
+              b = (read4(p + len - 4) << 32) | read4(p + len - 4 - offset);
+            } else if (len > 0) {
+              a = read_small(p, len);
+              b = 0;
+            } else {
+              a = b = 0;
+            }
+          } else {
+            std::size_t i = len;
+            if (i > 48) {
+              // Three independent lanes, so that the multiplications can
+              // be executed in parallel.
+              boost::uint64_t see1 = seed, see2 = seed;
+              do {
+                seed = mix(read8(p) ^ secret1, read8(p + 8) ^ seed);
+                see1 = mix(read8(p + 16) ^ secret2, read8(p + 24) ^ see1);
+                see2 = mix(read8(p + 32) ^ secret3, read8(p + 40) ^ see2);
+                p += 48;
+                i -= 48;
+              } while (i > 48);
+              seed ^= see1 ^ see2;
+            }
+            while (i > 16) {
+              seed = mix(read8(p) ^ secret1, read8(p + 8) ^ seed);
+              i -= 16;
+              p += 16;
+            }
+            a = read8(p + i - 16);
+            b = read8(p + i - 8);
+          }
+
+          a ^= secret1;
+          b ^= seed;
+          mum(a, b);
+          return mix(a ^ secret0 ^ len, b ^ secret1);
+        }
+      }
+    }
+
+    // A fast, high quality hash function for strings of char. It processes
+    // its input a word at a time, and its results are avalanching, so the
+    // containers use them without any further mixing.
+    //
+    // It's transparent, so with a transparent key equality predicate
+    // strings can be looked up by string_view or C string without creating
+    // a temporary std::string.
+
+    struct string_hash
+    {
+      typedef void is_transparent;
+      typedef void is_avalanching;
+
+      string_hash() : seed_(0) {}
+      explicit string_hash(boost::uint64_t seed) : seed_(seed) {}
+
+      template <class Traits, class Alloc>
+      std::size_t operator()(
+        std::basic_string<char, Traits, Alloc> const& s) const
+      {
+        return hash(s.data(), s.size());
+      }
+
+#if !defined(BOOST_NO_CXX17_HDR_STRING_VIEW)
+      template <class Traits>
+      std::size_t operator()(std::basic_string_view<char, Traits> s) const
+      {
+        return hash(s.data(), s.size());
+      }
+#endif
+
+      std::size_t operator()(char const* s) const
+      {
+        return hash(s, std::strlen(s));
+      }
+
+      std::size_t hash(char const* data, std::size_t len) const
+      {
+        return static_cast<std::size_t>(
+          boost::unordered::detail::string_hash_impl::hash_bytes(
+            data, len, seed_));
+      }
+
+    private:
+      boost::uint64_t seed_;
+    };
+  }
+}
+
+#endif
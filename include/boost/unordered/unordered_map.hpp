@@ -75,6 +75,7 @@ namespace boost {
       typedef typename table::l_iterator local_iterator;
       typedef typename table::cl_iterator const_local_iterator;
       typedef typename types::node_type node_type;
+      typedef typename table::released_storage_type storage_type;
       typedef typename types::insert_return_type insert_return_type;
 
     private:
@@ -419,6 +420,11 @@ namespace boost {
       void insert(std::initializer_list<value_type>);
 #endif
 
+#if BOOST_UNORDERED_PARALLEL
+      template <class InputIt>
+      void parallel_insert(InputIt, InputIt, std::size_t num_threads = 0);
+#endif
+
       // extract
 
       node_type extract(const_iterator position)
@@ -497,6 +503,26 @@ namespace boost {
           hint, boost::move(k), boost::forward<Args>(args)...);
       }
 
+      template <class Key, class... Args>
+      typename boost::enable_if_c<
+        detail::transparent_non_iterable<Key, unordered_map>::value,
+        std::pair<iterator, bool> >::type
+      try_emplace(BOOST_FWD_REF(Key) k, BOOST_FWD_REF(Args)... args)
+      {
+        return table_.try_emplace_unique_impl(
+          boost::forward<Key>(k), boost::forward<Args>(args)...);
+      }
+
+      template <class Key, class... Args>
+      typename boost::enable_if_c<detail::are_transparent<Key, H, P>::value,
+        iterator>::type
+      try_emplace(
+        const_iterator hint, BOOST_FWD_REF(Key) k, BOOST_FWD_REF(Args)... args)
+      {
+        return table_.try_emplace_hint_unique_impl(
+          hint, boost::forward<Key>(k), boost::forward<Args>(args)...);
+      }
+
 #else
 
       // In order to make this a template, this handles both:
@@ -717,6 +743,43 @@ namespace boost {
           .first;
       }
 
+#if !defined(BOOST_NO_CXX11_VARIADIC_TEMPLATES)
+      template <class Key, class M>
+      typename boost::enable_if_c<
+        detail::transparent_non_iterable<Key, unordered_map>::value,
+        std::pair<iterator, bool> >::type
+      insert_or_assign(BOOST_FWD_REF(Key) k, BOOST_FWD_REF(M) obj)
+      {
+        return table_.insert_or_assign_unique_impl(
+          boost::forward<Key>(k), boost::forward<M>(obj));
+      }
+
+      template <class Key, class M>
+      typename boost::enable_if_c<detail::are_transparent<Key, H, P>::value,
+        iterator>::type
+      insert_or_assign(
+        const_iterator, BOOST_FWD_REF(Key) k, BOOST_FWD_REF(M) obj)
+      {
+        return table_
+          .insert_or_assign_unique_impl(
+            boost::forward<Key>(k), boost::forward<M>(obj))
+          .first;
+      }
+#endif
+
+      template <class InputIt>
+      size_type batch_insert_or_assign(InputIt first, InputIt last)
+      {
+        return table_.insert_or_update_range_unique(
+          first, last, detail::assign_mapped());
+      }
+
+      template <class InputIt, class F>
+      size_type batch_insert_or_update(InputIt first, InputIt last, F f)
+      {
+        return table_.insert_or_update_range_unique(first, last, f);
+      }
+
       iterator erase(iterator);
       iterator erase(const_iterator);
       size_type erase(const key_type&);
@@ -743,6 +806,11 @@ namespace boost {
               boost::is_nothrow_swappable<P>::value);
       void clear() BOOST_NOEXCEPT { table_.clear_impl(); }
 
+      storage_type release_storage() BOOST_NOEXCEPT
+      {
+        return table_.release_storage();
+      }
+
       template <typename H2, typename P2>
       void merge(boost::unordered_map<K, T, H2, P2, A>& source);
 
@@ -759,6 +827,23 @@ namespace boost {
       void merge(boost::unordered_multimap<K, T, H2, P2, A>&& source);
 #endif
 
+      // set algebra
+
+      bool is_subset_of(unordered_map const& other) const
+      {
+        return table_.is_subset_unique(other.table_);
+      }
+
+      size_type intersect(unordered_map const& other)
+      {
+        return table_.intersect_unique(other.table_);
+      }
+
+      size_type subtract(unordered_map const& other)
+      {
+        return table_.subtract_unique(other.table_);
+      }
+
       // observers
 
       hasher hash_function() const;
@@ -775,7 +860,7 @@ namespace boost {
       find(const Key& key)
       {
         return iterator(table_.find_node_impl(
-          table::policy::apply_hash(this->hash_function(), key), key,
+          table_.apply_hash(this->hash_function(), key), key,
           this->key_eq()));
       }
 
@@ -785,7 +870,7 @@ namespace boost {
       find(const Key& key) const
       {
         return const_iterator(table_.find_node_impl(
-          table::policy::apply_hash(this->hash_function(), key), key,
+          table_.apply_hash(this->hash_function(), key), key,
           this->key_eq()));
       }
 
@@ -802,7 +887,7 @@ namespace boost {
       bool contains(const key_type& k) const
       {
         return 0 != table_.find_node_impl(
-                      table::policy::apply_hash(this->hash_function(), k), k,
+                      table_.apply_hash(this->hash_function(), k), k,
                       this->key_eq());
       }
 
@@ -812,7 +897,7 @@ namespace boost {
       contains(const Key& k) const
       {
         return 0 != table_.find_node_impl(
-                      table::policy::apply_hash(this->hash_function(), k), k,
+                      table_.apply_hash(this->hash_function(), k), k,
                       this->key_eq());
       }
 
@@ -824,7 +909,7 @@ namespace boost {
       count(const Key& k) const
       {
         std::size_t const key_hash =
-          table::policy::apply_hash(this->hash_function(), k);
+          table_.apply_hash(this->hash_function(), k);
 
         P const& eq = this->key_eq();
 
@@ -843,7 +928,7 @@ namespace boost {
       equal_range(const Key& key)
       {
         node_pointer p = table_.find_node_impl(
-          table::policy::apply_hash(this->hash_function(), key), key,
+          table_.apply_hash(this->hash_function(), key), key,
           this->key_eq());
 
         return std::make_pair(
@@ -856,7 +941,7 @@ namespace boost {
       equal_range(const Key& key) const
       {
         node_pointer p = table_.find_node_impl(
-          table::policy::apply_hash(this->hash_function(), key), key,
+          table_.apply_hash(this->hash_function(), key), key,
           this->key_eq());
 
         return std::make_pair(
@@ -865,6 +950,19 @@ namespace boost {
 
       mapped_type& operator[](const key_type&);
       mapped_type& operator[](BOOST_RV_REF(key_type));
+
+#if !defined(BOOST_NO_CXX11_VARIADIC_TEMPLATES)
+      template <class Key>
+      typename boost::enable_if_c<
+        detail::transparent_non_iterable<Key, unordered_map>::value,
+        mapped_type&>::type
+      operator[](BOOST_FWD_REF(Key) k)
+      {
+        return table_.try_emplace_unique_impl(boost::forward<Key>(k))
+          .first->second;
+      }
+#endif
+
       mapped_type& at(const key_type&);
       mapped_type const& at(const key_type&) const;
 
@@ -921,12 +1019,74 @@ namespace boost {
       void max_load_factor(float) BOOST_NOEXCEPT;
       void rehash(size_type);
       void reserve(size_type);
+      void reserve_nodes(size_type);
+      void compact();
+
+#if BOOST_UNORDERED_PARALLEL
+      // parallel algorithms
+
+      template <class F>
+      void parallel_for_each(F f, std::size_t num_threads = 0)
+      {
+        table_.parallel_for_each(f, num_threads);
+      }
+
+      template <class F>
+      void parallel_for_each(F f, std::size_t num_threads = 0) const
+      {
+        auto visit = [&f](value_type const& v) { f(v); };
+        table_.parallel_for_each(visit, num_threads);
+      }
+
+      template <class Predicate>
+      size_type parallel_count_if(
+        Predicate pred, std::size_t num_threads = 0) const
+      {
+        return table_.parallel_count_if(pred, num_threads);
+      }
+
+      template <class Predicate>
+      size_type parallel_erase_if(Predicate pred, std::size_t num_threads = 0)
+      {
+        return table_.parallel_erase_if(pred, num_threads);
+      }
+
+      bool parallel_equal(
+        unordered_map const& other, std::size_t num_threads = 0) const
+      {
+        return table_.parallel_equals(other.table_, num_threads);
+      }
+
+      bool parallel_is_subset_of(
+        unordered_map const& other, std::size_t num_threads = 0) const
+      {
+        return table_.parallel_is_subset_unique(other.table_, num_threads);
+      }
+
+      size_type parallel_intersect(
+        unordered_map const& other, std::size_t num_threads = 0)
+      {
+        return table_.parallel_intersect_unique(other.table_, num_threads);
+      }
+
+      size_type parallel_subtract(
+        unordered_map const& other, std::size_t num_threads = 0)
+      {
+        return table_.parallel_subtract_unique(other.table_, num_threads);
+      }
+#endif
 
 #if !BOOST_WORKAROUND(BOOST_BORLANDC, < 0x0582)
       friend bool operator==
         <K, T, H, P, A>(unordered_map const&, unordered_map const&);
       friend bool operator!=
         <K, T, H, P, A>(unordered_map const&, unordered_map const&);
+      friend unordered_map set_union<K, T, H, P, A>(
+        unordered_map const&, unordered_map const&);
+      friend unordered_map set_intersection<K, T, H, P, A>(
+        unordered_map const&, unordered_map const&);
+      friend unordered_map set_difference<K, T, H, P, A>(
+        unordered_map const&, unordered_map const&);
 #endif
     }; // class template unordered_map
 
@@ -1044,6 +1204,7 @@ namespace boost {
       typedef typename table::l_iterator local_iterator;
       typedef typename table::cl_iterator const_local_iterator;
       typedef typename types::node_type node_type;
+      typedef typename table::released_storage_type storage_type;
 
     private:
       table table_;
@@ -1197,7 +1358,7 @@ namespace boost {
       {
         return iterator(table_.emplace_equiv(
           boost::unordered::detail::func::construct_node_from_args(
-            table_.node_alloc(), boost::forward<Args>(args)...)));
+            table_.node_source(), boost::forward<Args>(args)...)));
       }
 
 #else
@@ -1221,7 +1382,7 @@ namespace boost {
       {
         return iterator(table_.emplace_equiv(
           boost::unordered::detail::func::construct_node_from_args(
-            table_.node_alloc(), boost::unordered::detail::create_emplace_args(
+            table_.node_source(), boost::unordered::detail::create_emplace_args(
                                    boost::forward<A0>(a0)))));
       }
 
@@ -1230,7 +1391,7 @@ namespace boost {
       {
         return iterator(table_.emplace_equiv(
           boost::unordered::detail::func::construct_node_from_args(
-            table_.node_alloc(),
+            table_.node_source(),
             boost::unordered::detail::create_emplace_args(
               boost::forward<A0>(a0), boost::forward<A1>(a1)))));
       }
@@ -1241,7 +1402,7 @@ namespace boost {
       {
         return iterator(table_.emplace_equiv(
           boost::unordered::detail::func::construct_node_from_args(
-            table_.node_alloc(),
+            table_.node_source(),
             boost::unordered::detail::create_emplace_args(
               boost::forward<A0>(a0), boost::forward<A1>(a1),
               boost::forward<A2>(a2)))));
@@ -1256,7 +1417,7 @@ namespace boost {
       {
         return iterator(table_.emplace_hint_equiv(
           hint, boost::unordered::detail::func::construct_node_from_args(
-                  table_.node_alloc(), boost::forward<Args>(args)...)));
+                  table_.node_source(), boost::forward<Args>(args)...)));
       }
 
 #else
@@ -1278,7 +1439,7 @@ namespace boost {
       {
         return iterator(table_.emplace_hint_equiv(hint,
           boost::unordered::detail::func::construct_node_from_args(
-            table_.node_alloc(), boost::unordered::detail::create_emplace_args(
+            table_.node_source(), boost::unordered::detail::create_emplace_args(
                                    boost::forward<A0>(a0)))));
       }
 
@@ -1288,7 +1449,7 @@ namespace boost {
       {
         return iterator(table_.emplace_hint_equiv(
           hint, boost::unordered::detail::func::construct_node_from_args(
-                  table_.node_alloc(),
+                  table_.node_source(),
                   boost::unordered::detail::create_emplace_args(
                     boost::forward<A0>(a0), boost::forward<A1>(a1)))));
       }
@@ -1299,7 +1460,7 @@ namespace boost {
       {
         return iterator(table_.emplace_hint_equiv(
           hint, boost::unordered::detail::func::construct_node_from_args(
-                  table_.node_alloc(),
+                  table_.node_source(),
                   boost::unordered::detail::create_emplace_args(
                     boost::forward<A0>(a0), boost::forward<A1>(a1),
                     boost::forward<A2>(a2)))));
@@ -1315,7 +1476,7 @@ namespace boost {
   {                                                                            \
     return iterator(table_.emplace_equiv(                                      \
       boost::unordered::detail::func::construct_node_from_args(                \
-        table_.node_alloc(),                                                   \
+        table_.node_source(),                                                  \
         boost::unordered::detail::create_emplace_args(                         \
           BOOST_PP_ENUM_##z(n, BOOST_UNORDERED_CALL_FORWARD, a)))));           \
   }                                                                            \
@@ -1326,7 +1487,7 @@ namespace boost {
   {                                                                            \
     return iterator(table_.emplace_hint_equiv(                                 \
       hint, boost::unordered::detail::func::construct_node_from_args(          \
-              table_.node_alloc(),                                             \
+              table_.node_source(),                                            \
               boost::unordered::detail::create_emplace_args(                   \
                 BOOST_PP_ENUM_##z(n, BOOST_UNORDERED_CALL_FORWARD, a)))));     \
   }
@@ -1452,6 +1613,11 @@ namespace boost {
               boost::is_nothrow_swappable<P>::value);
       void clear() BOOST_NOEXCEPT { table_.clear_impl(); }
 
+      storage_type release_storage() BOOST_NOEXCEPT
+      {
+        return table_.release_storage();
+      }
+
       template <typename H2, typename P2>
       void merge(boost::unordered_multimap<K, T, H2, P2, A>& source);
 
@@ -1484,7 +1650,7 @@ namespace boost {
       find(const Key& key)
       {
         return iterator(table_.find_node_impl(
-          table::policy::apply_hash(this->hash_function(), key), key,
+          table_.apply_hash(this->hash_function(), key), key,
           this->key_eq()));
       }
 
@@ -1494,7 +1660,7 @@ namespace boost {
       find(const Key& key) const
       {
         return const_iterator(table_.find_node_impl(
-          table::policy::apply_hash(this->hash_function(), key), key,
+          table_.apply_hash(this->hash_function(), key), key,
           this->key_eq()));
       }
 
@@ -1511,7 +1677,7 @@ namespace boost {
       bool contains(key_type const& k) const
       {
         return 0 != table_.find_node_impl(
-                      table::policy::apply_hash(this->hash_function(), k), k,
+                      table_.apply_hash(this->hash_function(), k), k,
                       this->key_eq());
       }
 
@@ -1521,7 +1687,7 @@ namespace boost {
       contains(const Key& k) const
       {
         return 0 != table_.find_node_impl(
-                      table::policy::apply_hash(this->hash_function(), k), k,
+                      table_.apply_hash(this->hash_function(), k), k,
                       this->key_eq());
       }
 
@@ -1533,7 +1699,7 @@ namespace boost {
       count(const Key& k) const
       {
         node_pointer n = table_.find_node_impl(
-          table::policy::apply_hash(this->hash_function(), k), k,
+          table_.apply_hash(this->hash_function(), k), k,
           this->key_eq());
 
         return n ? table_.group_count(n) : 0;
@@ -1549,7 +1715,7 @@ namespace boost {
       equal_range(const Key& key)
       {
         node_pointer p = table_.find_node_impl(
-          table::policy::apply_hash(this->hash_function(), key), key,
+          table_.apply_hash(this->hash_function(), key), key,
           this->key_eq());
 
         return std::make_pair(
@@ -1562,7 +1728,7 @@ namespace boost {
       equal_range(const Key& key) const
       {
         node_pointer p = table_.find_node_impl(
-          table::policy::apply_hash(this->hash_function(), key), key,
+          table_.apply_hash(this->hash_function(), key), key,
           this->key_eq());
 
         return std::make_pair(
@@ -1622,6 +1788,44 @@ namespace boost {
       void max_load_factor(float) BOOST_NOEXCEPT;
       void rehash(size_type);
       void reserve(size_type);
+      void reserve_nodes(size_type);
+      void compact();
+
+#if BOOST_UNORDERED_PARALLEL
+      // parallel algorithms
+
+      template <class F>
+      void parallel_for_each(F f, std::size_t num_threads = 0)
+      {
+        table_.parallel_for_each(f, num_threads);
+      }
+
+      template <class F>
+      void parallel_for_each(F f, std::size_t num_threads = 0) const
+      {
+        auto visit = [&f](value_type const& v) { f(v); };
+        table_.parallel_for_each(visit, num_threads);
+      }
+
+      template <class Predicate>
+      size_type parallel_count_if(
+        Predicate pred, std::size_t num_threads = 0) const
+      {
+        return table_.parallel_count_if(pred, num_threads);
+      }
+
+      template <class Predicate>
+      size_type parallel_erase_if(Predicate pred, std::size_t num_threads = 0)
+      {
+        return table_.parallel_erase_if(pred, num_threads);
+      }
+
+      bool parallel_equal(
+        unordered_multimap const& other, std::size_t num_threads = 0) const
+      {
+        return table_.parallel_equals(other.table_, num_threads);
+      }
+#endif
 
 #if !BOOST_WORKAROUND(BOOST_BORLANDC, < 0x0582)
       friend bool operator==
@@ -1890,6 +2094,19 @@ namespace boost {
     }
 #endif
 
+#if BOOST_UNORDERED_PARALLEL
+    template <class K, class T, class H, class P, class A>
+    template <class InputIt>
+    void unordered_map<K, T, H, P, A>::parallel_insert(
+      InputIt first, InputIt last, std::size_t num_threads)
+    {
+      if (first != last) {
+        table_.insert_range_unique_parallel(
+          table::extractor::extract(*first), first, last, num_threads);
+      }
+    }
+#endif
+
     template <class K, class T, class H, class P, class A>
     typename unordered_map<K, T, H, P, A>::iterator
     unordered_map<K, T, H, P, A>::erase(iterator position)
@@ -2016,7 +2233,7 @@ namespace boost {
       CompatibleHash const& hash, CompatiblePredicate const& eq)
     {
       return iterator(
-        table_.find_node_impl(table::policy::apply_hash(hash, k), k, eq));
+        table_.find_node_impl(table_.apply_hash(hash, k), k, eq));
     }
 
     template <class K, class T, class H, class P, class A>
@@ -2027,7 +2244,7 @@ namespace boost {
       CompatibleHash const& hash, CompatiblePredicate const& eq) const
     {
       return const_iterator(
-        table_.find_node_impl(table::policy::apply_hash(hash, k), k, eq));
+        table_.find_node_impl(table_.apply_hash(hash, k), k, eq));
     }
 
     template <class K, class T, class H, class P, class A>
@@ -2134,6 +2351,19 @@ namespace boost {
         std::ceil(static_cast<double>(n) / table_.mlf_)));
     }
 
+    template <class K, class T, class H, class P, class A>
+    void unordered_map<K, T, H, P, A>::reserve_nodes(size_type n)
+    {
+      this->reserve(n);
+      table_.reserve_nodes(n);
+    }
+
+    template <class K, class T, class H, class P, class A>
+    void unordered_map<K, T, H, P, A>::compact()
+    {
+      table_.compact();
+    }
+
     template <class K, class T, class H, class P, class A>
     inline bool operator==(unordered_map<K, T, H, P, A> const& m1,
       unordered_map<K, T, H, P, A> const& m2)
@@ -2181,6 +2411,48 @@ namespace boost {
       return detail::erase_if(c, pred);
     }
 
+    // The elements of x, and those of y whose keys aren't in x.
+
+    template <class K, class T, class H, class P, class A>
+    unordered_map<K, T, H, P, A> set_union(
+      unordered_map<K, T, H, P, A> const& x,
+      unordered_map<K, T, H, P, A> const& y)
+    {
+      unordered_map<K, T, H, P, A> r(
+        x.bucket_count(), x.hash_function(), x.key_eq(), x.get_allocator());
+      r.max_load_factor(x.max_load_factor());
+      r.table_.copy_union_unique(x.table_, y.table_);
+      return r;
+    }
+
+    // The elements of x whose keys are in y.
+
+    template <class K, class T, class H, class P, class A>
+    unordered_map<K, T, H, P, A> set_intersection(
+      unordered_map<K, T, H, P, A> const& x,
+      unordered_map<K, T, H, P, A> const& y)
+    {
+      unordered_map<K, T, H, P, A> r(
+        x.bucket_count(), x.hash_function(), x.key_eq(), x.get_allocator());
+      r.max_load_factor(x.max_load_factor());
+      r.table_.copy_intersection_unique(x.table_, y.table_);
+      return r;
+    }
+
+    // The elements of x whose keys aren't in y.
+
+    template <class K, class T, class H, class P, class A>
+    unordered_map<K, T, H, P, A> set_difference(
+      unordered_map<K, T, H, P, A> const& x,
+      unordered_map<K, T, H, P, A> const& y)
+    {
+      unordered_map<K, T, H, P, A> r(
+        x.bucket_count(), x.hash_function(), x.key_eq(), x.get_allocator());
+      r.max_load_factor(x.max_load_factor());
+      r.table_.copy_difference_unique(x.table_, y.table_);
+      return r;
+    }
+
     ////////////////////////////////////////////////////////////////////////////
 
     template <class K, class T, class H, class P, class A>
@@ -2507,7 +2779,7 @@ namespace boost {
       CompatibleHash const& hash, CompatiblePredicate const& eq)
     {
       return iterator(
-        table_.find_node_impl(table::policy::apply_hash(hash, k), k, eq));
+        table_.find_node_impl(table_.apply_hash(hash, k), k, eq));
     }
 
     template <class K, class T, class H, class P, class A>
@@ -2518,7 +2790,7 @@ namespace boost {
       CompatibleHash const& hash, CompatiblePredicate const& eq) const
     {
       return const_iterator(
-        table_.find_node_impl(table::policy::apply_hash(hash, k), k, eq));
+        table_.find_node_impl(table_.apply_hash(hash, k), k, eq));
     }
 
     template <class K, class T, class H, class P, class A>
@@ -2586,6 +2858,19 @@ namespace boost {
         std::ceil(static_cast<double>(n) / table_.mlf_)));
     }
 
+    template <class K, class T, class H, class P, class A>
+    void unordered_multimap<K, T, H, P, A>::reserve_nodes(size_type n)
+    {
+      this->reserve(n);
+      table_.reserve_nodes(n);
+    }
+
+    template <class K, class T, class H, class P, class A>
+    void unordered_multimap<K, T, H, P, A>::compact()
+    {
+      table_.compact();
+    }
+
     template <class K, class T, class H, class P, class A>
     inline bool operator==(unordered_multimap<K, T, H, P, A> const& m1,
       unordered_multimap<K, T, H, P, A> const& m2)
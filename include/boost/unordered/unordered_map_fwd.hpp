@@ -38,6 +38,16 @@ namespace boost {
     typename unordered_map<K, T, H, P, A>::size_type erase_if(
       unordered_map<K, T, H, P, A>& c, Predicate pred);
 
+    template <class K, class T, class H, class P, class A>
+    unordered_map<K, T, H, P, A> set_union(
+      unordered_map<K, T, H, P, A> const&, unordered_map<K, T, H, P, A> const&);
+    template <class K, class T, class H, class P, class A>
+    unordered_map<K, T, H, P, A> set_intersection(
+      unordered_map<K, T, H, P, A> const&, unordered_map<K, T, H, P, A> const&);
+    template <class K, class T, class H, class P, class A>
+    unordered_map<K, T, H, P, A> set_difference(
+      unordered_map<K, T, H, P, A> const&, unordered_map<K, T, H, P, A> const&);
+
     template <class K, class T, class H = boost::hash<K>,
       class P = std::equal_to<K>,
       class A = std::allocator<std::pair<const K, T> > >
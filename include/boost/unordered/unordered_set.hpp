@@ -73,6 +73,7 @@ namespace boost {
       typedef typename table::l_iterator local_iterator;
       typedef typename table::cl_iterator const_local_iterator;
       typedef typename types::node_type node_type;
+      typedef typename table::released_storage_type storage_type;
       typedef typename types::insert_return_type insert_return_type;
 
     private:
@@ -395,12 +396,37 @@ namespace boost {
         return this->emplace_hint(hint, boost::move(x));
       }
 
+#if !defined(BOOST_NO_CXX11_VARIADIC_TEMPLATES)
+      template <class Key>
+      typename boost::enable_if_c<
+        detail::transparent_non_iterable<Key, unordered_set>::value,
+        std::pair<iterator, bool> >::type
+      insert(BOOST_FWD_REF(Key) k)
+      {
+        return table_.insert_unique_impl(boost::forward<Key>(k));
+      }
+
+      template <class Key>
+      typename boost::enable_if_c<
+        detail::transparent_non_iterable<Key, unordered_set>::value,
+        iterator>::type
+      insert(const_iterator hint, BOOST_FWD_REF(Key) k)
+      {
+        return table_.insert_hint_unique_impl(hint, boost::forward<Key>(k));
+      }
+#endif
+
       template <class InputIt> void insert(InputIt, InputIt);
 
 #if !defined(BOOST_NO_CXX11_HDR_INITIALIZER_LIST)
       void insert(std::initializer_list<value_type>);
 #endif
 
+#if BOOST_UNORDERED_PARALLEL
+      template <class InputIt>
+      void parallel_insert(InputIt, InputIt, std::size_t num_threads = 0);
+#endif
+
       // extract
 
       node_type extract(const_iterator position)
@@ -470,6 +496,11 @@ namespace boost {
               boost::is_nothrow_swappable<P>::value);
       void clear() BOOST_NOEXCEPT { table_.clear_impl(); }
 
+      storage_type release_storage() BOOST_NOEXCEPT
+      {
+        return table_.release_storage();
+      }
+
       template <typename H2, typename P2>
       void merge(boost::unordered_set<T, H2, P2, A>& source);
 
@@ -486,6 +517,23 @@ namespace boost {
       void merge(boost::unordered_multiset<T, H2, P2, A>&& source);
 #endif
 
+      // set algebra
+
+      bool is_subset_of(unordered_set const& other) const
+      {
+        return table_.is_subset_unique(other.table_);
+      }
+
+      size_type intersect(unordered_set const& other)
+      {
+        return table_.intersect_unique(other.table_);
+      }
+
+      size_type subtract(unordered_set const& other)
+      {
+        return table_.subtract_unique(other.table_);
+      }
+
       // observers
 
       hasher hash_function() const;
@@ -501,7 +549,7 @@ namespace boost {
       find(const Key& k) const
       {
         return const_iterator(table_.find_node_impl(
-          table::policy::apply_hash(this->hash_function(), k), k,
+          table_.apply_hash(this->hash_function(), k), k,
           this->key_eq()));
       }
 
@@ -513,7 +561,7 @@ namespace boost {
       bool contains(key_type const& k) const
       {
         return 0 != table_.find_node_impl(
-                      table::policy::apply_hash(this->hash_function(), k), k,
+                      table_.apply_hash(this->hash_function(), k), k,
                       this->key_eq());
       }
 
@@ -523,7 +571,7 @@ namespace boost {
       contains(const Key& k) const
       {
         return 0 != table_.find_node_impl(
-                      table::policy::apply_hash(this->hash_function(), k), k,
+                      table_.apply_hash(this->hash_function(), k), k,
                       this->key_eq());
       }
 
@@ -535,7 +583,7 @@ namespace boost {
       count(const Key& k) const
       {
         node_pointer n = table_.find_node_impl(
-          table::policy::apply_hash(this->hash_function(), k), k,
+          table_.apply_hash(this->hash_function(), k), k,
           this->key_eq());
 
         return n ? 1 : 0;
@@ -550,7 +598,7 @@ namespace boost {
       equal_range(Key const& k) const
       {
         node_pointer n = table_.find_node_impl(
-          table::policy::apply_hash(this->hash_function(), k), k,
+          table_.apply_hash(this->hash_function(), k), k,
           this->key_eq());
 
         return std::make_pair(
@@ -610,12 +658,68 @@ namespace boost {
       void max_load_factor(float) BOOST_NOEXCEPT;
       void rehash(size_type);
       void reserve(size_type);
+      void reserve_nodes(size_type);
+      void compact();
+
+#if BOOST_UNORDERED_PARALLEL
+      // parallel algorithms
+
+      template <class F>
+      void parallel_for_each(F f, std::size_t num_threads = 0) const
+      {
+        auto visit = [&f](value_type const& v) { f(v); };
+        table_.parallel_for_each(visit, num_threads);
+      }
+
+      template <class Predicate>
+      size_type parallel_count_if(
+        Predicate pred, std::size_t num_threads = 0) const
+      {
+        return table_.parallel_count_if(pred, num_threads);
+      }
+
+      template <class Predicate>
+      size_type parallel_erase_if(Predicate pred, std::size_t num_threads = 0)
+      {
+        return table_.parallel_erase_if(pred, num_threads);
+      }
+
+      bool parallel_equal(
+        unordered_set const& other, std::size_t num_threads = 0) const
+      {
+        return table_.parallel_equals(other.table_, num_threads);
+      }
+
+      bool parallel_is_subset_of(
+        unordered_set const& other, std::size_t num_threads = 0) const
+      {
+        return table_.parallel_is_subset_unique(other.table_, num_threads);
+      }
+
+      size_type parallel_intersect(
+        unordered_set const& other, std::size_t num_threads = 0)
+      {
+        return table_.parallel_intersect_unique(other.table_, num_threads);
+      }
+
+      size_type parallel_subtract(
+        unordered_set const& other, std::size_t num_threads = 0)
+      {
+        return table_.parallel_subtract_unique(other.table_, num_threads);
+      }
+#endif
 
 #if !BOOST_WORKAROUND(BOOST_BORLANDC, < 0x0582)
       friend bool operator==
         <T, H, P, A>(unordered_set const&, unordered_set const&);
       friend bool operator!=
         <T, H, P, A>(unordered_set const&, unordered_set const&);
+      friend unordered_set set_union<T, H, P, A>(
+        unordered_set const&, unordered_set const&);
+      friend unordered_set set_intersection<T, H, P, A>(
+        unordered_set const&, unordered_set const&);
+      friend unordered_set set_difference<T, H, P, A>(
+        unordered_set const&, unordered_set const&);
 #endif
     }; // class template unordered_set
 
@@ -702,6 +806,7 @@ namespace boost {
       typedef typename table::l_iterator local_iterator;
       typedef typename table::cl_iterator const_local_iterator;
       typedef typename types::node_type node_type;
+      typedef typename table::released_storage_type storage_type;
 
     private:
       table table_;
@@ -855,7 +960,7 @@ namespace boost {
       {
         return iterator(table_.emplace_equiv(
           boost::unordered::detail::func::construct_node_from_args(
-            table_.node_alloc(), boost::forward<Args>(args)...)));
+            table_.node_source(), boost::forward<Args>(args)...)));
       }
 
 #else
@@ -879,7 +984,7 @@ namespace boost {
       {
         return iterator(table_.emplace_equiv(
           boost::unordered::detail::func::construct_node_from_args(
-            table_.node_alloc(), boost::unordered::detail::create_emplace_args(
+            table_.node_source(), boost::unordered::detail::create_emplace_args(
                                    boost::forward<A0>(a0)))));
       }
 
@@ -888,7 +993,7 @@ namespace boost {
       {
         return iterator(table_.emplace_equiv(
           boost::unordered::detail::func::construct_node_from_args(
-            table_.node_alloc(),
+            table_.node_source(),
             boost::unordered::detail::create_emplace_args(
               boost::forward<A0>(a0), boost::forward<A1>(a1)))));
       }
@@ -899,7 +1004,7 @@ namespace boost {
       {
         return iterator(table_.emplace_equiv(
           boost::unordered::detail::func::construct_node_from_args(
-            table_.node_alloc(),
+            table_.node_source(),
             boost::unordered::detail::create_emplace_args(
               boost::forward<A0>(a0), boost::forward<A1>(a1),
               boost::forward<A2>(a2)))));
@@ -914,7 +1019,7 @@ namespace boost {
       {
         return iterator(table_.emplace_hint_equiv(
           hint, boost::unordered::detail::func::construct_node_from_args(
-                  table_.node_alloc(), boost::forward<Args>(args)...)));
+                  table_.node_source(), boost::forward<Args>(args)...)));
       }
 
 #else
@@ -936,7 +1041,7 @@ namespace boost {
       {
         return iterator(table_.emplace_hint_equiv(hint,
           boost::unordered::detail::func::construct_node_from_args(
-            table_.node_alloc(), boost::unordered::detail::create_emplace_args(
+            table_.node_source(), boost::unordered::detail::create_emplace_args(
                                    boost::forward<A0>(a0)))));
       }
 
@@ -946,7 +1051,7 @@ namespace boost {
       {
         return iterator(table_.emplace_hint_equiv(
           hint, boost::unordered::detail::func::construct_node_from_args(
-                  table_.node_alloc(),
+                  table_.node_source(),
                   boost::unordered::detail::create_emplace_args(
                     boost::forward<A0>(a0), boost::forward<A1>(a1)))));
       }
@@ -957,7 +1062,7 @@ namespace boost {
       {
         return iterator(table_.emplace_hint_equiv(
           hint, boost::unordered::detail::func::construct_node_from_args(
-                  table_.node_alloc(),
+                  table_.node_source(),
                   boost::unordered::detail::create_emplace_args(
                     boost::forward<A0>(a0), boost::forward<A1>(a1),
                     boost::forward<A2>(a2)))));
@@ -973,7 +1078,7 @@ namespace boost {
   {                                                                            \
     return iterator(table_.emplace_equiv(                                      \
       boost::unordered::detail::func::construct_node_from_args(                \
-        table_.node_alloc(),                                                   \
+        table_.node_source(),                                                  \
         boost::unordered::detail::create_emplace_args(                         \
           BOOST_PP_ENUM_##z(n, BOOST_UNORDERED_CALL_FORWARD, a)))));           \
   }                                                                            \
@@ -984,7 +1089,7 @@ namespace boost {
   {                                                                            \
     return iterator(table_.emplace_hint_equiv(                                 \
       hint, boost::unordered::detail::func::construct_node_from_args(          \
-              table_.node_alloc(),                                             \
+              table_.node_source(),                                            \
               boost::unordered::detail::create_emplace_args(                   \
                 BOOST_PP_ENUM_##z(n, BOOST_UNORDERED_CALL_FORWARD, a)))));     \
   }
@@ -1091,6 +1196,11 @@ namespace boost {
               boost::is_nothrow_swappable<P>::value);
       void clear() BOOST_NOEXCEPT { table_.clear_impl(); }
 
+      storage_type release_storage() BOOST_NOEXCEPT
+      {
+        return table_.release_storage();
+      }
+
       template <typename H2, typename P2>
       void merge(boost::unordered_multiset<T, H2, P2, A>& source);
 
@@ -1122,7 +1232,7 @@ namespace boost {
       find(const Key& k) const
       {
         return const_iterator(table_.find_node_impl(
-          table::policy::apply_hash(this->hash_function(), k), k,
+          table_.apply_hash(this->hash_function(), k), k,
           this->key_eq()));
       }
 
@@ -1134,7 +1244,7 @@ namespace boost {
       bool contains(const key_type& k) const
       {
         return 0 != table_.find_node_impl(
-                      table::policy::apply_hash(this->hash_function(), k), k,
+                      table_.apply_hash(this->hash_function(), k), k,
                       this->key_eq());
       }
 
@@ -1144,7 +1254,7 @@ namespace boost {
       contains(const Key& k) const
       {
         return 0 != table_.find_node_impl(
-                      table::policy::apply_hash(this->hash_function(), k), k,
+                      table_.apply_hash(this->hash_function(), k), k,
                       this->key_eq());
       }
 
@@ -1156,7 +1266,7 @@ namespace boost {
       count(const Key& k) const
       {
         node_pointer n = table_.find_node_impl(
-          table::policy::apply_hash(this->hash_function(), k), k,
+          table_.apply_hash(this->hash_function(), k), k,
           this->key_eq());
 
         return n ? table_.group_count(n) : 0;
@@ -1171,7 +1281,7 @@ namespace boost {
       equal_range(const Key& k) const
       {
         node_pointer n = table_.find_node_impl(
-          table::policy::apply_hash(this->hash_function(), k), k,
+          table_.apply_hash(this->hash_function(), k), k,
           this->key_eq());
 
         return std::make_pair(
@@ -1231,6 +1341,38 @@ namespace boost {
       void max_load_factor(float) BOOST_NOEXCEPT;
       void rehash(size_type);
       void reserve(size_type);
+      void reserve_nodes(size_type);
+      void compact();
+
+#if BOOST_UNORDERED_PARALLEL
+      // parallel algorithms
+
+      template <class F>
+      void parallel_for_each(F f, std::size_t num_threads = 0) const
+      {
+        auto visit = [&f](value_type const& v) { f(v); };
+        table_.parallel_for_each(visit, num_threads);
+      }
+
+      template <class Predicate>
+      size_type parallel_count_if(
+        Predicate pred, std::size_t num_threads = 0) const
+      {
+        return table_.parallel_count_if(pred, num_threads);
+      }
+
+      template <class Predicate>
+      size_type parallel_erase_if(Predicate pred, std::size_t num_threads = 0)
+      {
+        return table_.parallel_erase_if(pred, num_threads);
+      }
+
+      bool parallel_equal(
+        unordered_multiset const& other, std::size_t num_threads = 0) const
+      {
+        return table_.parallel_equals(other.table_, num_threads);
+      }
+#endif
 
 #if !BOOST_WORKAROUND(BOOST_BORLANDC, < 0x0582)
       friend bool operator==
@@ -1479,6 +1621,19 @@ namespace boost {
     }
 #endif
 
+#if BOOST_UNORDERED_PARALLEL
+    template <class T, class H, class P, class A>
+    template <class InputIt>
+    void unordered_set<T, H, P, A>::parallel_insert(
+      InputIt first, InputIt last, std::size_t num_threads)
+    {
+      if (first != last) {
+        table_.insert_range_unique_parallel(
+          table::extractor::extract(*first), first, last, num_threads);
+      }
+    }
+#endif
+
     template <class T, class H, class P, class A>
     typename unordered_set<T, H, P, A>::iterator
     unordered_set<T, H, P, A>::erase(const_iterator position)
@@ -1586,7 +1741,7 @@ namespace boost {
       CompatibleHash const& hash, CompatiblePredicate const& eq) const
     {
       return const_iterator(
-        table_.find_node_impl(table::policy::apply_hash(hash, k), k, eq));
+        table_.find_node_impl(table_.apply_hash(hash, k), k, eq));
     }
 
     template <class T, class H, class P, class A>
@@ -1642,6 +1797,19 @@ namespace boost {
         std::ceil(static_cast<double>(n) / table_.mlf_)));
     }
 
+    template <class T, class H, class P, class A>
+    void unordered_set<T, H, P, A>::reserve_nodes(size_type n)
+    {
+      this->reserve(n);
+      table_.reserve_nodes(n);
+    }
+
+    template <class T, class H, class P, class A>
+    void unordered_set<T, H, P, A>::compact()
+    {
+      table_.compact();
+    }
+
     template <class T, class H, class P, class A>
     inline bool operator==(
       unordered_set<T, H, P, A> const& m1, unordered_set<T, H, P, A> const& m2)
@@ -1689,6 +1857,45 @@ namespace boost {
       return detail::erase_if(c, pred);
     }
 
+    // The elements of x, and those of y whose keys aren't in x.
+
+    template <class K, class H, class P, class A>
+    unordered_set<K, H, P, A> set_union(
+      unordered_set<K, H, P, A> const& x, unordered_set<K, H, P, A> const& y)
+    {
+      unordered_set<K, H, P, A> r(
+        x.bucket_count(), x.hash_function(), x.key_eq(), x.get_allocator());
+      r.max_load_factor(x.max_load_factor());
+      r.table_.copy_union_unique(x.table_, y.table_);
+      return r;
+    }
+
+    // The elements of x whose keys are in y.
+
+    template <class K, class H, class P, class A>
+    unordered_set<K, H, P, A> set_intersection(
+      unordered_set<K, H, P, A> const& x, unordered_set<K, H, P, A> const& y)
+    {
+      unordered_set<K, H, P, A> r(
+        x.bucket_count(), x.hash_function(), x.key_eq(), x.get_allocator());
+      r.max_load_factor(x.max_load_factor());
+      r.table_.copy_intersection_unique(x.table_, y.table_);
+      return r;
+    }
+
+    // The elements of x whose keys aren't in y.
+
+    template <class K, class H, class P, class A>
+    unordered_set<K, H, P, A> set_difference(
+      unordered_set<K, H, P, A> const& x, unordered_set<K, H, P, A> const& y)
+    {
+      unordered_set<K, H, P, A> r(
+        x.bucket_count(), x.hash_function(), x.key_eq(), x.get_allocator());
+      r.max_load_factor(x.max_load_factor());
+      r.table_.copy_difference_unique(x.table_, y.table_);
+      return r;
+    }
+
     ////////////////////////////////////////////////////////////////////////////
 
     template <class T, class H, class P, class A>
@@ -1995,7 +2202,7 @@ namespace boost {
       CompatibleHash const& hash, CompatiblePredicate const& eq) const
     {
       return const_iterator(
-        table_.find_node_impl(table::policy::apply_hash(hash, k), k, eq));
+        table_.find_node_impl(table_.apply_hash(hash, k), k, eq));
     }
 
     template <class T, class H, class P, class A>
@@ -2052,6 +2259,19 @@ namespace boost {
         std::ceil(static_cast<double>(n) / table_.mlf_)));
     }
 
+    template <class T, class H, class P, class A>
+    void unordered_multiset<T, H, P, A>::reserve_nodes(size_type n)
+    {
+      this->reserve(n);
+      table_.reserve_nodes(n);
+    }
+
+    template <class T, class H, class P, class A>
+    void unordered_multiset<T, H, P, A>::compact()
+    {
+      table_.compact();
+    }
+
     template <class T, class H, class P, class A>
     inline bool operator==(unordered_multiset<T, H, P, A> const& m1,
       unordered_multiset<T, H, P, A> const& m2)
@@ -37,6 +37,16 @@ namespace boost {
     typename unordered_set<K, H, P, A>::size_type erase_if(
       unordered_set<K, H, P, A>& c, Predicate pred);
 
+    template <class K, class H, class P, class A>
+    unordered_set<K, H, P, A> set_union(
+      unordered_set<K, H, P, A> const&, unordered_set<K, H, P, A> const&);
+    template <class K, class H, class P, class A>
+    unordered_set<K, H, P, A> set_intersection(
+      unordered_set<K, H, P, A> const&, unordered_set<K, H, P, A> const&);
+    template <class K, class H, class P, class A>
+    unordered_set<K, H, P, A> set_difference(
+      unordered_set<K, H, P, A> const&, unordered_set<K, H, P, A> const&);
+
     template <class T, class H = boost::hash<T>, class P = std::equal_to<T>,
       class A = std::allocator<T> >
     class unordered_multiset;
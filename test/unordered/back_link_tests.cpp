@@ -0,0 +1,305 @@
+
+// Copyright 2022 Christian Mazakas.
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// clang-format off
+#include "../helpers/prefix.hpp"
+#include <boost/unordered_set.hpp>
+#include <boost/unordered_map.hpp>
+#include "../helpers/postfix.hpp"
+// clang-format on
+
+#include "../helpers/test.hpp"
+#include "../helpers/invariants.hpp"
+#include "../objects/test.hpp"
+#include <map>
+#include <vector>
+
+// Store back links in the nodes, so that erasing and extracting by iterator
+// find the previous node without walking the bucket.
+typedef boost::unordered::link_policy_hash<boost::hash<int>,
+  boost::unordered::back_links>
+  back_link_hash;
+
+inline int get_key(int x) { return x; }
+inline int get_key(std::pair<int const, int> const& x) { return x.first; }
+
+inline int make_value(int i, int const*) { return i; }
+
+inline std::pair<int const, int> make_value(
+  int i, std::pair<int const, int> const*)
+{
+  return std::pair<int const, int>(i, i);
+}
+
+template <class X> void check_contents(X const& x, std::map<int, int> const& m)
+{
+  test::check_equivalent_keys(x);
+
+  std::size_t total = 0;
+  for (std::map<int, int>::const_iterator it = m.begin(); it != m.end();
+       ++it) {
+    BOOST_TEST_EQ(x.count(it->first), static_cast<std::size_t>(it->second));
+    total += static_cast<std::size_t>(it->second);
+  }
+  BOOST_TEST_EQ(x.size(), total);
+
+  std::size_t visited = 0;
+  for (typename X::const_iterator it = x.begin(); it != x.end(); ++it) {
+    ++visited;
+  }
+  BOOST_TEST_EQ(visited, total);
+}
+
+template <class X> void insert_value(X& x, std::map<int, int>& m, int i)
+{
+  typedef typename X::value_type value_type;
+  if (!test::has_unique_keys<X>::value || !x.count(i)) {
+    x.insert(make_value(i, (value_type const*)0));
+    ++m[i];
+  }
+}
+
+template <class X>
+void erase_by_iterator(X& x, std::map<int, int>& m, int key)
+{
+  typename X::iterator it = x.find(key);
+  if (it != x.end()) {
+    x.erase(it);
+    if (!--m[key]) {
+      m.erase(key);
+    }
+  }
+}
+
+template <class X> void back_link_tests(X*)
+{
+  // A high load factor puts lots of elements in each bucket, so that most
+  // of the nodes that are erased are in the middle of a long chain.
+  X x;
+  x.max_load_factor(20);
+  std::map<int, int> m;
+
+  for (int i = 0; i < 1000; ++i) {
+    insert_value(x, m, i % 400);
+  }
+  check_contents(x, m);
+
+  // erase from the start, middle and end of the chains
+  for (int i = 0; i < 400; i += 3) {
+    erase_by_iterator(x, m, i);
+  }
+  check_contents(x, m);
+
+  // extract and reinsert, which moves the node to a different position
+  for (int i = 1; i < 400; i += 7) {
+    typename X::iterator it = x.find(i);
+    if (it != x.end()) {
+      typename X::node_type nh = x.extract(it);
+      BOOST_TEST(!nh.empty());
+      BOOST_TEST_EQ(x.count(i), static_cast<std::size_t>(m[i] - 1));
+      x.insert(boost::move(nh));
+    }
+  }
+  check_contents(x, m);
+
+  // range erase, in the middle of the node list
+  {
+    typename X::iterator first = x.begin(), last = x.begin();
+    std::advance(first, 10);
+    std::advance(last, 20);
+    for (typename X::iterator it = first; it != last; ++it) {
+      if (!--m[get_key(*it)]) {
+        m.erase(get_key(*it));
+      }
+    }
+    x.erase(first, last);
+  }
+  check_contents(x, m);
+
+  // rehashing relinks the nodes, so erase afterwards to check the links
+  x.rehash(x.bucket_count() * 4);
+  for (int i = 2; i < 400; i += 5) {
+    erase_by_iterator(x, m, i);
+  }
+  check_contents(x, m);
+
+  x.compact();
+  for (int i = 4; i < 400; i += 11) {
+    erase_by_iterator(x, m, i);
+  }
+  check_contents(x, m);
+
+  // elements merged from another container
+  {
+    X y;
+    y.max_load_factor(20);
+    for (int i = 400; i < 600; ++i) {
+      insert_value(y, m, i);
+    }
+    x.merge(y);
+    BOOST_TEST(y.empty());
+  }
+  for (int i = 401; i < 600; i += 3) {
+    erase_by_iterator(x, m, i);
+  }
+  check_contents(x, m);
+
+  // erase everything, one element at a time
+  while (!x.empty()) {
+    typename X::iterator it = x.begin();
+    std::advance(it, static_cast<std::ptrdiff_t>(x.size() / 2));
+    erase_by_iterator(x, m, get_key(*it));
+  }
+  BOOST_TEST(m.empty());
+  check_contents(x, m);
+}
+
+#if BOOST_UNORDERED_PARALLEL
+struct key_is_odd
+{
+  template <class T> bool operator()(T const& x) const
+  {
+    return get_key(x) % 2 != 0;
+  }
+};
+
+// The parallel algorithms splice nodes from several threads. There need to
+// be enough elements for them to actually use more than one.
+template <class X> void back_link_parallel_tests(X*)
+{
+  typedef typename X::value_type value_type;
+
+  std::vector<value_type> values;
+  std::map<int, int> m;
+  for (int i = 0; i < 20000; ++i) {
+    values.push_back(make_value(i % 15000, (value_type const*)0));
+    m[i % 15000] = 1;
+  }
+
+  X x;
+  x.max_load_factor(20);
+  for (int i = 0; i < 100; i += 2) {
+    x.insert(make_value(i, (value_type const*)0));
+  }
+  x.parallel_insert(values.begin(), values.end(), 4);
+  for (int i = 0; i < 15000; i += 3) {
+    erase_by_iterator(x, m, i);
+  }
+  check_contents(x, m);
+
+  x.parallel_erase_if(key_is_odd(), 4);
+  for (int i = 1; i < 15000; i += 2) {
+    m.erase(i);
+  }
+  for (int i = 4; i < 15000; i += 10) {
+    erase_by_iterator(x, m, i);
+  }
+  check_contents(x, m);
+}
+#endif
+
+template <class X> void back_link_equiv_tests(X*)
+{
+  typedef typename X::value_type value_type;
+
+  X x;
+  x.max_load_factor(20);
+  std::map<int, int> m;
+
+  // hinted inserts link the new node after the hint
+  for (int i = 0; i < 600; ++i) {
+    typename X::iterator hint = x.find(i % 150);
+    x.insert(hint, make_value(i % 150, (value_type const*)0));
+    ++m[i % 150];
+  }
+  check_contents(x, m);
+
+  // erase the middle of each group
+  for (int i = 0; i < 150; ++i) {
+    typename X::iterator it = x.find(i);
+    ++it;
+    x.erase(it);
+    --m[i];
+  }
+  check_contents(x, m);
+
+  // erase whole groups by key, then by iterator range
+  for (int i = 0; i < 150; i += 4) {
+    BOOST_TEST_EQ(x.erase(i), static_cast<std::size_t>(m[i]));
+    m.erase(i);
+  }
+  for (int i = 1; i < 150; i += 4) {
+    std::pair<typename X::iterator, typename X::iterator> r =
+      x.equal_range(i);
+    x.erase(r.first, r.second);
+    m.erase(i);
+  }
+  check_contents(x, m);
+
+  x.rehash(x.bucket_count() * 3);
+  for (int i = 2; i < 150; i += 4) {
+    erase_by_iterator(x, m, i);
+  }
+  check_contents(x, m);
+
+  for (int i = 0; i < 150; ++i) {
+    insert_value(x, m, i);
+  }
+  while (!x.empty()) {
+    typename X::iterator it = x.begin();
+    std::advance(it, static_cast<std::ptrdiff_t>(x.size() / 3));
+    int key = get_key(*it);
+    typename X::node_type nh = x.extract(it);
+    BOOST_TEST(!nh.empty());
+    if (!--m[key]) {
+      m.erase(key);
+    }
+  }
+  BOOST_TEST(m.empty());
+  check_contents(x, m);
+}
+
+UNORDERED_AUTO_TEST (back_links) {
+  back_link_tests((boost::unordered_set<int, back_link_hash>*)0);
+  back_link_tests((boost::unordered_map<int, int, back_link_hash>*)0);
+  back_link_tests((boost::unordered_multiset<int, back_link_hash>*)0);
+  back_link_tests((boost::unordered_multimap<int, int, back_link_hash>*)0);
+  back_link_equiv_tests((boost::unordered_multiset<int, back_link_hash>*)0);
+  back_link_equiv_tests(
+    (boost::unordered_multimap<int, int, back_link_hash>*)0);
+#if BOOST_UNORDERED_PARALLEL
+  back_link_parallel_tests((boost::unordered_set<int, back_link_hash>*)0);
+  back_link_parallel_tests(
+    (boost::unordered_map<int, int, back_link_hash>*)0);
+#endif
+}
+
+// Allocators with fancy pointers use a different node type.
+UNORDERED_AUTO_TEST (back_links_fancy_pointers) {
+  back_link_tests((boost::unordered_set<int, back_link_hash,
+    std::equal_to<int>, test::allocator2<int> >*)0);
+  back_link_equiv_tests((boost::unordered_multimap<int, int, back_link_hash,
+    std::equal_to<int>, test::allocator2<std::pair<int const, int> > >*)0);
+}
+
+// Containers with and without back links can be used together.
+UNORDERED_AUTO_TEST (back_links_mixed) {
+  boost::unordered_set<int> x;
+  x.max_load_factor(20);
+  std::map<int, int> m;
+  for (int i = 0; i < 500; ++i) {
+    insert_value(x, m, i);
+  }
+  boost::unordered_set<int, back_link_hash> y(x.begin(), x.end());
+  y.max_load_factor(20);
+  for (int i = 0; i < 500; i += 3) {
+    erase_by_iterator(y, m, i);
+    x.erase(x.find(i));
+  }
+  check_contents(y, m);
+  check_contents(x, m);
+}
+
+RUN_TESTS()
@@ -0,0 +1,182 @@
+
+// Copyright 2022 Christian Mazakas.
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// clang-format off
+#include "../helpers/prefix.hpp"
+#include <boost/unordered_set.hpp>
+#include <boost/unordered_map.hpp>
+#include "../helpers/postfix.hpp"
+// clang-format on
+
+#include "../helpers/test.hpp"
+#include <boost/cstdint.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/type_traits/is_same.hpp>
+
+namespace bucket_policy_tests {
+
+  typedef boost::unordered::bucket_policy_hash<boost::hash<int>,
+    boost::unordered::prime_buckets>
+    prime_hash;
+  typedef boost::unordered::bucket_policy_hash<boost::hash<int>,
+    boost::unordered::power_of_two_buckets>
+    power_of_two_hash;
+  typedef boost::unordered::bucket_policy_hash<boost::hash<int>,
+    boost::unordered::fastrange_buckets>
+    fastrange_hash;
+
+  BOOST_STATIC_ASSERT((boost::is_same<
+    boost::unordered::hash_bucket_policy<boost::hash<int> >::type,
+    boost::unordered::default_buckets>::value));
+  BOOST_STATIC_ASSERT(
+    (boost::is_same<boost::unordered::hash_bucket_policy<prime_hash>::type,
+      boost::unordered::prime_buckets>::value));
+  BOOST_STATIC_ASSERT(
+    (boost::is_same<boost::unordered::hash_bucket_policy<fastrange_hash>::type,
+      boost::unordered::fastrange_buckets>::value));
+
+  UNORDERED_AUTO_TEST (mul_high64_test) {
+    using boost::unordered::detail::mul_high64;
+
+    boost::uint64_t const max = ~boost::uint64_t(0);
+    BOOST_TEST_EQ(mul_high64(0, max), 0u);
+    BOOST_TEST_EQ(mul_high64(max, 1), 0u);
+    BOOST_TEST_EQ(mul_high64(max, 2), 1u);
+    BOOST_TEST_EQ(mul_high64(max, max), max - 1);
+    BOOST_TEST_EQ(
+      mul_high64(boost::uint64_t(1) << 63, boost::uint64_t(1) << 63),
+      boost::uint64_t(1) << 62);
+    BOOST_TEST_EQ(mul_high64(0x123456789abcdef0u, 0xfedcba9876543210u),
+      0x121fa00ad77d7422u);
+  }
+
+  template <class SizeT> struct identity_hash
+  {
+    SizeT operator()(SizeT x) const { return x; }
+  };
+
+  template <class Policy, class SizeT> void fastrange_policy_test()
+  {
+    for (SizeT i = 0; i < 200; ++i) {
+      BOOST_TEST_EQ(Policy::new_bucket_count(i), i <= 4 ? 4u : i);
+      BOOST_TEST_EQ(Policy::prev_bucket_count(i), i);
+    }
+
+    // consecutive keys are spread evenly over a bucket count that isn't a
+    // power of two
+    SizeT const bucket_count = 1000;
+    unsigned counts[bucket_count] = {};
+    for (SizeT i = 0; i < bucket_count * 8; ++i) {
+      SizeT b = Policy::to_bucket(bucket_count,
+        Policy::apply_hash(identity_hash<SizeT>(), i), 0);
+      BOOST_TEST_LT(b, bucket_count);
+      ++counts[b];
+    }
+    for (SizeT i = 0; i < bucket_count; ++i) {
+      BOOST_TEST_GE(counts[i], 4u);
+      BOOST_TEST_LE(counts[i], 12u);
+    }
+
+    BOOST_TEST_EQ(Policy::to_bucket(7, 0, 0), 0u);
+    BOOST_TEST_EQ(Policy::to_bucket(7, ~SizeT(0), 0), 6u);
+  }
+
+  UNORDERED_AUTO_TEST (fastrange_policy_tests) {
+    fastrange_policy_test<
+      boost::unordered::detail::fastrange64_policy<boost::uint64_t>,
+      boost::uint64_t>();
+    fastrange_policy_test<
+      boost::unordered::detail::fastrange32_policy<boost::uint32_t>,
+      boost::uint32_t>();
+  }
+
+  UNORDERED_AUTO_TEST (prime_policy_tests) {
+    typedef boost::unordered::detail::prime_policy<std::size_t> policy;
+    typedef boost::unordered::detail::prime_list prime_list;
+
+    std::size_t const hashes[] = {0, 1, 16, 17, 12345, 0xffffffffu,
+      ~std::size_t(0), ~std::size_t(0) / 3, std::size_t(0x9e3779b97f4a7c15u)};
+
+    for (std::ptrdiff_t i = 0; i < prime_list::length; ++i) {
+      std::size_t prime = prime_list::value[i];
+      int index = policy::size_index(prime);
+      BOOST_TEST_EQ(index, static_cast<int>(i));
+      BOOST_TEST_EQ(policy::size_index(prime + 1), -1);
+
+      for (std::size_t j = 0; j < sizeof(hashes) / sizeof(*hashes); ++j) {
+        BOOST_TEST_EQ(
+          policy::to_bucket(prime, hashes[j], index), hashes[j] % prime);
+      }
+    }
+  }
+
+  template <class Hash> void container_test(Hash*)
+  {
+    typedef boost::unordered_map<int, int, Hash> map;
+    typedef boost::unordered_set<int, Hash> set;
+
+    map x;
+    set y;
+    for (int i = 0; i < 10000; ++i) {
+      x.emplace(i * 3, i);
+      y.insert(i * 3);
+      BOOST_TEST_LE(x.load_factor(), x.max_load_factor());
+    }
+    BOOST_TEST_EQ(x.size(), 10000u);
+    BOOST_TEST_EQ(y.size(), 10000u);
+
+    for (int i = 0; i < 30000; ++i) {
+      BOOST_TEST_EQ(x.count(i), i % 3 ? 0u : 1u);
+      BOOST_TEST_EQ(y.count(i), i % 3 ? 0u : 1u);
+    }
+
+    for (int i = 0; i < 30000; i += 2) {
+      x.erase(i);
+    }
+    BOOST_TEST_EQ(x.size(), 5000u);
+
+    x.rehash(0);
+    y.rehash(20000);
+    BOOST_TEST_GE(y.bucket_count(), 20000u);
+    for (int i = 0; i < 30000; ++i) {
+      BOOST_TEST_EQ(x.count(i), i % 6 == 3 ? 1u : 0u);
+      BOOST_TEST_EQ(y.count(i), i % 3 ? 0u : 1u);
+    }
+
+    std::size_t n = 0;
+    for (std::size_t b = 0; b < y.bucket_count(); ++b) {
+      n += y.bucket_size(b);
+    }
+    BOOST_TEST_EQ(n, y.size());
+  }
+
+  UNORDERED_AUTO_TEST (bucket_policy_containers) {
+    container_test<prime_hash>(0);
+    container_test<power_of_two_hash>(0);
+    container_test<fastrange_hash>(0);
+  }
+
+  UNORDERED_AUTO_TEST (bucket_counts) {
+    boost::unordered_set<int, prime_hash> prime;
+    prime.rehash(1000);
+    BOOST_TEST_EQ(prime.bucket_count(), 1031u);
+
+    boost::unordered_set<int, fastrange_hash> fastrange;
+    fastrange.rehash(1000);
+    BOOST_TEST_EQ(fastrange.bucket_count(), 1000u);
+
+    // grows by half rather than doubling
+    fastrange.max_load_factor(1.0f);
+    for (int i = 0; i < 1000; ++i) {
+      fastrange.insert(i);
+    }
+    BOOST_TEST_EQ(fastrange.bucket_count(), 1000u);
+    fastrange.insert(1000);
+    BOOST_TEST_LT(fastrange.bucket_count(), 1600u);
+    BOOST_TEST_GT(fastrange.bucket_count(), 1000u);
+  }
+}
+
+RUN_TESTS()
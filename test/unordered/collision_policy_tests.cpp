@@ -0,0 +1,297 @@
+
+// Copyright 2022 Christian Mazakas.
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// clang-format off
+#include "../helpers/prefix.hpp"
+#include <boost/unordered_set.hpp>
+#include <boost/unordered_map.hpp>
+#if !defined(BOOST_NO_CXX11_RVALUE_REFERENCES) &&                              \
+  !defined(BOOST_NO_CXX11_VARIADIC_TEMPLATES)
+#include <boost/unordered/filtered_unordered_set.hpp>
+#endif
+#include "../helpers/postfix.hpp"
+// clang-format on
+
+#include "../helpers/test.hpp"
+#include <boost/limits.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/type_traits/is_same.hpp>
+#include <utility>
+#include <vector>
+
+namespace collision_policy_tests {
+
+  // Wrongly claims to be avalanching, so its values are used as they are,
+  // and all the small ones end up in the first bucket.
+  struct weak_hash
+  {
+    typedef void is_avalanching;
+
+    std::size_t operator()(std::size_t x) const { return x; }
+  };
+
+  typedef boost::unordered::collision_policy_hash<weak_hash,
+    boost::unordered::adaptive_collision_defence>
+    adaptive_hash;
+
+  BOOST_STATIC_ASSERT((boost::is_same<
+    boost::unordered::hash_collision_policy<weak_hash>::type,
+    boost::unordered::no_collision_defence>::value));
+  BOOST_STATIC_ASSERT((boost::is_same<
+    boost::unordered::hash_collision_policy<adaptive_hash>::type,
+    boost::unordered::adaptive_collision_defence>::value));
+  BOOST_STATIC_ASSERT(
+    boost::unordered::hash_is_avalanching<adaptive_hash>::value);
+
+  // Only the power of two and fastrange policies pick buckets from the
+  // high bits.
+  bool const high_bit_buckets =
+    std::numeric_limits<std::size_t>::radix == 2 &&
+    (std::numeric_limits<std::size_t>::digits == 32 ||
+      std::numeric_limits<std::size_t>::digits == 64);
+
+  std::size_t const count = 1000;
+
+  template <class Container>
+  std::size_t max_bucket_size(Container const& x)
+  {
+    std::size_t n = 0;
+    for (std::size_t b = 0; b < x.bucket_count(); ++b) {
+      if (x.bucket_size(b) > n) {
+        n = x.bucket_size(b);
+      }
+    }
+    return n;
+  }
+
+  template <class Set> void check_set(Set const& x, std::size_t n)
+  {
+    BOOST_TEST_EQ(x.size(), n);
+    for (std::size_t i = 0; i < count; ++i) {
+      BOOST_TEST_EQ(x.count(i), i < n ? 1u : 0u);
+    }
+    BOOST_TEST_LE(max_bucket_size(x), 16u);
+  }
+
+  UNORDERED_AUTO_TEST (without_defence) {
+    boost::unordered_set<std::size_t, weak_hash> x;
+    for (std::size_t i = 0; i < count; ++i) {
+      x.insert(i);
+    }
+    if (high_bit_buckets) {
+      BOOST_TEST_EQ(x.bucket_size(0), count);
+    }
+  }
+
+  UNORDERED_AUTO_TEST (adaptive_set) {
+    typedef boost::unordered_set<std::size_t, adaptive_hash> set;
+
+    set x;
+    for (std::size_t i = 0; i < count; ++i) {
+      BOOST_TEST(x.insert(i).second);
+      BOOST_TEST(!x.insert(i).second);
+    }
+    check_set(x, count);
+
+    // The seed goes with the elements.
+    set y(x);
+    check_set(y, count);
+    set z;
+    z = x;
+    check_set(z, count);
+    set w(boost::move(z));
+    check_set(w, count);
+    z.clear();
+    z.insert(0);
+    z.swap(w);
+    check_set(z, count);
+    check_set(w, 1);
+    w.clear();
+    check_set(w, 0);
+
+    for (std::size_t i = count / 2; i < count; ++i) {
+      BOOST_TEST_EQ(x.erase(i), 1u);
+    }
+    check_set(x, count / 2);
+    x.rehash(0);
+    check_set(x, count / 2);
+
+    // Both tables are seeded, but with different seeds.
+    set u = set_intersection(x, y);
+    check_set(u, count / 2);
+    u = set_union(x, y);
+    check_set(u, count);
+  }
+
+  UNORDERED_AUTO_TEST (adaptive_inserts) {
+    typedef boost::unordered_set<std::size_t, adaptive_hash> set;
+    typedef boost::unordered_map<std::size_t, std::size_t, adaptive_hash> map;
+
+    std::vector<std::size_t> keys;
+    std::vector<std::pair<std::size_t, std::size_t> > values;
+    for (std::size_t i = 0; i < count; ++i) {
+      keys.push_back(i);
+      values.push_back(std::make_pair(i, i * 2));
+    }
+
+    set x(keys.begin(), keys.end());
+    check_set(x, count);
+
+    // The table is seeded part way through a batch.
+    map y;
+    BOOST_TEST_EQ(y.batch_insert_or_assign(values.begin(), values.end()),
+      count);
+    BOOST_TEST_EQ(y.size(), count);
+    for (std::size_t i = 0; i < count; ++i) {
+      BOOST_TEST_EQ(y.at(i), i * 2);
+    }
+    BOOST_TEST_LE(max_bucket_size(y), 16u);
+
+    // The elements of an unseeded table are moved into a seeded one.
+    boost::unordered_set<std::size_t, adaptive_hash> z;
+    for (std::size_t i = 0; i < 10; ++i) {
+      z.insert(count + i);
+    }
+    x.merge(z);
+    BOOST_TEST(z.empty());
+    BOOST_TEST_EQ(x.size(), count + 10);
+    for (std::size_t i = 0; i < count + 10; ++i) {
+      BOOST_TEST_EQ(x.count(i), 1u);
+    }
+
+    set w;
+    for (std::size_t i = 0; i < count; ++i) {
+      w.insert(x.extract(i));
+    }
+    check_set(w, count);
+  }
+
+  UNORDERED_AUTO_TEST (adaptive_multiset) {
+    boost::unordered_multiset<std::size_t, adaptive_hash> x;
+    for (std::size_t i = 0; i < count; ++i) {
+      x.insert(i);
+      x.insert(i);
+    }
+    BOOST_TEST_EQ(x.size(), count * 2);
+    for (std::size_t i = 0; i < count; ++i) {
+      BOOST_TEST_EQ(x.count(i), 2u);
+    }
+    BOOST_TEST_LE(max_bucket_size(x), 32u);
+  }
+
+  template <class Container> void check_buckets(Container const& x)
+  {
+    std::size_t n = 0;
+    for (std::size_t b = 0; b < x.bucket_count(); ++b) {
+      n += x.bucket_size(b);
+    }
+    BOOST_TEST_EQ(n, x.size());
+  }
+
+  // Keys in different buckets of a table with 2^20 buckets, but all in the
+  // first bucket of a small one.
+  std::size_t spread_key(std::size_t i)
+  {
+    return i << (std::numeric_limits<std::size_t>::digits - 20);
+  }
+
+  // A multimap spread over many buckets is copied into fewer, so the copy
+  // is seeded part way through a group of equivalent keys.
+  template <class Multimap> void check_multimap(Multimap& x)
+  {
+    check_buckets(x);
+    BOOST_TEST_LE(max_bucket_size(x), 48u);
+    for (std::size_t i = 0; i < 40; ++i) {
+      std::size_t const k = spread_key(i);
+      BOOST_TEST_EQ(x.count(k), 3u);
+      typename Multimap::iterator it = x.find(k);
+      ++it;
+      ++it;
+      x.erase(it);
+      BOOST_TEST_EQ(x.count(k), 2u);
+    }
+    check_buckets(x);
+    BOOST_TEST_EQ(x.size(), 80u);
+  }
+
+  UNORDERED_AUTO_TEST (adaptive_multimap_copy) {
+    typedef boost::unordered_multimap<std::size_t, std::size_t, adaptive_hash>
+      multimap;
+
+    multimap x;
+    x.rehash(std::size_t(1) << 20);
+    for (std::size_t i = 0; i < 40; ++i) {
+      for (std::size_t j = 0; j < 3; ++j) {
+        x.insert(std::make_pair(spread_key(i), j));
+      }
+    }
+    check_buckets(x);
+
+    multimap y(x);
+    check_multimap(y);
+
+    multimap z;
+    z.insert(std::make_pair(std::size_t(1), std::size_t(1)));
+    z = x;
+    check_multimap(z);
+  }
+
+#if BOOST_UNORDERED_PARALLEL
+  // The parallel insert links the nodes from several threads, and checks
+  // the chains afterwards.
+  UNORDERED_AUTO_TEST (adaptive_parallel_insert) {
+    std::vector<std::size_t> values;
+    for (std::size_t i = 0; i < 20000; ++i) {
+      values.push_back(i);
+    }
+
+    boost::unordered_set<std::size_t, adaptive_hash> x;
+    x.parallel_insert(values.begin(), values.end(), 4);
+    BOOST_TEST_EQ(x.size(), values.size());
+    for (std::size_t i = 0; i < values.size(); ++i) {
+      BOOST_TEST_EQ(x.count(i), 1u);
+    }
+    BOOST_TEST_LE(max_bucket_size(x), 16u);
+  }
+#endif
+
+  // Seeding can't separate keys with equal hash values, so the table only
+  // tries once.
+  struct constant_hash
+  {
+    typedef boost::unordered::adaptive_collision_defence collision_policy;
+
+    std::size_t operator()(std::size_t) const { return 7; }
+  };
+
+  UNORDERED_AUTO_TEST (equal_hash_values) {
+    boost::unordered_set<std::size_t, constant_hash> x;
+    for (std::size_t i = 0; i < 200; ++i) {
+      x.insert(i);
+    }
+    BOOST_TEST_EQ(x.size(), 200u);
+    BOOST_TEST_EQ(max_bucket_size(x), 200u);
+    for (std::size_t i = 0; i < 200; ++i) {
+      BOOST_TEST_EQ(x.count(i), 1u);
+    }
+  }
+
+#if !defined(BOOST_NO_CXX11_RVALUE_REFERENCES) &&                              \
+  !defined(BOOST_NO_CXX11_VARIADIC_TEMPLATES)
+  // The filter holds hash values, so it's rebuilt when the table is seeded.
+  UNORDERED_AUTO_TEST (adaptive_filtered_set) {
+    boost::filtered_unordered_set<std::size_t, adaptive_hash> x;
+    for (std::size_t i = 0; i < count; ++i) {
+      BOOST_TEST(x.insert(i).second);
+    }
+    BOOST_TEST_EQ(x.size(), count);
+    for (std::size_t i = 0; i < count * 2; ++i) {
+      BOOST_TEST_EQ(x.contains(i), i < count);
+    }
+  }
+#endif
+}
+
+RUN_TESTS()
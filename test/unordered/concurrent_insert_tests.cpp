@@ -0,0 +1,237 @@
+
+// Copyright 2022 Christian Mazakas.
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// clang-format off
+#include "../helpers/prefix.hpp"
+#include <boost/unordered/concurrent_insert_set.hpp>
+#include <boost/unordered/concurrent_insert_map.hpp>
+#include <boost/unordered_set.hpp>
+#include <boost/unordered_map.hpp>
+#include "../helpers/postfix.hpp"
+// clang-format on
+
+#include "../helpers/test.hpp"
+
+#if BOOST_UNORDERED_CONCURRENT
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace concurrent_insert_tests {
+
+  // Counts the live instances, to check that the nodes constructed for
+  // duplicates are destroyed.
+  struct counted
+  {
+    static std::atomic<int> count;
+
+    std::string value;
+
+    explicit counted(int x) : value(std::to_string(x)) { ++count; }
+    counted(counted const& x) : value(x.value) { ++count; }
+    ~counted() { --count; }
+
+    int get() const { return std::stoi(value); }
+
+  private:
+    counted& operator=(counted const&);
+  };
+
+  std::atomic<int> counted::count(0);
+
+  // Yields on some comparisons, so that on a single core threads are often
+  // interrupted in the middle of a chain.
+  struct yielding_equal
+  {
+    bool operator()(int x, int y) const
+    {
+      if (x % 4 == 0) {
+        std::this_thread::yield();
+      }
+      return x == y;
+    }
+  };
+
+  typedef boost::concurrent_insert_set<std::string> string_set;
+  typedef boost::concurrent_insert_set<int, boost::hash<int>, yielding_equal>
+    int_set;
+  typedef boost::concurrent_insert_map<int, counted> map;
+
+  struct get_value
+  {
+    int* result;
+
+    void operator()(std::pair<int const, counted> const& x) const
+    {
+      *result = x.second.get();
+    }
+  };
+
+  int value_of(map const& x, int k)
+  {
+    int result = -1;
+    get_value f = {&result};
+    x.visit(k, f);
+    return result;
+  }
+
+  UNORDERED_AUTO_TEST (concurrent_insert_single_thread) {
+    {
+      string_set x;
+      boost::unordered_set<std::string> expected;
+      BOOST_TEST(x.empty());
+
+      for (int i = 0; i < 3000; ++i) {
+        std::string s = std::to_string(i * 7 % 2000);
+        bool inserted = expected.insert(s).second;
+        switch (i % 3) {
+        case 0:
+          BOOST_TEST_EQ(x.insert(s), inserted);
+          break;
+        case 1:
+          BOOST_TEST_EQ(x.insert(std::string(s)), inserted);
+          break;
+        default:
+          BOOST_TEST_EQ(x.emplace(s.c_str()), inserted);
+        }
+      }
+      BOOST_TEST_EQ(x.size(), expected.size());
+      BOOST_TEST_LE(x.load_factor(), x.max_load_factor());
+
+      for (int i = 0; i < 2100; ++i) {
+        std::string s = std::to_string(i);
+        BOOST_TEST_EQ(x.contains(s), expected.count(s) != 0);
+        BOOST_TEST_EQ(x.count(s), expected.count(s));
+      }
+
+      // elements stay where they are
+      std::string const* address = 0;
+      BOOST_TEST(x.visit("7", [&](std::string const& v) { address = &v; }));
+      x.reserve(x.size() * 16);
+      BOOST_TEST_GE(x.bucket_count(), x.size() * 16);
+      x.visit("7", [&](std::string const& v) { BOOST_TEST_EQ(address, &v); });
+
+      std::size_t visited = 0;
+      x.visit_all([&](std::string const& v) {
+        ++visited;
+        BOOST_TEST(expected.count(v));
+      });
+      BOOST_TEST_EQ(visited, expected.size());
+
+      x.clear();
+      BOOST_TEST(x.empty());
+      BOOST_TEST(!x.contains("1"));
+      BOOST_TEST(x.insert("1"));
+      BOOST_TEST(x.contains("1"));
+    }
+
+    {
+      map x(4);
+      boost::unordered_map<int, int> expected;
+      for (int i = 0; i < 2000; ++i) {
+        int k = i * 7 % 1500;
+        bool inserted = expected.emplace(k, i).second;
+        switch (i % 3) {
+        case 0:
+          BOOST_TEST_EQ(x.emplace(k, counted(i)), inserted);
+          break;
+        case 1:
+          BOOST_TEST_EQ(x.try_emplace(k, i), inserted);
+          break;
+        default:
+          BOOST_TEST_EQ(x.insert(map::value_type(k, counted(i))), inserted);
+        }
+      }
+      BOOST_TEST_EQ(x.size(), expected.size());
+      BOOST_TEST_EQ(counted::count, static_cast<int>(expected.size()));
+
+      for (int k = 0; k < 1600; ++k) {
+        boost::unordered_map<int, int>::const_iterator it = expected.find(k);
+        BOOST_TEST_EQ(value_of(x, k), it == expected.end() ? -1 : it->second);
+      }
+    }
+    BOOST_TEST_EQ(counted::count, 0);
+  }
+
+  // Several threads insert overlapping ranges, starting from a tiny table
+  // so that it's moved to a larger array many times while they're at it.
+  UNORDERED_AUTO_TEST (concurrent_insert_threads) {
+    int const thread_count = 4;
+    int const range = 20000;
+
+    int_set x(2);
+    std::atomic<int> inserted(0), missing(0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < thread_count; ++t) {
+      threads.push_back(std::thread([&, t] {
+        for (int i = 0; i < range; ++i) {
+          int k = (i * 7 + t * range / thread_count) % range;
+          if (x.insert(k)) {
+            ++inserted;
+          }
+          if (!x.contains(k)) {
+            ++missing;
+          }
+        }
+      }));
+    }
+    for (std::size_t t = 0; t < threads.size(); ++t) {
+      threads[t].join();
+    }
+
+    BOOST_TEST_EQ(inserted.load(), range);
+    BOOST_TEST_EQ(missing.load(), 0);
+    BOOST_TEST_EQ(x.size(), static_cast<std::size_t>(range));
+    BOOST_TEST_LE(x.load_factor(), x.max_load_factor());
+
+    std::vector<int> seen(range);
+    x.visit_all([&](int v) { ++seen[static_cast<std::size_t>(v)]; });
+    for (int k = 0; k < range; ++k) {
+      BOOST_TEST_EQ(seen[static_cast<std::size_t>(k)], 1);
+    }
+  }
+
+  // Only one thread constructs the value that ends up in the map, the
+  // others' are destroyed.
+  UNORDERED_AUTO_TEST (concurrent_insert_map_threads) {
+    {
+      int const range = 5000;
+
+      map x;
+      std::atomic<int> inserted(0);
+      std::vector<std::thread> threads;
+      for (int t = 0; t < 3; ++t) {
+        threads.push_back(std::thread([&, t] {
+          for (int k = 0; k < range; ++k) {
+            bool b = t % 2 ? x.try_emplace(k, k) : x.emplace(k, counted(k));
+            if (b) {
+              ++inserted;
+            }
+          }
+        }));
+      }
+
+      // while another thread grows the table
+      x.rehash(range * 4);
+
+      for (std::size_t t = 0; t < threads.size(); ++t) {
+        threads[t].join();
+      }
+
+      BOOST_TEST_EQ(inserted.load(), range);
+      BOOST_TEST_EQ(counted::count, range);
+      for (int k = 0; k < range; ++k) {
+        BOOST_TEST_EQ(value_of(x, k), k);
+      }
+    }
+    BOOST_TEST_EQ(counted::count, 0);
+  }
+}
+
+#endif
+
+RUN_TESTS()
@@ -0,0 +1,283 @@
+
+// Copyright 2022 Christian Mazakas.
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// clang-format off
+#include "../helpers/prefix.hpp"
+#include <boost/unordered/concurrent_read_map.hpp>
+#include <boost/unordered_map.hpp>
+#include "../helpers/postfix.hpp"
+// clang-format on
+
+#include "../helpers/test.hpp"
+
+#if BOOST_UNORDERED_CONCURRENT
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace concurrent_read_map_tests {
+
+  // Counts the live instances, to check that every retired node is
+  // eventually destroyed.
+  struct counted
+  {
+    static std::atomic<int> count;
+
+    std::string value;
+
+    explicit counted(int x) : value(std::to_string(x)) { ++count; }
+    counted(counted const& x) : value(x.value) { ++count; }
+    ~counted() { --count; }
+
+    int get() const { return std::stoi(value); }
+
+  private:
+    counted& operator=(counted const&);
+  };
+
+  std::atomic<int> counted::count(0);
+
+  // Yields on every comparison, so that on a single core readers are often
+  // interrupted in the middle of a chain.
+  struct yielding_equal
+  {
+    bool operator()(int x, int y) const
+    {
+      std::this_thread::yield();
+      return x == y;
+    }
+  };
+
+  typedef boost::concurrent_read_map<int, counted> map;
+  typedef boost::concurrent_read_map<int, counted, boost::hash<int>,
+    yielding_equal>
+    yielding_map;
+
+  struct get_value
+  {
+    int* result;
+
+    void operator()(std::pair<int const, counted> const& x) const
+    {
+      *result = x.second.get();
+    }
+  };
+
+  template <class Map> int value_of(Map const& x, int k)
+  {
+    int result = -1;
+    get_value f = {&result};
+    x.visit(k, f);
+    return result;
+  }
+
+  UNORDERED_AUTO_TEST (concurrent_read_map_single_thread) {
+    {
+      map x;
+      boost::unordered_map<int, int> expected;
+      BOOST_TEST(x.empty());
+      BOOST_TEST_GE(x.bucket_count(), 11u);
+
+      for (int i = 0; i < 2000; ++i) {
+        int k = i * 7 % 1500;
+        bool inserted = expected.emplace(k, i).second;
+        switch (i % 3) {
+        case 0:
+          BOOST_TEST_EQ(x.emplace(k, counted(i)), inserted);
+          break;
+        case 1:
+          BOOST_TEST_EQ(x.try_emplace(k, i), inserted);
+          break;
+        default:
+          BOOST_TEST_EQ(x.insert(map::value_type(k, counted(i))), inserted);
+        }
+      }
+      BOOST_TEST_EQ(x.size(), expected.size());
+      BOOST_TEST_LE(x.load_factor(), x.max_load_factor());
+
+      for (int k = 0; k < 1600; ++k) {
+        boost::unordered_map<int, int>::const_iterator it = expected.find(k);
+        BOOST_TEST_EQ(x.contains(k), it != expected.end());
+        BOOST_TEST_EQ(x.count(k), expected.count(k));
+        BOOST_TEST_EQ(value_of(x, k), it == expected.end() ? -1 : it->second);
+      }
+
+      // replacing values
+      for (int k = 0; k < 1600; k += 2) {
+        BOOST_TEST_EQ(x.insert_or_assign(k, counted(-k)), !expected.count(k));
+        expected[k] = -k;
+      }
+
+      // erasing
+      for (int k = 0; k < 1600; k += 3) {
+        BOOST_TEST_EQ(x.erase(k), expected.erase(k));
+      }
+      BOOST_TEST_EQ(x.size(), expected.size());
+
+      std::size_t visited = 0;
+      x.visit_all([&](std::pair<int const, counted> const& v) {
+        ++visited;
+        BOOST_TEST_EQ(v.second.get(), expected[v.first]);
+      });
+      BOOST_TEST_EQ(visited, expected.size());
+
+      // growing keeps all the elements
+      std::size_t buckets = x.bucket_count();
+      x.rehash(buckets * 8);
+      BOOST_TEST_GE(x.bucket_count(), buckets * 8);
+      x.rehash(0);
+      BOOST_TEST_GE(x.bucket_count(), buckets * 8);
+      for (boost::unordered_map<int, int>::const_iterator it =
+             expected.begin();
+           it != expected.end(); ++it) {
+        BOOST_TEST_EQ(value_of(x, it->first), it->second);
+      }
+
+      x.clear();
+      BOOST_TEST(x.empty());
+      BOOST_TEST(!x.contains(1));
+      BOOST_TEST(x.emplace(1, counted(1)));
+      BOOST_TEST_EQ(value_of(x, 1), 1);
+    }
+    BOOST_TEST_EQ(counted::count, 0);
+  }
+
+  // Readers look up keys that are always present, while a writer replaces
+  // their values, and inserts and erases other keys, growing the table
+  // several times along the way.
+  UNORDERED_AUTO_TEST (concurrent_read_map_readers_and_writer) {
+    {
+      int const stable_keys = 500;
+      int const other_keys = 20000;
+
+      yielding_map x(4);
+      for (int k = 0; k < stable_keys; ++k) {
+        x.emplace(k, counted(k));
+      }
+
+      // the key that the writer is about to replace or erase
+      std::atomic<int> target(0);
+
+      std::atomic<bool> done(false);
+      std::atomic<int> started(0), errors(0);
+      std::vector<std::thread> readers;
+      for (int t = 0; t < 3; ++t) {
+        readers.push_back(std::thread([&, t] {
+          ++started;
+          int k = t;
+          do {
+            k = (k + 7) % stable_keys;
+
+            // the stable keys map to themselves, or their negation
+            int v = value_of(x, k);
+            if (v != k && v != -k) {
+              ++errors;
+            }
+
+            // so do the other keys, whenever they're present
+            int k2 = target.load();
+            int v2 = value_of(x, k2);
+            if (v2 != -1 && v2 != k2 && v2 != -k2) {
+              ++errors;
+            }
+          } while (!done.load(std::memory_order_relaxed));
+        }));
+      }
+
+      while (started != 3) {
+        std::this_thread::yield();
+      }
+
+      for (int i = 0; i < other_keys; ++i) {
+        // give the readers a chance to run on a single core
+        if (i % 64 == 0) {
+          std::this_thread::yield();
+        }
+
+        x.emplace(stable_keys + i, counted(stable_keys + i));
+        if (i % 3 == 0) {
+          int k = i % stable_keys;
+          target = k;
+          x.insert_or_assign(k, counted(i % 2 ? k : -k));
+        }
+        if (i % 2 == 0) {
+          target = stable_keys + i / 2;
+          x.erase(stable_keys + i / 2);
+        }
+      }
+
+      done = true;
+      for (std::size_t t = 0; t < readers.size(); ++t) {
+        readers[t].join();
+      }
+
+      BOOST_TEST_EQ(errors.load(), 0);
+      BOOST_TEST_EQ(x.size(),
+        static_cast<std::size_t>(stable_keys + other_keys - other_keys / 2));
+      for (int k = 0; k < stable_keys; ++k) {
+        int v = value_of(x, k);
+        BOOST_TEST(v == k || v == -k);
+      }
+
+      std::size_t visited = 0;
+      x.visit_all([&visited](std::pair<int const, counted> const&) {
+        ++visited;
+      });
+      BOOST_TEST_EQ(visited, x.size());
+    }
+    BOOST_TEST_EQ(counted::count, 0);
+  }
+
+  // A node that's erased while a reader is looking at it isn't destroyed
+  // until the reader is done.
+  UNORDERED_AUTO_TEST (concurrent_read_map_reclamation) {
+    {
+      map x;
+      x.reserve(1000);
+      for (int k = 0; k < 1000; ++k) {
+        x.emplace(k, counted(k));
+      }
+      int const count = counted::count;
+
+      std::atomic<int> stage(0);
+      int seen = -1;
+      std::thread reader([&] {
+        x.visit(0, [&](std::pair<int const, counted> const& v) {
+          stage = 1;
+          while (stage != 2) {
+            std::this_thread::yield();
+          }
+          seen = v.second.get();
+        });
+      });
+
+      while (stage != 1) {
+        std::this_thread::yield();
+      }
+
+      // enough erasures to trigger reclamation a few times
+      BOOST_TEST_EQ(x.erase(0), 1u);
+      for (int k = 1; k < 500; ++k) {
+        x.erase(k);
+        x.insert_or_assign(k + 500, counted(k + 500));
+      }
+      BOOST_TEST_EQ(counted::count, count + 499);
+
+      stage = 2;
+      reader.join();
+      BOOST_TEST_EQ(seen, 0);
+
+      // with no readers left, clear destroys the retired nodes as well
+      x.clear();
+      BOOST_TEST_EQ(counted::count, 0);
+    }
+  }
+}
+
+#endif
+
+RUN_TESTS()
@@ -13,6 +13,7 @@
 #include <boost/preprocessor/seq.hpp>
 #include <list>
 #include "../helpers/test.hpp"
+#include "../objects/test.hpp"
 
 namespace equality_tests {
   struct mod_compare
@@ -151,6 +152,107 @@ namespace equality_tests {
     set2.insert(10);
     BOOST_TEST(set1 == set2);
   }
+
+  // Large groups whose elements are in a different order. Their values are
+  // compared by hashing them when std::hash is enabled for them, so also
+  // test with a type that isn't hashable.
+
+  struct unhashable
+  {
+    int x_;
+
+    explicit unhashable(int x) : x_(x) {}
+
+    bool operator==(unhashable const& y) const { return x_ == y.x_; }
+  };
+
+  template <class Mapped> void large_group_test(Mapped*)
+  {
+    typedef boost::unordered_multimap<int, Mapped> map;
+    int const n = 2000;
+
+    map map1, map2;
+    for (int i = 0; i < n; ++i) {
+      map1.insert(std::make_pair(i % 2, Mapped(i / 2 % 300)));
+      int j = n - 1 - i;
+      map2.insert(std::make_pair(j % 2, Mapped(j / 2 % 300)));
+    }
+    BOOST_TEST(map1 == map2);
+    BOOST_TEST(map2 == map1);
+
+    // replace a value with a value that isn't in the other map
+    map map3(map2);
+    map3.erase(map3.find(0));
+    map3.insert(std::make_pair(0, Mapped(-1)));
+    BOOST_TEST(map1 != map3);
+    BOOST_TEST(map3 != map1);
+
+    // replace a value with another copy of one that's already there
+    map map4(map2);
+    map4.erase(map4.find(1));
+    map4.insert(std::make_pair(1, Mapped(5)));
+    BOOST_TEST(map1 != map4);
+    BOOST_TEST(map4 != map1);
+  }
+
+  // A large group with only a few distinct values, so that many of its
+  // elements are equal.
+  template <class Map> void few_values_test(Map*, int values)
+  {
+    int const n = 100000;
+
+    Map map1, map2;
+    for (int i = 0; i < n; ++i) {
+      map1.insert(std::make_pair(0, i % values));
+      map2.insert(std::make_pair(0, (n - 1 - i) % values));
+    }
+    BOOST_TEST(map1 == map2);
+    BOOST_TEST(map2 == map1);
+
+    // one less of the first value, and one more of the second
+    Map map4;
+    for (int i = 0; i < n; ++i) {
+      map4.insert(std::make_pair(0, i == 0 ? 1 : i % values));
+    }
+    BOOST_TEST(map1 != map4);
+    BOOST_TEST(map4 != map1);
+
+    // a value that isn't in the other map
+    Map map5;
+    for (int i = 0; i < n; ++i) {
+      map5.insert(std::make_pair(0, i == 0 ? values : i % values));
+    }
+    BOOST_TEST(map1 != map5);
+    BOOST_TEST(map5 != map1);
+  }
+
+  UNORDERED_AUTO_TEST (equality_few_values_test) {
+    typedef boost::unordered_multimap<int, int> map;
+    few_values_test((map*)0, 1);
+    few_values_test((map*)0, 3);
+    few_values_test((map*)0, 10);
+
+    typedef boost::unordered_multimap<int, int, boost::hash<int>,
+      std::equal_to<int>, test::allocator2<std::pair<int const, int> > >
+      fancy_map;
+    few_values_test((fancy_map*)0, 3);
+  }
+
+  UNORDERED_AUTO_TEST (equality_large_group_test) {
+    large_group_test((int*)0);
+    large_group_test((unhashable*)0);
+
+    // the elements of a group are equivalent, but not all equal
+    boost::unordered_multiset<int, mod_compare, mod_compare> set1, set2;
+    for (int i = 0; i < 100; ++i) {
+      set1.insert(i % 2 + i / 2 * 1000);
+      set2.insert((99 - i) % 2 + (99 - i) / 2 * 1000);
+    }
+    BOOST_TEST(set1 == set2);
+    set2.erase(set2.find(1));
+    set2.insert(99001);
+    BOOST_TEST(set1 != set2);
+  }
 }
 
 RUN_TESTS()
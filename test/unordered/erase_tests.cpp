@@ -243,6 +243,57 @@ namespace erase_tests {
       BOOST_TEST(x.begin() == x.end());
     }
 
+    BOOST_LIGHTWEIGHT_TEST_OSTREAM << "release_storage().\n";
+    {
+      test::check_instances check_;
+
+      test::random_values<Container> v(500, generator);
+      Container x(v.begin(), v.end());
+      std::size_t size = x.size();
+
+      typename Container::storage_type storage = x.release_storage();
+      BOOST_TEST(x.empty());
+      BOOST_TEST(x.begin() == x.end());
+      BOOST_TEST(!storage.empty());
+      BOOST_TEST_EQ(storage.size(), size);
+
+      // the container can be used straight away
+      x.insert(v.begin(), v.end());
+      BOOST_TEST_EQ(x.size(), size);
+      test::check_equivalent_keys(x);
+
+      // destroy in slices, moving the storage in between
+      BOOST_TEST(!storage.destroy_some(100));
+      BOOST_TEST_EQ(storage.size(), size - 100);
+      typename Container::storage_type storage2(boost::move(storage));
+      BOOST_TEST(storage.empty());
+      BOOST_TEST_EQ(storage2.size(), size - 100);
+      while (!storage2.destroy_some(100)) {
+      }
+      BOOST_TEST(storage2.empty());
+      BOOST_TEST_EQ(storage2.size(), 0u);
+
+      // moving into storage that isn't empty destroys it first
+      storage = x.release_storage();
+      BOOST_TEST_EQ(storage.size(), size);
+      storage2 = boost::move(storage);
+      BOOST_TEST_EQ(storage2.size(), size);
+
+      // an empty container still has a bucket array, unless it's already
+      // been released
+      Container x2;
+      storage = x2.release_storage();
+      BOOST_TEST(!storage.empty());
+      BOOST_TEST_EQ(storage.size(), 0u);
+      storage = x2.release_storage();
+      BOOST_TEST(storage.empty());
+
+      // the destructor destroys whatever is left
+      x2.insert(v.begin(), v.end());
+      storage = x2.release_storage();
+      storage.destroy_some(10);
+    }
+
     BOOST_LIGHTWEIGHT_TEST_OSTREAM << "\n";
   }
 
@@ -0,0 +1,172 @@
+
+// Copyright 2022 Christian Mazakas.
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// clang-format off
+#include "../helpers/prefix.hpp"
+#include <boost/unordered/filtered_unordered_map.hpp>
+#include <boost/unordered/filtered_unordered_set.hpp>
+#include "../helpers/postfix.hpp"
+// clang-format on
+
+#include "../helpers/test.hpp"
+
+#if !defined(BOOST_NO_CXX11_RVALUE_REFERENCES) &&                              \
+  !defined(BOOST_NO_CXX11_VARIADIC_TEMPLATES)
+
+#include <boost/core/detail/splitmix64.hpp>
+#include <boost/cstdint.hpp>
+#include <map>
+#include <set>
+#include <stdexcept>
+#include <string>
+
+namespace filtered_unordered_tests {
+  typedef boost::filtered_unordered_set<boost::uint64_t> set_type;
+  typedef boost::filtered_unordered_map<int, std::string> map_type;
+
+  void check(set_type const& x, std::set<boost::uint64_t> const& m)
+  {
+    BOOST_TEST_EQ(x.size(), m.size());
+    std::size_t n = 0;
+    for (set_type::const_iterator it = x.begin(); it != x.end(); ++it) {
+      BOOST_TEST(m.count(*it));
+      ++n;
+    }
+    BOOST_TEST_EQ(n, m.size());
+    for (std::set<boost::uint64_t>::const_iterator it = m.begin();
+         it != m.end(); ++it) {
+      BOOST_TEST(x.contains(*it));
+      BOOST_TEST(x.find(*it) != x.end());
+    }
+  }
+
+  // Counts the lookups of keys that aren't in the set which the filter
+  // lets through.
+  std::size_t false_positives(set_type const& x, std::size_t count)
+  {
+    boost::detail::splitmix64 rng(12345);
+    std::size_t n = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+      // odd keys are never inserted
+      if (x.filter_might_contain(rng() | 1)) {
+        ++n;
+      }
+    }
+    return n;
+  }
+
+  UNORDERED_AUTO_TEST (filtered_set_random) {
+    boost::detail::splitmix64 rng;
+    set_type x;
+    std::set<boost::uint64_t> m;
+
+    BOOST_TEST_EQ(x.filter_bits_per_element(),
+      set_type::default_filter_bits_per_element);
+    BOOST_TEST(!x.contains(0));
+
+    // Many erasures, so that the filter is refreshed several times.
+    for (int i = 0; i < 50000; ++i) {
+      boost::uint64_t r = rng();
+      boost::uint64_t k = (r >> 8) & 0x3ffe;
+      if (r % 3 == 0) {
+        BOOST_TEST_EQ(x.erase(k), m.erase(k));
+      } else {
+        BOOST_TEST_EQ(x.insert(k).second, m.insert(k).second);
+      }
+    }
+    check(x, m);
+    BOOST_TEST_GT(x.filter_memory(), 0u);
+
+    set_type y(x);
+    check(y, m);
+    set_type z(std::move(y));
+    check(z, m);
+    y = z;
+    check(y, m);
+    swap(y, z);
+    check(y, m);
+
+    for (set_type::iterator it = y.begin(); it != y.end();) {
+      if (*it & 2) {
+        m.erase(*it);
+        it = y.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    check(y, m);
+    y.refresh_filter();
+    check(y, m);
+
+    y.rehash(y.bucket_count() * 4);
+    check(y, m);
+    y.clear();
+    check(y, std::set<boost::uint64_t>());
+  }
+
+  UNORDERED_AUTO_TEST (filtered_set_false_positives) {
+    set_type x;
+    for (boost::uint64_t i = 0; i < 20000; ++i) {
+      x.insert(i * 2);
+    }
+
+    // The estimate is about 1%, allow for the blocks filling unevenly.
+    double const rate = x.filter_false_positive_rate();
+    BOOST_TEST_GT(rate, 0.0);
+    BOOST_TEST_LT(rate, 0.02);
+    BOOST_TEST_LT(false_positives(x, 100000), 3000u);
+
+    // Fewer bits per element let more through.
+    std::size_t const memory = x.filter_memory();
+    x.filter_bits_per_element(4);
+    BOOST_TEST_LT(x.filter_memory(), memory);
+    BOOST_TEST_GT(x.filter_false_positive_rate(), rate);
+    for (boost::uint64_t i = 0; i < 20000; ++i) {
+      BOOST_TEST(x.contains(i * 2));
+    }
+
+    // Without a filter, every lookup goes to the buckets.
+    x.filter_bits_per_element(0);
+    BOOST_TEST_EQ(x.filter_memory(), 0u);
+    BOOST_TEST_EQ(false_positives(x, 1000), 1000u);
+    BOOST_TEST(x.insert(1).second);
+    BOOST_TEST(x.contains(1));
+    x.filter_bits_per_element(16);
+    BOOST_TEST(x.contains(1));
+    BOOST_TEST_LT(false_positives(x, 100000), 300u);
+  }
+
+  UNORDERED_AUTO_TEST (filtered_map) {
+    map_type x;
+    std::map<int, std::string> m;
+    for (int i = 0; i < 1000; ++i) {
+      x.try_emplace(i, "a");
+      m[i] = "a";
+    }
+    x.insert_or_assign(7, "b");
+    m[7] = "b";
+    x[2000] = "c";
+    m[2000] = "c";
+    BOOST_TEST(x.insert(std::make_pair(3000, std::string("d"))).second);
+    m[3000] = "d";
+    BOOST_TEST_EQ(x.erase(5), 1u);
+    m.erase(5);
+
+    BOOST_TEST_EQ(x.size(), m.size());
+    for (std::map<int, std::string>::const_iterator it = m.begin();
+         it != m.end(); ++it) {
+      BOOST_TEST_EQ(x.at(it->first), it->second);
+    }
+    BOOST_TEST(x.find(5) == x.end());
+    BOOST_TEST_THROWS(x.at(5), std::out_of_range);
+    map_type const& cx = x;
+    BOOST_TEST_EQ(cx.count(7), 1u);
+    BOOST_TEST_EQ(cx.find(2000)->second, "c");
+  }
+}
+
+#endif
+
+RUN_TESTS()
@@ -0,0 +1,188 @@
+
+// Copyright 2022 Christian Mazakas.
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// clang-format off
+#include "../helpers/prefix.hpp"
+#include <boost/unordered/hash_join.hpp>
+#include "../helpers/postfix.hpp"
+// clang-format on
+
+#include "../helpers/test.hpp"
+#include <algorithm>
+#include <map>
+#include <vector>
+
+namespace hash_join_tests {
+  // Puts every key in a handful of partitions and buckets.
+  struct collide_hash
+  {
+    std::size_t operator()(int x) const
+    {
+      return static_cast<std::size_t>(x % 5);
+    }
+  };
+
+  struct row
+  {
+    int key;
+    int id;
+  };
+
+  struct key_of_row
+  {
+    int operator()(row const& r) const { return r.key; }
+  };
+
+  // Records each match as a (probe id, build value) pair.
+  struct collect
+  {
+    std::vector<std::pair<int, int> >* matches;
+
+    void operator()(row const& r, std::pair<int const, int> const& x) const
+    {
+      BOOST_TEST_EQ(r.key, x.first);
+      matches->push_back(std::make_pair(r.id, x.second));
+    }
+  };
+
+  // The build side has 'dups' elements for most keys, none for others.
+  inline std::vector<std::pair<int, int> > make_build(int keys, int dups)
+  {
+    std::vector<std::pair<int, int> > build;
+    for (int d = 0; d < dups; ++d) {
+      for (int k = 0; k < keys; ++k) {
+        if (k % 7 != 3) {
+          build.push_back(std::make_pair(k, k * 10 + d));
+        }
+      }
+    }
+    return build;
+  }
+
+  inline std::vector<row> make_probe(int keys)
+  {
+    std::vector<row> probe;
+    for (int i = 0; i < keys * 2; ++i) {
+      row r = {(i * 31) % (keys + keys / 4), i};
+      probe.push_back(r);
+    }
+    return probe;
+  }
+
+  // A nested loop join, through a std::multimap.
+  inline std::vector<std::pair<int, int> > expected_matches(
+    std::vector<std::pair<int, int> > const& build,
+    std::vector<row> const& probe)
+  {
+    std::multimap<int, int> m(build.begin(), build.end());
+    std::vector<std::pair<int, int> > matches;
+    for (std::size_t i = 0; i < probe.size(); ++i) {
+      std::pair<std::multimap<int, int>::iterator,
+        std::multimap<int, int>::iterator>
+        r = m.equal_range(probe[i].key);
+      for (; r.first != r.second; ++r.first) {
+        matches.push_back(std::make_pair(probe[i].id, r.first->second));
+      }
+    }
+    std::sort(matches.begin(), matches.end());
+    return matches;
+  }
+
+  template <class Join>
+  void check_partitions(Join const& join, std::size_t expected_size)
+  {
+    std::size_t size = 0;
+    for (std::size_t p = 0; p < join.partition_count(); ++p) {
+      typename Join::partition_type const& part = join.partition(p);
+      for (typename Join::partition_type::const_iterator it = part.begin();
+           it != part.end(); ++it) {
+        BOOST_TEST_EQ(join.partition_index(it->first), p);
+        BOOST_TEST(part.find(it->first) != part.end());
+      }
+      size += part.size();
+    }
+    BOOST_TEST_EQ(size, expected_size);
+    BOOST_TEST_EQ(join.size(), expected_size);
+  }
+
+  template <class Join>
+  void join_test(Join join, int keys, int dups, bool one_at_a_time)
+  {
+    std::vector<std::pair<int, int> > build = make_build(keys, dups);
+    std::vector<row> probe = make_probe(keys);
+    std::vector<std::pair<int, int> > expected =
+      expected_matches(build, probe);
+
+    if (one_at_a_time) {
+      for (std::size_t i = 0; i < build.size(); ++i) {
+        join.insert(build[i]);
+      }
+    } else {
+      join.insert(build.begin(), build.end());
+    }
+    check_partitions(join, build.size());
+
+    std::vector<std::pair<int, int> > matches;
+    collect f = {&matches};
+    BOOST_TEST_EQ(join.probe(probe.begin(), probe.end(), key_of_row(), f),
+      expected.size());
+    std::sort(matches.begin(), matches.end());
+    BOOST_TEST(matches == expected);
+
+    // an empty probe side, and probing again
+    BOOST_TEST_EQ(join.probe(probe.end(), probe.end(), key_of_row(), f), 0u);
+    matches.clear();
+    BOOST_TEST_EQ(join.probe(probe.begin(), probe.end(), key_of_row(), f),
+      expected.size());
+
+#if BOOST_UNORDERED_PARALLEL
+    Join join2(join);
+    join2.clear();
+    BOOST_TEST(join2.empty());
+    join2.parallel_insert(build.begin(), build.end(), 4);
+    check_partitions(join2, build.size());
+
+    std::vector<std::vector<std::pair<int, int> > > per_thread_matches(
+      join2.partition_count());
+    std::size_t count = join2.parallel_probe(
+      probe.begin(), probe.end(), key_of_row(),
+      [&](row const& r, std::pair<int const, int> const& x) {
+        // each partition is probed by a single thread
+        per_thread_matches[join2.partition_index(x.first)].push_back(
+          std::make_pair(r.id, x.second));
+      },
+      4);
+    BOOST_TEST_EQ(count, expected.size());
+    matches.clear();
+    for (std::size_t p = 0; p < per_thread_matches.size(); ++p) {
+      matches.insert(matches.end(), per_thread_matches[p].begin(),
+        per_thread_matches[p].end());
+    }
+    std::sort(matches.begin(), matches.end());
+    BOOST_TEST(matches == expected);
+#endif
+  }
+
+  typedef boost::unordered::hash_join<int, int> join_type;
+  typedef boost::unordered::hash_join<int, int, collide_hash> collide_join;
+
+  UNORDERED_AUTO_TEST (hash_join_partitions) {
+    BOOST_TEST_EQ(join_type().partition_count(), 1u);
+    BOOST_TEST_EQ(join_type(1000).partition_count(), 1u);
+    BOOST_TEST_EQ(join_type(100000).partition_count(), 8u);
+    BOOST_TEST_EQ(join_type(100000000).partition_count(), 4096u);
+  }
+
+  UNORDERED_AUTO_TEST (hash_join_tests) {
+    join_test(join_type(), 500, 3, true);
+    join_test(join_type(), 500, 3, false);
+    join_test(join_type(100000), 1000, 1, true);
+    join_test(join_type(100000), 1000, 4, false);
+    join_test(join_type(200000), 30000, 2, false);
+    join_test(collide_join(100000), 300, 3, false);
+  }
+}
+
+RUN_TESTS()
@@ -21,6 +21,8 @@
 #include "../helpers/input_iterator.hpp"
 #include "../helpers/helpers.hpp"
 
+#include <vector>
+
 namespace insert_tests {
 
   test::seed_t initialize_seed(243432);
@@ -676,6 +678,77 @@ namespace insert_tests {
       tracker.compare(x);
       test::check_equivalent_keys(x);
     }
+
+    UNORDERED_SUB_TEST("batch_insert_or_assign")
+    {
+      test::check_instances check_;
+
+      X x;
+      test::ordered<X> tracker = test::create_ordered(x);
+
+      for (int i = 0; i < 3; ++i) {
+        test::random_values<X> v(500, generator);
+        for (typename test::random_values<X>::iterator it = v.begin();
+             it != v.end(); ++it) {
+          tracker[it->first] = it->second;
+        }
+
+        typename X::size_type size = x.size();
+        BOOST_TEST_EQ(
+          x.batch_insert_or_assign(v.begin(), v.end()), tracker.size() - size);
+        BOOST_TEST_EQ(x.size(), tracker.size());
+        BOOST_TEST_LE(x.load_factor(), x.max_load_factor());
+      }
+
+      tracker.compare(x);
+      test::check_equivalent_keys(x);
+    }
+  }
+
+  struct add_to_mapped
+  {
+    void operator()(int& x, int y) const { x += y; }
+  };
+
+  UNORDERED_AUTO_TEST (batch_insert_or_update_tests) {
+    typedef boost::unordered_map<int, int> map;
+    typedef std::vector<std::pair<int, int> > values;
+
+    values v;
+    for (int i = 0; i < 1000; ++i) {
+      v.push_back(std::make_pair(i * 7 % 300, i));
+    }
+
+    map expected;
+    for (values::iterator it = v.begin(); it != v.end(); ++it) {
+      expected[it->first] += it->second;
+    }
+
+    map x;
+    BOOST_TEST_EQ(
+      x.batch_insert_or_update(v.begin(), v.begin(), add_to_mapped()), 0u);
+    BOOST_TEST(x.empty());
+    BOOST_TEST_EQ(
+      x.batch_insert_or_update(v.begin(), v.end(), add_to_mapped()), 300u);
+    BOOST_TEST(x == expected);
+
+    // input iterators are applied one at a time
+    map y;
+    values::const_iterator begin = v.begin(), end = v.end();
+    BOOST_TEST_EQ(y.batch_insert_or_update(test::input_iterator(begin),
+                    test::input_iterator(end), add_to_mapped()),
+      300u);
+    BOOST_TEST(y == expected);
+
+    begin = v.begin();
+    BOOST_TEST_EQ(
+      y.batch_insert_or_assign(test::input_iterator(begin),
+        test::input_iterator(end)),
+      0u);
+    BOOST_TEST_EQ(y.size(), 300u);
+    for (values::iterator it = v.end() - 300; it != v.end(); ++it) {
+      BOOST_TEST_EQ(y[it->first], it->second);
+    }
   }
 
   template <class X>
@@ -0,0 +1,232 @@
+
+// Copyright 2022 Christian Mazakas.
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// clang-format off
+#include "../helpers/prefix.hpp"
+#include <boost/unordered/integer_flat_map.hpp>
+#include <boost/unordered/integer_flat_set.hpp>
+#include "../helpers/postfix.hpp"
+// clang-format on
+
+#include "../helpers/test.hpp"
+
+#if !defined(BOOST_NO_CXX11_RVALUE_REFERENCES) &&                              \
+  !defined(BOOST_NO_CXX11_VARIADIC_TEMPLATES)
+
+#include <boost/core/detail/splitmix64.hpp>
+#include <boost/cstdint.hpp>
+#include <map>
+#include <set>
+#include <stdexcept>
+#include <string>
+
+namespace integer_flat_tests {
+  template <class K> void check(boost::integer_flat_set<K> const& x,
+    std::set<K> const& m)
+  {
+    BOOST_TEST_EQ(x.size(), m.size());
+    BOOST_TEST_LE(x.load_factor(), x.max_load_factor());
+    std::size_t n = 0;
+    for (typename boost::integer_flat_set<K>::const_iterator it = x.begin();
+         it != x.end(); ++it) {
+      BOOST_TEST(m.count(*it));
+      ++n;
+    }
+    BOOST_TEST_EQ(n, m.size());
+    for (typename std::set<K>::const_iterator it = m.begin(); it != m.end();
+         ++it) {
+      BOOST_TEST(x.contains(*it));
+      BOOST_TEST(x.find(*it) != x.end());
+    }
+  }
+
+  template <class K, class T>
+  void check(boost::integer_flat_map<K, T> const& x, std::map<K, T> const& m)
+  {
+    BOOST_TEST_EQ(x.size(), m.size());
+    BOOST_TEST_LE(x.load_factor(), x.max_load_factor());
+    std::size_t n = 0;
+    for (typename boost::integer_flat_map<K, T>::const_iterator it =
+           x.begin();
+         it != x.end(); ++it) {
+      typename std::map<K, T>::const_iterator pos = m.find(it->first);
+      BOOST_TEST(pos != m.end());
+      if (pos != m.end()) {
+        BOOST_TEST_EQ(it->second, pos->second);
+      }
+      ++n;
+    }
+    BOOST_TEST_EQ(n, m.size());
+    for (typename std::map<K, T>::const_iterator it = m.begin();
+         it != m.end(); ++it) {
+      BOOST_TEST_EQ(x.at(it->first), it->second);
+    }
+  }
+
+  // Inserts and erases random keys, from a range small enough that many
+  // are repeated, and including the keys used to mark unused slots.
+  template <class K> void random_set_tests(K mask)
+  {
+    boost::detail::splitmix64 rng;
+    boost::integer_flat_set<K> x;
+    std::set<K> m;
+
+    for (int i = 0; i < 20000; ++i) {
+      boost::uint64_t r = rng();
+      K k = static_cast<K>(r >> 8) & mask;
+      if (r % 3 == 0) {
+        BOOST_TEST_EQ(x.erase(k), m.erase(k));
+      } else {
+        BOOST_TEST_EQ(x.insert(k).second, m.insert(k).second);
+        BOOST_TEST_EQ(*x.insert(k).first, k);
+      }
+    }
+    check(x, m);
+
+    for (K k = 0; k < 4; ++k) {
+      BOOST_TEST_EQ(x.insert(k).second, m.insert(k).second);
+    }
+    BOOST_TEST(x.contains(0));
+    BOOST_TEST(x.contains(1));
+    check(x, m);
+
+    boost::integer_flat_set<K> y(x);
+    check(y, m);
+    boost::integer_flat_set<K> z(std::move(y));
+    check(z, m);
+    BOOST_TEST(y.empty());
+    BOOST_TEST(y.begin() == y.end());
+    y = z;
+    check(y, m);
+    y.clear();
+    check(y, std::set<K>());
+    swap(y, z);
+    check(y, m);
+    check(z, std::set<K>());
+
+    // erasing while iterating leaves the other elements in place
+    for (typename boost::integer_flat_set<K>::iterator it = y.begin();
+         it != y.end();) {
+      if (*it & 1) {
+        m.erase(*it);
+        it = y.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    check(y, m);
+
+    y.reserve(10000);
+    BOOST_TEST_GE(y.bucket_count(), 10000u);
+    check(y, m);
+  }
+
+  UNORDERED_AUTO_TEST (integer_flat_set_random) {
+    random_set_tests<boost::uint32_t>(0xfff);
+    random_set_tests<boost::uint64_t>(0xfff);
+    random_set_tests<boost::int32_t>(0xfff);
+    random_set_tests<boost::uint64_t>(~boost::uint64_t(0));
+  }
+
+  UNORDERED_AUTO_TEST (integer_flat_set_negative) {
+    boost::integer_flat_set<boost::int64_t> x = {-1, -2, 0, 1, 2, -1};
+    std::set<boost::int64_t> m = {-1, -2, 0, 1, 2};
+    check(x, m);
+    BOOST_TEST_EQ(x.erase(-1), 1u);
+    BOOST_TEST(!x.contains(-1));
+    BOOST_TEST_EQ(x.erase(0), 1u);
+    BOOST_TEST(!x.contains(0));
+    BOOST_TEST_EQ(x.size(), 3u);
+  }
+
+  // Keeps the size constant while replacing elements, so the deleted slots
+  // are cleared by rehashing at the same size.
+  UNORDERED_AUTO_TEST (integer_flat_set_churn) {
+    boost::integer_flat_set<boost::uint32_t> x;
+    std::set<boost::uint32_t> m;
+    for (boost::uint32_t i = 2; i < 1002; ++i) {
+      x.insert(i);
+      m.insert(i);
+    }
+    std::size_t const buckets = x.bucket_count();
+    for (boost::uint32_t i = 1002; i < 200000; ++i) {
+      BOOST_TEST_EQ(x.erase(i - 1000), 1u);
+      m.erase(i - 1000);
+      x.insert(i);
+      m.insert(i);
+    }
+    BOOST_TEST_EQ(x.bucket_count(), buckets);
+    check(x, m);
+  }
+
+  UNORDERED_AUTO_TEST (integer_flat_map_random) {
+    boost::detail::splitmix64 rng;
+    boost::integer_flat_map<boost::uint64_t, std::string> x;
+    std::map<boost::uint64_t, std::string> m;
+
+    for (int i = 0; i < 20000; ++i) {
+      boost::uint64_t r = rng();
+      boost::uint64_t k = (r >> 8) & 0x7ff;
+      std::string v = std::to_string(i);
+      switch (r % 4) {
+      case 0:
+        BOOST_TEST_EQ(x.erase(k), m.erase(k));
+        break;
+      case 1:
+        BOOST_TEST_EQ(
+          x.try_emplace(k, v).second, m.insert(std::make_pair(k, v)).second);
+        break;
+      case 2:
+        x.insert_or_assign(k, v);
+        m[k] = v;
+        break;
+      default:
+        x[k] += v;
+        m[k] += v;
+      }
+    }
+    check(x, m);
+
+    x[0] = "zero";
+    m[0] = "zero";
+    x.insert(std::make_pair(boost::uint64_t(1), std::string("one")));
+    m.insert(std::make_pair(boost::uint64_t(1), std::string("one")));
+    check(x, m);
+    BOOST_TEST_EQ(x.find(1)->second, "one");
+
+    typedef boost::integer_flat_map<boost::uint64_t, std::string> map_type;
+    map_type y(x);
+    check(y, m);
+    map_type z;
+    z = std::move(y);
+    check(z, m);
+
+    // values can be modified through the iterators
+    for (map_type::iterator it = z.begin(); it != z.end(); ++it) {
+      it->second += "!";
+      m[it->first] += "!";
+    }
+    check(z, m);
+
+    map_type const& cz = z;
+    BOOST_TEST_THROWS(cz.at(5000), std::out_of_range);
+    BOOST_TEST(cz.find(5000) == cz.end());
+    BOOST_TEST_EQ(cz.count(0), 1u);
+
+    for (map_type::iterator it = z.begin(); it != z.end();) {
+      if (it->second.size() & 1) {
+        m.erase(it->first);
+        z.erase(it++);
+      } else {
+        ++it;
+      }
+    }
+    check(z, m);
+  }
+}
+
+#endif
+
+RUN_TESTS()
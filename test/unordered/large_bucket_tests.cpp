@@ -0,0 +1,101 @@
+
+// Copyright 2022 Christian Mazakas.
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// Use a small threshold so that the mapped bucket arrays are exercised
+// without needing huge tables.
+#define BOOST_UNORDERED_LARGE_BUCKET_THRESHOLD 4096
+
+// clang-format off
+#include "../helpers/prefix.hpp"
+#include <boost/unordered_set.hpp>
+#include <boost/unordered_map.hpp>
+#include "../helpers/postfix.hpp"
+// clang-format on
+
+#include "../helpers/test.hpp"
+
+template <class X> void check_contents(X const& x, int n)
+{
+  BOOST_TEST_EQ(x.size(), static_cast<std::size_t>(n));
+  for (int i = 0; i < n; ++i) {
+    BOOST_TEST_EQ(x.count(i), 1u);
+  }
+  BOOST_TEST_EQ(x.count(n), 0u);
+
+  std::size_t total = 0;
+  for (std::size_t b = 0; b < x.bucket_count(); ++b) {
+    total += x.bucket_size(b);
+  }
+  BOOST_TEST_EQ(total, x.size());
+}
+
+inline int make_value(int i, int const*) { return i; }
+
+inline std::pair<int const, int> make_value(
+  int i, std::pair<int const, int> const*)
+{
+  return std::pair<int const, int>(i, i);
+}
+
+template <class X> void fill(X& x, int n)
+{
+  for (int i = 0; i < n; ++i) {
+    x.insert(make_value(i, (typename X::value_type const*)0));
+  }
+}
+
+template <class X> void large_bucket_test()
+{
+  int const n = 20000;
+
+  {
+    X x(10000);
+    BOOST_TEST_GE(x.bucket_count(), 10000u);
+    for (std::size_t b = 0; b < x.bucket_count(); ++b) {
+      BOOST_TEST_EQ(x.bucket_size(b), 0u);
+    }
+    BOOST_TEST(x.begin() == x.end());
+  }
+
+  {
+    X x;
+    fill(x, n);
+    check_contents(x, n);
+
+    x.rehash(x.bucket_count() * 4);
+    check_contents(x, n);
+
+    x.clear();
+    BOOST_TEST(x.empty());
+    fill(x, n);
+    check_contents(x, n);
+
+    X y(x);
+    check_contents(y, n);
+
+    X z(boost::move(y));
+    check_contents(z, n);
+
+    x.swap(z);
+    check_contents(x, n);
+    check_contents(z, n);
+
+    z = x;
+    check_contents(z, n);
+
+    x.max_load_factor(1000);
+    x.rehash(0);
+    check_contents(x, n);
+  }
+}
+
+UNORDERED_AUTO_TEST (large_bucket_arrays) {
+  large_bucket_test<boost::unordered_set<int> >();
+  large_bucket_test<boost::unordered_multiset<int> >();
+  large_bucket_test<boost::unordered_map<int, int> >();
+  large_bucket_test<boost::unordered_multimap<int, int> >();
+}
+
+RUN_TESTS()
@@ -0,0 +1,211 @@
+
+// Copyright 2022 Christian Mazakas.
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// clang-format off
+#include "../helpers/prefix.hpp"
+#include <boost/unordered/linked_unordered_map.hpp>
+#include <boost/unordered/linked_unordered_set.hpp>
+#include "../helpers/postfix.hpp"
+// clang-format on
+
+#include "../helpers/test.hpp"
+
+#if !defined(BOOST_NO_CXX11_RVALUE_REFERENCES) &&                              \
+  !defined(BOOST_NO_CXX11_VARIADIC_TEMPLATES)
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace linked_unordered_tests {
+  typedef boost::linked_unordered_map<int, std::string> map_type;
+  typedef boost::linked_unordered_set<int> set_type;
+
+  int key(int x) { return x; }
+  int key(std::pair<int const, std::string> const& x) { return x.first; }
+
+  template <class X> std::vector<int> keys_in_order(X const& x)
+  {
+    std::vector<int> keys;
+    for (typename X::const_iterator it = x.begin(); it != x.end(); ++it) {
+      keys.push_back(key(*it));
+    }
+    return keys;
+  }
+
+  template <class X> std::vector<int> keys_in_reverse(X const& x)
+  {
+    std::vector<int> keys;
+    for (typename X::const_reverse_iterator it = x.rbegin(); it != x.rend();
+         ++it) {
+      keys.push_back(key(*it));
+    }
+    return keys;
+  }
+
+  template <class X> void check(X const& x, std::vector<int> const& order)
+  {
+    BOOST_TEST_EQ(x.size(), order.size());
+    BOOST_TEST(keys_in_order(x) == order);
+    std::vector<int> reversed(order.rbegin(), order.rend());
+    BOOST_TEST(keys_in_reverse(x) == reversed);
+    for (std::size_t i = 0; i < order.size(); ++i) {
+      BOOST_TEST(x.contains(order[i]));
+      BOOST_TEST(x.find(order[i]) != x.end());
+    }
+    if (!order.empty()) {
+      BOOST_TEST_EQ(key(x.front()), order.front());
+      BOOST_TEST_EQ(key(x.back()), order.back());
+    }
+  }
+
+  void insert_value(map_type& x, int k)
+  {
+    x.insert(std::make_pair(k, std::to_string(k)));
+  }
+
+  void insert_value(set_type& x, int k) { x.insert(k); }
+
+  template <class X> void order_tests()
+  {
+    X x;
+    std::vector<int> order;
+
+    // The keys are inserted in an order unrelated to their hash, and
+    // enough of them to rehash several times.
+    for (int i = 0; i < 2000; ++i) {
+      int k = (i * 7919) % 1000;
+      if (std::find(order.begin(), order.end(), k) == order.end()) {
+        order.push_back(k);
+      }
+      insert_value(x, k);
+    }
+    check(x, order);
+
+    // erase by key and by iterator, which returns the next in the order
+    for (int k = 0; k < 1000; k += 3) {
+      BOOST_TEST_EQ(x.erase(k), 1u);
+      BOOST_TEST_EQ(x.erase(k), 0u);
+      order.erase(std::find(order.begin(), order.end(), k));
+    }
+    check(x, order);
+
+    typename X::iterator it = x.find(order[10]);
+    it = x.erase(it);
+    order.erase(order.begin() + 10);
+    BOOST_TEST_EQ(key(*it), order[10]);
+    check(x, order);
+
+    it = x.erase(x.find(order[20]), x.find(order[30]));
+    order.erase(order.begin() + 20, order.begin() + 30);
+    BOOST_TEST_EQ(key(*it), order[20]);
+    check(x, order);
+
+    // re-inserting an erased key puts it at the end
+    insert_value(x, 0);
+    order.push_back(0);
+    check(x, order);
+
+    // rehashing doesn't change the order
+    x.rehash(5000);
+    check(x, order);
+    x.max_load_factor(8.0f);
+    x.rehash(0);
+    check(x, order);
+
+    // copies, moves and swaps keep the order
+    X y(x);
+    check(y, order);
+    X z;
+    z = y;
+    check(z, order);
+    X w(std::move(z));
+    check(w, order);
+    BOOST_TEST(z.empty());
+    BOOST_TEST(z.begin() == z.end());
+    insert_value(z, 5000);
+    std::vector<int> z_order(1, 5000);
+    check(z, z_order);
+    z.swap(w);
+    check(z, order);
+    check(w, z_order);
+    swap(z, w);
+    check(w, order);
+    check(z, z_order);
+    w.swap(w);
+    check(w, order);
+
+    X empty;
+    empty.swap(w);
+    check(empty, order);
+    BOOST_TEST(w.empty());
+    BOOST_TEST(w.begin() == w.end());
+
+    empty.clear();
+    check(empty, std::vector<int>());
+    insert_value(empty, 1);
+    check(empty, std::vector<int>(1, 1));
+  }
+
+  UNORDERED_AUTO_TEST (linked_unordered_set_order) {
+    order_tests<set_type>();
+
+    set_type x = {3, 1, 2, 1};
+    std::vector<int> order = {3, 1, 2};
+    check(x, order);
+    BOOST_TEST(!x.emplace(1).second);
+    BOOST_TEST(x.emplace(0).second);
+    order.push_back(0);
+    check(x, order);
+    BOOST_TEST(x.equal_range(5).first == x.end());
+    BOOST_TEST_EQ(*x.equal_range(1).first, 1);
+    BOOST_TEST_EQ(*x.equal_range(1).second, 2);
+  }
+
+  UNORDERED_AUTO_TEST (linked_unordered_map_order) {
+    order_tests<map_type>();
+
+    map_type x;
+    x[9] = "nine";
+    x.try_emplace(3, "three");
+    x.emplace(2, "two");
+    std::vector<int> order = {9, 3, 2};
+    check(x, order);
+
+    // existing elements keep their place
+    BOOST_TEST(!x.try_emplace(3, "other").second);
+    BOOST_TEST_EQ(x.at(3), "three");
+    BOOST_TEST(!x.insert_or_assign(3, "new").second);
+    BOOST_TEST_EQ(x.at(3), "new");
+    BOOST_TEST(!x.insert(std::make_pair(2, std::string("x"))).second);
+    check(x, order);
+
+    BOOST_TEST(x.insert_or_assign(4, "four").second);
+    order.push_back(4);
+    check(x, order);
+
+    // the values can be modified through the iterators
+    for (map_type::iterator it = x.begin(); it != x.end(); ++it) {
+      it->second += "!";
+    }
+    BOOST_TEST_EQ(x.at(4), "four!");
+
+    map_type const& cx = x;
+    BOOST_TEST_EQ(cx.at(2), "two!");
+    BOOST_TEST_THROWS(cx.at(5), std::out_of_range);
+    BOOST_TEST(cx.find(5) == cx.end());
+    BOOST_TEST_EQ(cx.count(2), 1u);
+    BOOST_TEST_EQ(cx.count(5), 0u);
+
+    map_type y = {{1, "one"}, {0, "zero"}};
+    order = {1, 0};
+    check(y, order);
+  }
+}
+
+#endif
+
+RUN_TESTS()
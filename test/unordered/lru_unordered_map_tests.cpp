@@ -0,0 +1,313 @@
+
+// Copyright 2022 Christian Mazakas.
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// clang-format off
+#include "../helpers/prefix.hpp"
+#include <boost/unordered/lru_unordered_map.hpp>
+#include "../helpers/postfix.hpp"
+// clang-format on
+
+#include "../helpers/test.hpp"
+
+#if !defined(BOOST_NO_CXX11_RVALUE_REFERENCES) &&                              \
+  !defined(BOOST_NO_CXX11_VARIADIC_TEMPLATES)
+
+#include <list>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace lru_unordered_map_tests {
+  // Counts the allocations made through it, of any type.
+  static int allocations = 0;
+
+  template <class T> struct counting_allocator
+  {
+    typedef T value_type;
+
+    counting_allocator() {}
+    template <class U> counting_allocator(counting_allocator<U> const&) {}
+
+    T* allocate(std::size_t n)
+    {
+      ++allocations;
+      return std::allocator<T>().allocate(n);
+    }
+
+    void deallocate(T* p, std::size_t n)
+    {
+      std::allocator<T>().deallocate(p, n);
+    }
+
+    bool operator==(counting_allocator const&) const { return true; }
+    bool operator!=(counting_allocator const&) const { return false; }
+  };
+
+  struct record_eviction
+  {
+    std::vector<int>* evicted;
+
+    void operator()(std::pair<int const, std::string>& x) const
+    {
+      evicted->push_back(x.first);
+    }
+  };
+
+  typedef boost::lru_unordered_map<int, std::string, boost::hash<int>,
+    std::equal_to<int>,
+    counting_allocator<std::pair<int const, std::string> >, record_eviction>
+    cache;
+
+  // A reference model: the keys from most to least recently used.
+  struct model
+  {
+    std::list<int> order;
+    std::map<int, std::string> values;
+    std::size_t capacity;
+
+    void use(int k)
+    {
+      order.remove(k);
+      order.push_front(k);
+    }
+
+    // Returns the evicted key, or -1.
+    int insert(int k, std::string const& v)
+    {
+      if (values.count(k)) {
+        use(k);
+        return -1;
+      }
+      int evicted = -1;
+      if (values.size() == capacity) {
+        evicted = order.back();
+        order.pop_back();
+        values.erase(evicted);
+      }
+      values[k] = v;
+      order.push_front(k);
+      return evicted;
+    }
+  };
+
+  template <class X> std::vector<int> keys_by_recency(X const& x)
+  {
+    std::vector<int> keys;
+    x.visit_by_recency([&](std::pair<int const, std::string> const& v) {
+      keys.push_back(v.first);
+    });
+    return keys;
+  }
+
+  void check(cache const& x, model const& m)
+  {
+    BOOST_TEST_EQ(x.size(), m.values.size());
+    BOOST_TEST_LE(x.size(), x.capacity());
+    std::vector<int> expected(m.order.begin(), m.order.end());
+    BOOST_TEST(keys_by_recency(x) == expected);
+    for (std::map<int, std::string>::const_iterator it = m.values.begin();
+         it != m.values.end(); ++it) {
+      cache::const_iterator pos = x.peek(it->first);
+      BOOST_TEST(pos != x.end());
+      if (pos != x.end()) {
+        BOOST_TEST_EQ(pos->second, it->second);
+      }
+    }
+    std::size_t n = 0;
+    for (cache::const_iterator it = x.begin(); it != x.end(); ++it) {
+      ++n;
+    }
+    BOOST_TEST_EQ(n, x.size());
+    if (!m.order.empty()) {
+      BOOST_TEST_EQ(x.most_recent()->first, m.order.front());
+      BOOST_TEST_EQ(x.least_recent()->first, m.order.back());
+    } else {
+      BOOST_TEST(x.least_recent() == x.end());
+    }
+  }
+
+  UNORDERED_AUTO_TEST (lru_unordered_map_eviction) {
+    std::vector<int> evicted;
+    record_eviction f = {&evicted};
+    cache x(100, f);
+    model m = {std::list<int>(), std::map<int, std::string>(), 100};
+    std::vector<int> expected_evicted;
+
+    for (int i = 0; i < 3000; ++i) {
+      int k = (i * 37) % 251;
+      std::string v = std::to_string(i);
+      switch (i % 5) {
+      case 0: {
+        // lookups promote
+        cache::iterator it = x.find(k);
+        BOOST_TEST_EQ(it != x.end(), m.values.count(k) != 0);
+        if (m.values.count(k)) {
+          m.use(k);
+        }
+        break;
+      }
+      case 1:
+        if (x.contains(k)) {
+          x.touch(x.peek(k));
+          m.use(k);
+        }
+        break;
+      case 2: {
+        int e = m.insert(k, v);
+        if (e != -1) {
+          expected_evicted.push_back(e);
+        }
+        x.insert(std::make_pair(k, v));
+        break;
+      }
+      default: {
+        bool const is_new = !m.values.count(k);
+        int e = m.insert(k, v);
+        if (e != -1) {
+          expected_evicted.push_back(e);
+        }
+        BOOST_TEST_EQ(x.try_emplace(k, v).second, is_new);
+      }
+      }
+    }
+    check(x, m);
+    BOOST_TEST(evicted == expected_evicted);
+    BOOST_TEST(!evicted.empty());
+
+    // erasing doesn't call the callback
+    std::size_t evictions = evicted.size();
+    int k = m.order.front();
+    BOOST_TEST_EQ(x.erase(k), 1u);
+    BOOST_TEST_EQ(x.erase(k), 0u);
+    m.order.remove(k);
+    m.values.erase(k);
+    x.erase(x.peek(m.order.back()));
+    m.values.erase(m.order.back());
+    m.order.pop_back();
+    check(x, m);
+    BOOST_TEST_EQ(evicted.size(), evictions);
+
+    // copies keep the order
+    cache y(x);
+    check(y, m);
+    cache z(10, f);
+    z = y;
+    check(z, m);
+    cache w(std::move(z));
+    check(w, m);
+    BOOST_TEST(z.empty());
+
+    // shrinking evicts the least recently used
+    w.set_capacity(10);
+    BOOST_TEST_EQ(w.size(), 10u);
+    BOOST_TEST_EQ(w.capacity(), 10u);
+    while (m.order.size() > 10) {
+      m.values.erase(m.order.back());
+      m.order.pop_back();
+    }
+    check(w, m);
+
+    x.clear();
+    BOOST_TEST(x.empty());
+    x[1] = "one";
+    BOOST_TEST_EQ(x.at(1), "one");
+    BOOST_TEST_EQ(x.most_recent()->first, 1);
+  }
+
+  UNORDERED_AUTO_TEST (lru_unordered_map_no_allocation) {
+    std::vector<int> evicted;
+    record_eviction f = {&evicted};
+    cache x(64, f);
+    for (int i = 0; i < 64; ++i) {
+      x.try_emplace(i, "value");
+    }
+    BOOST_TEST_EQ(x.size(), 64u);
+
+    // the new element is constructed before one is evicted, so the first
+    // replacement allocates, and the evicted node is kept for the next
+    x.insert_or_assign(999, "value");
+    evicted.clear();
+
+    // promoting an element, and replacing the least recently used one,
+    // don't allocate
+    int const before = allocations;
+    for (int i = 0; i < 1000; ++i) {
+      x.find(x.least_recent()->first);
+      x.insert_or_assign(1000 + i, "value");
+      x.find(1000 + i);
+    }
+    BOOST_TEST_EQ(allocations, before);
+    BOOST_TEST_EQ(x.size(), 64u);
+    BOOST_TEST_EQ(evicted.size(), 1000u);
+
+    // insert_or_assign replaces the value and promotes
+    x.insert_or_assign(x.least_recent()->first, "new");
+    BOOST_TEST_EQ(x.most_recent()->second, "new");
+  }
+
+  // A value whose constructor throws when asked to.
+  struct throwing_value
+  {
+    static bool fail;
+
+    std::string value;
+
+    explicit throwing_value(std::string const& v) : value(v)
+    {
+      if (fail) {
+        throw std::runtime_error("throwing_value");
+      }
+    }
+  };
+
+  bool throwing_value::fail = false;
+
+  UNORDERED_AUTO_TEST (lru_unordered_map_strong_guarantee) {
+    std::vector<int> evicted;
+    record_eviction f = {&evicted};
+    cache x(8, f);
+    model m = {std::list<int>(), std::map<int, std::string>(), 8};
+    for (int i = 0; i < 8; ++i) {
+      x.try_emplace(i, std::to_string(i));
+      m.insert(i, std::to_string(i));
+    }
+
+    // the arguments can refer to the element that's evicted
+    x.insert_or_assign(100, x.least_recent()->second);
+    BOOST_TEST_EQ(m.insert(100, "0"), 0);
+    x.try_emplace(101, x.least_recent()->second);
+    BOOST_TEST_EQ(m.insert(101, "1"), 1);
+    check(x, m);
+    BOOST_TEST_EQ(evicted.size(), 2u);
+
+    // a constructor that throws at capacity leaves the map unchanged
+    typedef boost::lru_unordered_map<int, throwing_value> throwing_map;
+    throwing_map y(4);
+    for (int i = 0; i < 4; ++i) {
+      y.try_emplace(i, std::to_string(i));
+    }
+    int const least_recent = y.least_recent()->first;
+    throwing_value::fail = true;
+    BOOST_TEST_THROWS(y.try_emplace(10, "ten"), std::runtime_error);
+    throwing_value::fail = false;
+    BOOST_TEST_EQ(y.size(), 4u);
+    BOOST_TEST(!y.contains(10));
+    for (int i = 0; i < 4; ++i) {
+      BOOST_TEST_EQ(y.peek(i)->second.value, std::to_string(i));
+    }
+    BOOST_TEST_EQ(y.least_recent()->first, least_recent);
+
+    y.try_emplace(10, "ten");
+    BOOST_TEST_EQ(y.size(), 4u);
+    BOOST_TEST(!y.contains(least_recent));
+    BOOST_TEST_EQ(y.at(10).value, "ten");
+  }
+}
+
+#endif
+
+RUN_TESTS()
@@ -0,0 +1,391 @@
+
+// Copyright 2022 Christian Mazakas.
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// clang-format off
+#include "../helpers/prefix.hpp"
+#include <boost/unordered_set.hpp>
+#include <boost/unordered_map.hpp>
+#include "../helpers/postfix.hpp"
+// clang-format on
+
+#include "../helpers/test.hpp"
+#include "../helpers/invariants.hpp"
+#include "../helpers/input_iterator.hpp"
+
+#if BOOST_UNORDERED_PARALLEL
+
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+#include <list>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace parallel_tests {
+
+  typedef boost::unordered_map<int, int> int_map;
+  typedef boost::unordered_set<std::string> string_set;
+
+  // Keys in [0, range), with the index as the mapped value, so that it can
+  // be checked which of the equivalent elements was inserted.
+  std::vector<std::pair<int, int> > make_values(std::size_t n, int range)
+  {
+    std::vector<std::pair<int, int> > values;
+    unsigned x = 12345;
+    for (std::size_t i = 0; i < n; ++i) {
+      x = x * 1103515245u + 12345u;
+      values.push_back(std::make_pair(
+        static_cast<int>((x >> 8) % static_cast<unsigned>(range)),
+        static_cast<int>(i)));
+    }
+    return values;
+  }
+
+  template <class X> bool same_contents(X const& x1, X const& x2)
+  {
+    if (x1.size() != x2.size()) {
+      return false;
+    }
+    for (typename X::const_iterator it = x1.begin(); it != x1.end(); ++it) {
+      typename X::const_iterator pos = x2.find(it->first);
+      if (pos == x2.end() || pos->second != it->second) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  UNORDERED_AUTO_TEST (parallel_insert_map) {
+    int const ranges[] = {1000, 50000, 1000000};
+    std::size_t const thread_counts[] = {0, 1, 2, 3, 8};
+
+    for (int r = 0; r < 3; ++r) {
+      std::vector<std::pair<int, int> > values =
+        make_values(100000, ranges[r]);
+
+      for (int t = 0; t < 5; ++t) {
+        // into an empty map
+        {
+          int_map x1, x2;
+          x1.insert(values.begin(), values.end());
+          x2.parallel_insert(values.begin(), values.end(), thread_counts[t]);
+          BOOST_TEST(same_contents(x1, x2));
+          test::check_equivalent_keys(x2);
+        }
+
+        // into a map that already has some of the keys
+        {
+          int_map x1;
+          for (int i = 0; i < ranges[r]; i += 3) {
+            x1.emplace(i, -i);
+          }
+          int_map x2(x1);
+
+          x1.insert(values.begin(), values.end());
+          x2.parallel_insert(values.begin(), values.end(), thread_counts[t]);
+          BOOST_TEST(same_contents(x1, x2));
+          test::check_equivalent_keys(x2);
+
+          // still usable afterwards
+          x2.insert(values.begin(), values.end());
+          BOOST_TEST(same_contents(x1, x2));
+          x2.erase(x2.begin(), x2.end());
+          BOOST_TEST(x2.empty());
+        }
+      }
+    }
+  }
+
+  UNORDERED_AUTO_TEST (parallel_insert_set) {
+    std::vector<std::string> values;
+    for (int i = 0; i < 60000; ++i) {
+      values.push_back(std::to_string(i * 7 % 40000));
+    }
+
+    string_set x1, x2;
+    x1.insert("1");
+    x1.insert("not a number");
+    x2 = x1;
+
+    x1.insert(values.begin(), values.end());
+    x2.parallel_insert(values.begin(), values.end(), 4);
+    BOOST_TEST(x1 == x2);
+    test::check_equivalent_keys(x2);
+
+    // other iterator categories
+    string_set expected(values.begin(), values.end());
+
+    std::list<std::string> list(values.begin(), values.end());
+    string_set x3;
+    x3.parallel_insert(list.begin(), list.end(), 4);
+    BOOST_TEST(x3 == expected);
+    test::check_equivalent_keys(x3);
+
+    string_set x4;
+    std::vector<std::string>::iterator begin = values.begin(),
+                                       end = values.end();
+    x4.parallel_insert(
+      test::input_iterator(begin), test::input_iterator(end), 4);
+    BOOST_TEST(x4 == expected);
+  }
+
+  struct throwing_value
+  {
+    static std::atomic<int> countdown;
+
+    int value;
+
+    explicit throwing_value(int v) : value(v) {}
+
+    throwing_value(throwing_value const& x) : value(x.value)
+    {
+      if (--countdown == 0) {
+        throw std::runtime_error("copy");
+      }
+    }
+
+    throwing_value& operator=(throwing_value const& x)
+    {
+      value = x.value;
+      return *this;
+    }
+  };
+
+  std::atomic<int> throwing_value::countdown(0);
+
+  UNORDERED_AUTO_TEST (parallel_insert_exception) {
+    std::vector<std::pair<int, throwing_value> > values;
+    for (int i = 0; i < 50000; ++i) {
+      values.push_back(std::make_pair(i % 30000, throwing_value(i)));
+    }
+
+    typedef boost::unordered_map<int, throwing_value> map;
+    map x;
+    for (int i = 0; i < 30000; i += 10) {
+      x.emplace(i, throwing_value(-1));
+    }
+
+    throwing_value::countdown = 10000;
+    bool caught = false;
+    try {
+      x.parallel_insert(values.begin(), values.end(), 4);
+    } catch (std::runtime_error&) {
+      caught = true;
+    }
+    throwing_value::countdown = 0;
+
+    BOOST_TEST(caught);
+    BOOST_TEST_GT(x.size(), 3000u);
+    BOOST_TEST_LT(x.size(), 30000u);
+    test::check_equivalent_keys(x);
+
+    // The elements are either the originals, or the first in the range.
+    for (map::const_iterator it = x.begin(); it != x.end(); ++it) {
+      BOOST_TEST(it->second.value == -1 || it->second.value == it->first);
+    }
+  }
+
+  // Parallel algorithms
+
+  template <class X> X make_container(int n, int range);
+
+  template <> int_map make_container<int_map>(int n, int range)
+  {
+    std::vector<std::pair<int, int> > values =
+      make_values(static_cast<std::size_t>(n), range);
+    return int_map(values.begin(), values.end());
+  }
+
+  template <>
+  boost::unordered_multimap<int, int>
+  make_container<boost::unordered_multimap<int, int> >(int n, int range)
+  {
+    std::vector<std::pair<int, int> > values =
+      make_values(static_cast<std::size_t>(n), range);
+    return boost::unordered_multimap<int, int>(values.begin(), values.end());
+  }
+
+  template <>
+  boost::unordered_set<int> make_container<boost::unordered_set<int> >(
+    int n, int range)
+  {
+    boost::unordered_set<int> x;
+    for (int i = 0; i < n; ++i) {
+      x.insert(i * 7 % range);
+    }
+    return x;
+  }
+
+  template <>
+  boost::unordered_multiset<int>
+  make_container<boost::unordered_multiset<int> >(int n, int range)
+  {
+    boost::unordered_multiset<int> x;
+    for (int i = 0; i < n; ++i) {
+      x.insert(i * 7 % range);
+    }
+    return x;
+  }
+
+  int element_value(int x) { return x; }
+  int element_value(std::pair<int const, int> const& x) { return x.second; }
+
+  struct sum_values
+  {
+    std::atomic<long long>* sum;
+
+    explicit sum_values(std::atomic<long long>& s) : sum(&s) {}
+
+    template <class T> void operator()(T const& x) const
+    {
+      *sum += element_value(x);
+    }
+  };
+
+  struct value_is_multiple_of
+  {
+    int divisor;
+
+    explicit value_is_multiple_of(int d) : divisor(d) {}
+
+    template <class T> bool operator()(T const& x) const
+    {
+      return element_value(x) % divisor == 0;
+    }
+  };
+
+  template <class X> void parallel_algorithms_test()
+  {
+    int const sizes[] = {0, 10, 40000};
+    int const ranges[] = {100, 20000, 1000000};
+
+    for (int s = 0; s < 3; ++s) {
+      for (int r = 0; r < 3; ++r) {
+        X const x = make_container<X>(sizes[s], ranges[r]);
+
+        long long expected_sum = 0;
+        for (typename X::const_iterator it = x.begin(); it != x.end(); ++it) {
+          expected_sum += element_value(*it);
+        }
+
+        std::size_t const thread_counts[] = {0, 1, 3};
+        for (int t = 0; t < 3; ++t) {
+          std::size_t const threads = thread_counts[t];
+
+          // for_each and count_if
+
+          std::atomic<long long> sum(0);
+          x.parallel_for_each(sum_values(sum), threads);
+          BOOST_TEST_EQ(sum.load(), expected_sum);
+
+          for (int d = 1; d < 8; d += 3) {
+            value_is_multiple_of pred(d);
+            BOOST_TEST_EQ(x.parallel_count_if(pred, threads),
+              static_cast<typename X::size_type>(
+                std::count_if(x.begin(), x.end(), pred)));
+          }
+
+          // erase_if, including erasing everything and erasing almost
+          // everything
+
+          int const divisors[] = {1, 2, 3, 17, 1000003};
+          for (int d = 0; d < 5; ++d) {
+            X x1(x), x2(x);
+            value_is_multiple_of pred(divisors[d]);
+
+            typename X::size_type count1 = boost::unordered::erase_if(x1, pred);
+            typename X::size_type count2 = x2.parallel_erase_if(pred, threads);
+            BOOST_TEST_EQ(count1, count2);
+            BOOST_TEST(x1 == x2);
+            test::check_equivalent_keys(x2);
+
+            // still usable afterwards
+            x2.insert(x.begin(), x.end());
+            test::check_equivalent_keys(x2);
+          }
+
+          // equality
+
+          {
+            X x1(x);
+            BOOST_TEST(x.parallel_equal(x1, threads));
+            BOOST_TEST(x1.parallel_equal(x, threads));
+
+            if (!x1.empty()) {
+              typename X::iterator it = x1.begin();
+              std::advance(it, static_cast<std::ptrdiff_t>(x1.size() / 2));
+              x1.erase(it);
+              BOOST_TEST(!x.parallel_equal(x1, threads));
+            }
+
+            X x2(x);
+            x2.rehash(x2.bucket_count() * 4);
+            BOOST_TEST(x.parallel_equal(x2, threads));
+          }
+        }
+      }
+    }
+  }
+
+  UNORDERED_AUTO_TEST (parallel_algorithms) {
+    parallel_algorithms_test<int_map>();
+    parallel_algorithms_test<boost::unordered_multimap<int, int> >();
+    parallel_algorithms_test<boost::unordered_set<int> >();
+    parallel_algorithms_test<boost::unordered_multiset<int> >();
+  }
+
+  UNORDERED_AUTO_TEST (parallel_for_each_modify) {
+    int_map x = make_container<int_map>(100000, 1000000);
+    int_map x1(x);
+
+    x.parallel_for_each(
+      [](std::pair<int const, int>& v) { v.second = -v.second; }, 4);
+    BOOST_TEST_EQ(x.size(), x1.size());
+    for (int_map::const_iterator it = x1.begin(); it != x1.end(); ++it) {
+      BOOST_TEST_EQ(x[it->first], -it->second);
+    }
+
+    // the mapped values can differ for the same keys
+    BOOST_TEST(!x.parallel_equal(x1, 4));
+  }
+
+  struct throwing_predicate
+  {
+    std::atomic<int>* countdown;
+
+    bool operator()(std::pair<int const, int> const& x) const
+    {
+      if (--*countdown == 0) {
+        throw std::runtime_error("predicate");
+      }
+      return x.second % 2 == 0;
+    }
+  };
+
+  UNORDERED_AUTO_TEST (parallel_erase_if_exception) {
+    boost::unordered_multimap<int, int> x =
+      make_container<boost::unordered_multimap<int, int> >(100000, 30000);
+    std::size_t const size = x.size();
+
+    std::atomic<int> countdown(30000);
+    throwing_predicate pred = {&countdown};
+    bool caught = false;
+    try {
+      x.parallel_erase_if(pred, 4);
+    } catch (std::runtime_error&) {
+      caught = true;
+    }
+
+    BOOST_TEST(caught);
+    BOOST_TEST_LT(x.size(), size);
+    test::check_equivalent_keys(x);
+  }
+}
+
+#endif
+
+RUN_TESTS()
@@ -0,0 +1,216 @@
+
+// Copyright 2022 Christian Mazakas.
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// clang-format off
+#include "../helpers/prefix.hpp"
+#include <boost/unordered/persistent_unordered_map.hpp>
+#include "../helpers/postfix.hpp"
+// clang-format on
+
+#include "../helpers/test.hpp"
+
+#if !defined(BOOST_NO_CXX11_HDR_ATOMIC) &&                                     \
+  !defined(BOOST_NO_CXX11_RVALUE_REFERENCES) &&                                \
+  !defined(BOOST_NO_CXX11_VARIADIC_TEMPLATES) &&                               \
+  !defined(BOOST_NO_CXX11_HDR_THREAD)
+
+#include <boost/core/detail/splitmix64.hpp>
+#include <boost/cstdint.hpp>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace persistent_unordered_map_tests {
+  typedef boost::persistent_unordered_map<boost::uint64_t, std::string>
+    map_type;
+
+  template <class Map>
+  void check(Map const& x, std::map<typename Map::key_type,
+                             typename Map::mapped_type> const& m)
+  {
+    BOOST_TEST_EQ(x.size(), m.size());
+    BOOST_TEST_EQ(x.empty(), m.empty());
+    std::size_t n = 0;
+    for (typename Map::const_iterator it = x.begin(); it != x.end(); ++it) {
+      typename std::map<typename Map::key_type,
+        typename Map::mapped_type>::const_iterator pos = m.find(it->first);
+      BOOST_TEST(pos != m.end());
+      if (pos != m.end()) {
+        BOOST_TEST(pos->second == it->second);
+      }
+      ++n;
+    }
+    BOOST_TEST_EQ(n, m.size());
+    for (typename std::map<typename Map::key_type,
+           typename Map::mapped_type>::const_iterator it = m.begin();
+         it != m.end(); ++it) {
+      BOOST_TEST(x.at(it->first) == it->second);
+    }
+  }
+
+  // Changes the map at random, keeping a snapshot every so often, and
+  // checks at the end that none of the snapshots have changed.
+  template <class Map>
+  void random_tests(Map& x, boost::uint64_t mask, int count)
+  {
+    typedef std::map<typename Map::key_type, typename Map::mapped_type>
+      reference;
+    boost::detail::splitmix64 rng;
+    reference m;
+    std::vector<std::pair<Map, reference> > snapshots;
+
+    for (int i = 0; i < count; ++i) {
+      boost::uint64_t r = rng();
+      typename Map::key_type k =
+        static_cast<typename Map::key_type>((r >> 8) & mask);
+      std::string v = std::to_string(i);
+      switch (r % 5) {
+      case 0:
+        BOOST_TEST_EQ(x.erase(k), m.erase(k));
+        break;
+      case 1:
+        BOOST_TEST_EQ(
+          x.try_emplace(k, v).second, m.insert(std::make_pair(k, v)).second);
+        break;
+      case 2:
+        BOOST_TEST_EQ(x.insert_or_assign(k, v).second, !m.count(k));
+        m[k] = v;
+        break;
+      case 3:
+        x[k] += v;
+        m[k] += v;
+        break;
+      default:
+        BOOST_TEST_EQ(x.emplace(k, v).second, m.emplace(k, v).second);
+      }
+      BOOST_TEST_EQ(x.size(), m.size());
+      if (i % 500 == 0) {
+        snapshots.push_back(std::make_pair(x, m));
+      }
+    }
+    check(x, m);
+    for (std::size_t i = 0; i < snapshots.size(); ++i) {
+      check(snapshots[i].first, snapshots[i].second);
+    }
+  }
+
+  UNORDERED_AUTO_TEST (persistent_map_random) {
+    map_type x;
+    random_tests(x, 0x3ff, 20000);
+    map_type y;
+    random_tests(y, ~boost::uint64_t(0), 5000);
+  }
+
+  // Every key has the same hash value, so they all end up in one
+  // collision node.
+  struct bad_hash
+  {
+    std::size_t operator()(int) const { return 42; }
+  };
+
+  UNORDERED_AUTO_TEST (persistent_map_collisions) {
+    typedef boost::persistent_unordered_map<int, std::string, bad_hash>
+      collision_map;
+    collision_map x;
+    random_tests(x, 0x3f, 3000);
+
+    collision_map y;
+    std::map<int, std::string> m;
+    for (int i = 0; i < 10; ++i) {
+      y[i] = "a";
+      m[i] = "a";
+    }
+    collision_map z(y);
+    for (collision_map::const_iterator it = y.begin(); it != y.end();) {
+      if (it->first % 3) {
+        m.erase(it->first);
+        it = y.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    check(y, m);
+    BOOST_TEST_EQ(z.size(), 10u);
+    while (!y.empty()) {
+      y.erase(y.begin());
+    }
+    BOOST_TEST(y.begin() == y.end());
+    BOOST_TEST_EQ(z.size(), 10u);
+  }
+
+  UNORDERED_AUTO_TEST (persistent_map_snapshots) {
+    map_type x = {{1, "one"}, {2, "two"}, {3, "three"}};
+    map_type const snapshot(x);
+    BOOST_TEST(snapshot == x);
+
+    x[1] = "uno";
+    x.at(2) = "dos";
+    x.insert_or_assign(3, "tres");
+    x.erase(2);
+    x.try_emplace(4, "cuatro");
+
+    BOOST_TEST(snapshot != x);
+    BOOST_TEST_EQ(snapshot.at(1), "one");
+    BOOST_TEST_EQ(snapshot.at(2), "two");
+    BOOST_TEST_EQ(snapshot.at(3), "three");
+    BOOST_TEST(!snapshot.contains(4));
+    BOOST_TEST_EQ(x.at(1), "uno");
+    BOOST_TEST(!x.contains(2));
+    BOOST_TEST_EQ(x.at(3), "tres");
+    BOOST_TEST_EQ(x.find(4)->second, "cuatro");
+    BOOST_TEST_THROWS(snapshot.at(4), std::out_of_range);
+
+    map_type y(std::move(x));
+    BOOST_TEST(x.empty());
+    BOOST_TEST_EQ(y.size(), 3u);
+    x = snapshot;
+    BOOST_TEST(x == snapshot);
+    x.clear();
+    BOOST_TEST(x.empty());
+    BOOST_TEST_EQ(snapshot.size(), 3u);
+    swap(x, y);
+    BOOST_TEST_EQ(x.size(), 3u);
+    BOOST_TEST(y.empty());
+  }
+
+  // Readers check their snapshots on other threads while the writer keeps
+  // changing the map.
+  UNORDERED_AUTO_TEST (persistent_map_threads) {
+    map_type x;
+    for (boost::uint64_t i = 0; i < 1000; ++i) {
+      x[i] = std::to_string(i);
+    }
+
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; ++t) {
+      map_type snapshot(x);
+      readers.push_back(std::thread([snapshot]() {
+        for (int j = 0; j < 20; ++j) {
+          std::size_t n = 0;
+          for (map_type::const_iterator it = snapshot.begin();
+               it != snapshot.end(); ++it) {
+            BOOST_TEST_EQ(it->second, std::to_string(it->first));
+            ++n;
+          }
+          BOOST_TEST_EQ(n, snapshot.size());
+        }
+      }));
+      for (boost::uint64_t i = 0; i < 1000; ++i) {
+        x.erase(i * 7 % 1000);
+        x[i * 7 % 1000] = std::to_string(i * 7 % 1000);
+      }
+    }
+    for (std::size_t t = 0; t < readers.size(); ++t) {
+      readers[t].join();
+    }
+    BOOST_TEST_EQ(x.size(), 1000u);
+  }
+}
+
+#endif
+
+RUN_TESTS()
@@ -14,8 +14,12 @@
 #include "../helpers/random_values.hpp"
 #include "../helpers/tracker.hpp"
 #include "../helpers/metafunctions.hpp"
+#include "../helpers/invariants.hpp"
 #include "../objects/test.hpp"
 
+#include <algorithm>
+#include <vector>
+
 namespace rehash_tests {
 
   test::seed_t initialize_seed(2974);
@@ -192,6 +196,45 @@ namespace rehash_tests {
     }
   }
 
+  template <class X> void compact_test1(X*, test::random_generator generator)
+  {
+    test::random_values<X> v(1000, generator);
+    X x(v.begin(), v.end());
+
+    // Erase every other element, so that there are holes between the
+    // remaining nodes.
+    for (typename X::iterator it = x.begin(); it != x.end();) {
+      it = x.erase(it);
+      if (it != x.end()) {
+        ++it;
+      }
+    }
+
+    test::ordered<X> tracker;
+    tracker.insert_range(x.begin(), x.end());
+
+    std::vector<typename X::value_type> before(x.begin(), x.end());
+    std::size_t bucket_count = x.bucket_count();
+
+    x.compact();
+    BOOST_TEST_EQ(x.bucket_count(), bucket_count);
+    tracker.compare(x);
+    test::check_equivalent_keys(x);
+
+    // Iteration order is unchanged.
+    BOOST_TEST(std::equal(before.begin(), before.end(), x.begin()));
+    BOOST_TEST_EQ(x.size(), before.size());
+
+    // Still usable afterwards.
+    x.insert(v.begin(), v.end());
+    test::check_equivalent_keys(x);
+    x.erase(x.begin(), x.end());
+    BOOST_TEST(x.empty());
+
+    x.compact();
+    BOOST_TEST(x.empty());
+  }
+
   boost::unordered_set<int>* int_set_ptr;
   boost::unordered_multiset<test::object, test::hash, test::equal_to,
     test::allocator2<test::object> >* test_multiset_ptr;
@@ -224,6 +267,9 @@ namespace rehash_tests {
   UNORDERED_TEST(reserve_test2,
     ((int_set_ptr)(test_multiset_ptr)(test_map_ptr)(int_multimap_ptr))(
       (default_generator)(generate_collisions)(limited_range)))
+  UNORDERED_TEST(compact_test1,
+    ((int_set_ptr)(test_multiset_ptr)(test_map_ptr)(int_multimap_ptr))(
+      (default_generator)(generate_collisions)(limited_range)))
 }
 
 RUN_TESTS()
@@ -183,6 +183,63 @@ template <class UnorderedContainer> void rehash_tests()
   num_allocations = 0;
 }
 
+inline int make_value(int i, int const*) { return i; }
+
+inline std::pair<int const, int> make_value(
+  int i, std::pair<int const, int> const*)
+{
+  return std::pair<int const, int>(i, i);
+}
+
+template <class UnorderedContainer> void reserve_nodes_tests()
+{
+  typedef typename UnorderedContainer::value_type value_type;
+
+  BOOST_TEST_EQ(num_allocations, 0u);
+  BOOST_TEST_EQ(total_allocation, 0u);
+
+  {
+    UnorderedContainer s;
+
+    int count = 1000;
+    s.reserve_nodes(static_cast<std::size_t>(count));
+    BOOST_TEST(s.empty());
+    BOOST_TEST_GE(s.bucket_count(), static_cast<std::size_t>(count));
+
+    // inserting up to the reserved size should be served entirely from the
+    // preallocated nodes
+    //
+    std::size_t prev_allocations = num_allocations;
+    for (int i = 0; i < count; ++i) {
+      s.insert(make_value(i, (value_type const*)0));
+    }
+    BOOST_TEST_EQ(s.size(), static_cast<std::size_t>(count));
+    BOOST_TEST_EQ(num_allocations, prev_allocations);
+
+    // the container already holds enough elements, so there's nothing to do
+    //
+    s.reserve_nodes(static_cast<std::size_t>(count));
+    BOOST_TEST_EQ(num_allocations, prev_allocations);
+
+    s.insert(make_value(count, (value_type const*)0));
+    BOOST_TEST_EQ(num_allocations, prev_allocations + 1);
+
+    // nodes of erased elements aren't kept, so after clearing the container
+    // a full set of nodes has to be allocated again; any unused ones are
+    // released on destruction
+    //
+    s.clear();
+    prev_allocations = num_allocations;
+    s.reserve_nodes(static_cast<std::size_t>(count));
+    BOOST_TEST_EQ(num_allocations,
+      prev_allocations + static_cast<std::size_t>(count));
+  }
+
+  BOOST_TEST_GT(num_allocations, 0u);
+  BOOST_TEST_EQ(total_allocation, 0u);
+  num_allocations = 0;
+}
+
 UNORDERED_AUTO_TEST (unordered_set_reserve) {
   typedef boost::unordered_set<int, boost::hash<int>, std::equal_to<int>,
     A<int> >
@@ -219,6 +276,11 @@ UNORDERED_AUTO_TEST (unordered_set_reserve) {
   rehash_tests<unordered_map>();
   rehash_tests<unordered_multiset>();
   rehash_tests<unordered_multimap>();
+
+  reserve_nodes_tests<unordered_set>();
+  reserve_nodes_tests<unordered_map>();
+  reserve_nodes_tests<unordered_multiset>();
+  reserve_nodes_tests<unordered_multimap>();
 }
 
 RUN_TESTS()
@@ -0,0 +1,206 @@
+
+// Copyright 2022 Christian Mazakas.
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// clang-format off
+#include "../helpers/prefix.hpp"
+#include <boost/unordered_set.hpp>
+#include <boost/unordered_map.hpp>
+#include "../helpers/postfix.hpp"
+// clang-format on
+
+#include "../helpers/test.hpp"
+#include "../helpers/invariants.hpp"
+#include <set>
+
+namespace set_operations_tests {
+  // A hash function with state, so that keys are always hashed again when
+  // they're looked up in another container.
+  struct seeded_hash
+  {
+    std::size_t seed;
+
+    seeded_hash() : seed(0) {}
+    explicit seeded_hash(std::size_t s) : seed(s) {}
+
+    std::size_t operator()(int x) const
+    {
+      return boost::hash<int>()(x) ^ seed;
+    }
+  };
+
+  inline int get_key(int x) { return x; }
+  inline int get_key(std::pair<int const, int> const& x) { return x.first; }
+
+  inline void insert_key(boost::unordered_set<int>& x, int k) { x.insert(k); }
+
+  template <class H>
+  void insert_key(boost::unordered_set<int, H>& x, int k)
+  {
+    x.insert(k);
+  }
+
+  template <class H>
+  void insert_key(boost::unordered_map<int, int, H>& x, int k)
+  {
+    x.insert(std::make_pair(k, -k));
+  }
+
+  template <class X> std::set<int> keys(X const& x)
+  {
+    std::set<int> r;
+    for (typename X::const_iterator it = x.begin(); it != x.end(); ++it) {
+      r.insert(get_key(*it));
+    }
+    return r;
+  }
+
+  template <class X> void check(X const& x, std::set<int> const& expected)
+  {
+    test::check_equivalent_keys(x);
+    BOOST_TEST_EQ(x.size(), expected.size());
+    BOOST_TEST(keys(x) == expected);
+  }
+
+  // The keys in [first, last) with the given step.
+  template <class X> X make(X const& proto, int first, int last, int step)
+  {
+    X x(proto);
+    for (int i = first; i < last; i += step) {
+      insert_key(x, i);
+    }
+    return x;
+  }
+
+  inline std::set<int> make_keys(int first, int last, int step)
+  {
+    std::set<int> r;
+    for (int i = first; i < last; i += step) {
+      r.insert(i);
+    }
+    return r;
+  }
+
+  template <class X> void set_operations(X const& proto)
+  {
+    std::set<int> const a = make_keys(0, 600, 2);
+    std::set<int> const b = make_keys(0, 600, 3);
+    std::set<int> u, i, d;
+    for (int k = 0; k < 600; ++k) {
+      bool in_a = a.count(k) != 0, in_b = b.count(k) != 0;
+      if (in_a || in_b) {
+        u.insert(k);
+      }
+      if (in_a && in_b) {
+        i.insert(k);
+      }
+      if (in_a && !in_b) {
+        d.insert(k);
+      }
+    }
+
+    X x = make(proto, 0, 600, 2);
+    X y = make(proto, 0, 600, 3);
+
+    // the same and a different number of buckets
+    X z(y);
+    z.rehash(x.bucket_count() * 3);
+    X const* others[] = {&y, &z};
+
+    for (int n = 0; n < 2; ++n) {
+      X const& other = *others[n];
+
+      check(set_union(x, other), u);
+      check(set_union(other, x), u);
+      check(set_intersection(x, other), i);
+      check(set_intersection(other, x), i);
+      check(set_difference(x, other), d);
+      BOOST_TEST(set_difference(other, other).empty());
+
+      BOOST_TEST(!x.is_subset_of(other));
+      BOOST_TEST(set_intersection(x, other).is_subset_of(other));
+      BOOST_TEST(set_intersection(other, x).is_subset_of(x));
+      BOOST_TEST(x.is_subset_of(set_union(other, x)));
+      BOOST_TEST(X(proto).is_subset_of(other));
+      BOOST_TEST(other.is_subset_of(other));
+
+      X r(x);
+      BOOST_TEST_EQ(r.intersect(other), a.size() - i.size());
+      check(r, i);
+
+      r = x;
+      BOOST_TEST_EQ(r.subtract(other), i.size());
+      check(r, d);
+
+      // subtracting a smaller container looks its keys up instead
+      r = make(proto, 0, 1200, 1);
+      BOOST_TEST_EQ(r.subtract(other), b.size());
+      BOOST_TEST_EQ(r.size(), 1200 - b.size());
+      BOOST_TEST(r.is_subset_of(set_difference(r, other)));
+      BOOST_TEST(set_intersection(r, other).empty());
+    }
+
+    // aliasing
+    X r(x);
+    BOOST_TEST_EQ(r.intersect(r), 0u);
+    check(r, a);
+    BOOST_TEST_EQ(r.subtract(r), a.size());
+    BOOST_TEST(r.empty());
+    BOOST_TEST_EQ(r.intersect(x), 0u);
+    BOOST_TEST_EQ(r.subtract(x), 0u);
+    check(set_union(r, x), a);
+  }
+
+#if BOOST_UNORDERED_PARALLEL
+  // There need to be enough elements for the threads to share the work.
+  template <class X> void parallel_set_operations(X const& proto)
+  {
+    X x = make(proto, 0, 40000, 2);
+    X y = make(proto, 0, 40000, 3);
+    X z(y);
+    z.rehash(x.bucket_count() * 3);
+    X const* others[] = {&y, &z};
+
+    for (int n = 0; n < 2; ++n) {
+      X const& other = *others[n];
+
+      X r(x);
+      X expected(x);
+      BOOST_TEST_EQ(
+        r.parallel_intersect(other, 4), expected.intersect(other));
+      check(r, keys(expected));
+
+      r = x;
+      expected = x;
+      BOOST_TEST_EQ(r.parallel_subtract(other, 4), expected.subtract(other));
+      check(r, keys(expected));
+
+      BOOST_TEST(!x.parallel_is_subset_of(other, 4));
+      BOOST_TEST(set_intersection(x, other).parallel_is_subset_of(x, 4));
+      BOOST_TEST(other.parallel_is_subset_of(other, 4));
+    }
+
+    X r(x);
+    BOOST_TEST_EQ(r.parallel_intersect(r, 4), 0u);
+    BOOST_TEST_EQ(r.size(), x.size());
+    BOOST_TEST_EQ(r.parallel_subtract(r, 4), x.size());
+    BOOST_TEST(r.empty());
+  }
+#endif
+
+  UNORDERED_AUTO_TEST (set_operations_tests) {
+    set_operations(boost::unordered_set<int>());
+    set_operations(boost::unordered_set<int, seeded_hash>(0, seeded_hash(7)));
+    set_operations(boost::unordered_map<int, int>());
+    set_operations(
+      boost::unordered_map<int, int, seeded_hash>(0, seeded_hash(7)));
+#if BOOST_UNORDERED_PARALLEL
+    parallel_set_operations(boost::unordered_set<int>());
+    parallel_set_operations(
+      boost::unordered_map<int, int, seeded_hash>(0, seeded_hash(7)));
+#endif
+  }
+}
+
+RUN_TESTS()
@@ -0,0 +1,130 @@
+
+// Copyright 2022 Christian Mazakas.
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// clang-format off
+#include "../helpers/prefix.hpp"
+#include <boost/unordered_set.hpp>
+#include <boost/unordered_map.hpp>
+#include <boost/unordered/string_hash.hpp>
+#include "../helpers/postfix.hpp"
+// clang-format on
+
+#include "../helpers/test.hpp"
+
+#include <boost/container_hash/hash.hpp>
+#include <boost/static_assert.hpp>
+
+#include <cstdio>
+#include <string>
+
+BOOST_STATIC_ASSERT(
+  boost::unordered::hash_is_avalanching<boost::unordered::string_hash>::value);
+BOOST_STATIC_ASSERT(
+  !boost::unordered::hash_is_avalanching<boost::hash<std::string> >::value);
+
+static std::string make_key(unsigned x)
+{
+  char buffer[64];
+  std::sprintf(buffer, "pfx_%u_sfx", x);
+  return buffer;
+}
+
+static unsigned popcount(boost::uint64_t x)
+{
+  unsigned n = 0;
+  for (; x; x &= x - 1) {
+    ++n;
+  }
+  return n;
+}
+
+UNORDERED_AUTO_TEST (string_hash_overloads) {
+  boost::unordered::string_hash hf;
+
+  std::string s;
+  for (int i = 0; i < 200; ++i) {
+    BOOST_TEST_EQ(hf(s), hf(s.c_str()));
+    BOOST_TEST_EQ(hf(s), hf.hash(s.data(), s.size()));
+#if !defined(BOOST_NO_CXX17_HDR_STRING_VIEW)
+    BOOST_TEST_EQ(hf(s), hf(std::string_view(s)));
+#endif
+    s += static_cast<char>('a' + i % 26);
+  }
+
+  boost::unordered::string_hash hf2(1337);
+  BOOST_TEST_NE(hf(std::string("abc")), hf2(std::string("abc")));
+  BOOST_TEST_EQ(hf2(std::string("abc")), hf2("abc"));
+}
+
+UNORDERED_AUTO_TEST (string_hash_distribution) {
+  boost::unordered::string_hash hf;
+
+  // every length goes through a different path for reading the tail
+  //
+  boost::unordered_set<std::size_t> hashes;
+  std::string s;
+  for (int i = 0; i < 200; ++i) {
+    BOOST_TEST(hashes.insert(hf(s)).second);
+    s += 'x';
+  }
+
+  // flipping a single input bit should change about half the output bits
+  //
+  if (sizeof(std::size_t) == 8) {
+    unsigned total = 0, samples = 0;
+    for (int len = 1; len < 100; len += 7) {
+      std::string key(static_cast<std::size_t>(len), 'k');
+      boost::uint64_t h = hf(key);
+      for (std::size_t pos = 0; pos < key.size(); ++pos) {
+        for (int bit = 0; bit < 8; ++bit) {
+          std::string key2 = key;
+          key2[pos] = static_cast<char>(key2[pos] ^ (1 << bit));
+          total += popcount(h ^ hf(key2));
+          ++samples;
+        }
+      }
+    }
+    BOOST_TEST_GT(total, samples * 28);
+    BOOST_TEST_LT(total, samples * 36);
+  }
+}
+
+template <class X> void string_hash_container_test()
+{
+  X x;
+  for (unsigned i = 0; i < 10000; ++i) {
+    x.insert(typename X::value_type(make_key(i), i));
+  }
+  BOOST_TEST_EQ(x.size(), 10000u);
+
+  for (unsigned i = 0; i < 10000; ++i) {
+    typename X::const_iterator pos = x.find(make_key(i));
+    BOOST_TEST(pos != x.end());
+    if (pos != x.end()) {
+      BOOST_TEST_EQ(pos->second, i);
+    }
+  }
+  BOOST_TEST(x.find(make_key(10000)) == x.end());
+
+  // the hash values are used directly to pick the bucket, so check that
+  // the similar keys are still spread out
+  //
+  std::size_t max_bucket_size = 0;
+  for (std::size_t b = 0; b < x.bucket_count(); ++b) {
+    if (x.bucket_size(b) > max_bucket_size) {
+      max_bucket_size = x.bucket_size(b);
+    }
+  }
+  BOOST_TEST_LT(max_bucket_size, 12u);
+}
+
+UNORDERED_AUTO_TEST (string_hash_containers) {
+  string_hash_container_test<boost::unordered_map<std::string, unsigned,
+    boost::unordered::string_hash> >();
+  string_hash_container_test<boost::unordered_multimap<std::string,
+    unsigned, boost::unordered::string_hash> >();
+}
+
+RUN_TESTS()
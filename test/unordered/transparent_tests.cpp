@@ -1585,6 +1585,87 @@ template <class UnorderedSet> void test_set_non_transparent_extract()
   BOOST_TEST_EQ(key::count_, key_count);
 }
 
+#if !defined(BOOST_NO_CXX11_VARIADIC_TEMPLATES)
+template <class UnorderedMap> void test_map_transparent_try_emplace()
+{
+  typedef typename UnorderedMap::iterator iterator;
+
+  count_reset();
+
+  UnorderedMap map;
+
+  std::pair<iterator, bool> r = map.try_emplace(0, 1337);
+  BOOST_TEST(r.second);
+  BOOST_TEST_EQ(r.first->second, 1337);
+  BOOST_TEST_EQ(key::count_, 1);
+
+  // a key is only constructed when a new element is inserted
+  //
+  r = map.try_emplace(0, 1338);
+  BOOST_TEST_NOT(r.second);
+  BOOST_TEST_EQ(r.first->second, 1337);
+  BOOST_TEST_EQ(key::count_, 1);
+
+  iterator pos = map.try_emplace(map.cbegin(), 0, 1339);
+  BOOST_TEST(pos == r.first);
+  BOOST_TEST_EQ(key::count_, 1);
+
+  pos = map.try_emplace(map.cend(), 1);
+  BOOST_TEST_EQ(pos->first.x_, 1);
+  BOOST_TEST_EQ(pos->second, 0);
+  BOOST_TEST_EQ(key::count_, 2);
+
+  r = map.insert_or_assign(1, 1340);
+  BOOST_TEST_NOT(r.second);
+  BOOST_TEST_EQ(r.first->second, 1340);
+  BOOST_TEST_EQ(key::count_, 2);
+
+  r = map.insert_or_assign(2, 1341);
+  BOOST_TEST(r.second);
+  BOOST_TEST_EQ(r.first->second, 1341);
+  BOOST_TEST_EQ(key::count_, 3);
+
+  pos = map.insert_or_assign(map.cend(), 2, 1342);
+  BOOST_TEST_EQ(pos->second, 1342);
+  BOOST_TEST_EQ(key::count_, 3);
+
+  map[3] = 1343;
+  BOOST_TEST_EQ(key::count_, 4);
+
+  BOOST_TEST_EQ(map[3], 1343);
+  BOOST_TEST_EQ(map[0], 1337);
+  BOOST_TEST_EQ(map.size(), 4u);
+  BOOST_TEST_EQ(key::count_, 4);
+}
+
+template <class UnorderedSet> void test_set_transparent_insert()
+{
+  typedef typename UnorderedSet::iterator iterator;
+
+  count_reset();
+
+  UnorderedSet set;
+
+  std::pair<iterator, bool> r = set.insert(0);
+  BOOST_TEST(r.second);
+  BOOST_TEST_EQ(r.first->x_, 0);
+  BOOST_TEST_EQ(key::count_, 1);
+
+  r = set.insert(0);
+  BOOST_TEST_NOT(r.second);
+  BOOST_TEST_EQ(key::count_, 1);
+
+  iterator pos = set.insert(set.cbegin(), 0);
+  BOOST_TEST(pos == r.first);
+  BOOST_TEST_EQ(key::count_, 1);
+
+  pos = set.insert(set.cend(), 1);
+  BOOST_TEST_EQ(pos->x_, 1);
+  BOOST_TEST_EQ(set.size(), 2u);
+  BOOST_TEST_EQ(key::count_, 2);
+}
+#endif
+
 void test_unordered_map()
 {
   {
@@ -1597,6 +1678,9 @@ void test_unordered_map()
     test_map_transparent_equal_range<unordered_map>();
     test_map_transparent_erase<unordered_map>();
     test_map_transparent_extract<unordered_map>();
+#if !defined(BOOST_NO_CXX11_VARIADIC_TEMPLATES)
+    test_map_transparent_try_emplace<unordered_map>();
+#endif
   }
 
   {
@@ -1703,6 +1787,9 @@ void test_unordered_set()
     test_set_transparent_erase<unordered_set>();
     test_set_transparent_equal_range<unordered_set>();
     test_set_transparent_extract<unordered_set>();
+#if !defined(BOOST_NO_CXX11_VARIADIC_TEMPLATES)
+    test_set_transparent_insert<unordered_set>();
+#endif
   }
 
   {
@@ -496,7 +496,7 @@ namespace unnecessary_copy_tests {
     reset();
     std::pair<count_copies const&, count_copies const&> a_ref(part, part);
     x.emplace(a_ref);
-    COPY_COUNT(2);
+    COPY_COUNT(0);
     MOVE_COUNT(0);
 
 #endif
@@ -577,6 +577,46 @@ namespace unnecessary_copy_tests {
 
 #endif
   }
+
+  // Arguments that aren't the key type, but that the key can be found
+  // from without constructing the element.
+  UNORDERED_AUTO_TEST (unnecessary_copy_emplace_key_extraction_test) {
+    boost::unordered_map<long, count_copies> x;
+    count_copies v(2);
+    x.emplace(1L, count_copies(1));
+    reset();
+
+    // a pair with a different mapped type
+    BOOST_TEST(!x.emplace(std::pair<long, int>(1L, 2)).second);
+    COPY_COUNT(0);
+
+    // an arithmetic key of a different type
+    BOOST_TEST(!x.emplace(1, v).second);
+    BOOST_TEST(!x.emplace(std::pair<int, int>(1, 2)).second);
+    BOOST_TEST(!x.try_emplace(1, 2).second);
+    BOOST_TEST(x.emplace_hint(x.end(), 1, v) == x.find(1));
+    COPY_COUNT(0);
+
+    reset();
+    x.emplace(boost::unordered::piecewise_construct, boost::make_tuple(1),
+      boost::make_tuple(2));
+    COPY_COUNT(0);
+
+    std::pair<int, count_copies> range[] = {
+      std::pair<int, count_copies>(1, v), std::pair<int, count_copies>(2, v)};
+    reset();
+    x.insert(range, range + 2);
+    COPY_COUNT(1);
+    BOOST_TEST_EQ(x.size(), 2u);
+    BOOST_TEST_EQ(x.find(1)->second.tag_, 1);
+    BOOST_TEST_EQ(x.find(2)->second.tag_, 2);
+
+    // still inserted when missing
+    reset();
+    BOOST_TEST(x.emplace(3, v).second);
+    COPY_COUNT(1);
+    BOOST_TEST_EQ(x.find(3)->second.tag_, 2);
+  }
 }
 
 RUN_TESTS()